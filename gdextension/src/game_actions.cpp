@@ -44,6 +44,7 @@
 #include "game/logic/upgradecalculator.h"
 #include "game/logic/endmoveaction.h"
 #include "game/logic/movejob.h"
+#include "utility/path.h"
 #include "utility/position.h"
 
 using namespace godot;
@@ -166,11 +167,12 @@ bool GameActions::move_unit(int unit_id, PackedVector2Array path) {
         return false;
     }
 
-    // Convert PackedVector2Array to forward_list<cPosition> (reverse order for forward_list)
-    std::forward_list<cPosition> cpath;
-    for (int i = path.size() - 1; i >= 0; i--) {
+    // Convert PackedVector2Array to cPath
+    cPath cpath;
+    cpath.reserve(path.size());
+    for (int i = 0; i < path.size(); i++) {
         Vector2 p = path[i];
-        cpath.push_front(cPosition(static_cast<int>(p.x), static_cast<int>(p.y)));
+        cpath.push_back(cPosition(static_cast<int>(p.x), static_cast<int>(p.y)));
     }
 
     try {
@@ -754,7 +756,7 @@ Array GameActions::get_upgradeable_units(int player_id) {
         if (!unitsData.isValidId(unitId)) continue;
 
         const auto& staticData = unitsData.getStaticUnitData(unitId);
-        auto* curData = player->getLastUnitData(unitId);
+        const auto* curData = std::as_const(*player).getLastUnitData(unitId);
         if (!curData) continue;
 
         // Create upgrade object to get prices / state
@@ -824,7 +826,7 @@ int GameActions::buy_unit_upgrade(int player_id, int id_first, int id_second, in
     const auto& research = player->getResearchState();
     int clan = player->getClan();
     const auto& origData = unitsData.getDynamicUnitData(unitId, clan);
-    auto* curData = player->getLastUnitData(unitId);
+    const auto* curData = std::as_const(*player).getLastUnitData(unitId);
     if (!curData) return -1;
 
     const auto& staticData = unitsData.getStaticUnitData(unitId);
@@ -866,7 +868,7 @@ int GameActions::get_vehicle_upgrade_cost(int vehicle_id) {
     auto* owner = find_unit_owner(vehicle_id);
     if (!owner) return -1;
 
-    const auto* latestVersion = owner->getLastUnitData(vehicle->data.getId());
+    const auto* latestVersion = std::as_const(*owner).getLastUnitData(vehicle->data.getId());
     if (!latestVersion) return -1;
     if (!vehicle->data.canBeUpgradedTo(*latestVersion)) return -1;
 
@@ -882,7 +884,7 @@ int GameActions::get_building_upgrade_cost(int building_id) {
     auto* owner = find_unit_owner(building_id);
     if (!owner) return -1;
 
-    const auto* latestVersion = owner->getLastUnitData(building->data.getId());
+    const auto* latestVersion = std::as_const(*owner).getLastUnitData(building->data.getId());
     if (!latestVersion) return -1;
     if (!building->data.canBeUpgradedTo(*latestVersion)) return -1;
 
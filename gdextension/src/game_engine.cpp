@@ -1,4 +1,5 @@
 #include "game_engine.h"
+#include "game_model_lock.h"
 #include "game_map.h"
 #include "game_player.h"
 #include "game_unit.h"
@@ -6,19 +7,32 @@
 #include "game_setup.h"
 #include "game_pathfinder.h"
 
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <unordered_map>
+
 // M.A.X.R. core engine includes
 #include "game/data/model.h"
 #include "game/data/map/map.h"
+#include "game/data/map/mapview.h"
 #include "game/data/player/player.h"
 #include "game/data/units/unitdata.h"
 #include "game/data/units/vehicle.h"
 #include "game/data/units/building.h"
+#include "game/data/units/unitstore.h"
 #include "game/logic/turncounter.h"
 #include "game/logic/turntimeclock.h"
 #include "game/logic/casualtiestracker.h"
+#include "game/logic/unitchangejournal.h"
+#include "game/logic/effectchannel.h"
+#include "game/logic/replay.h"
+#include "game/logic/modelsnapshot.h"
 #include "game/data/freezemode.h"
 #include "game/protocol/netmessage.h"
 #include "game/logic/action/actionendturn.h"
@@ -29,7 +43,9 @@
 #include "game/data/savegame.h"
 #include "game/data/savegameinfo.h"
 #include "game/data/gamesettings.h"
+#include "utility/crc.h"
 #include "utility/log.h"
+#include "settings.h"
 
 using namespace godot;
 
@@ -51,11 +67,18 @@ void GameEngine::_bind_methods() {
     // Player access
     ClassDB::bind_method(D_METHOD("get_player", "index"), &GameEngine::get_player);
     ClassDB::bind_method(D_METHOD("get_all_players"), &GameEngine::get_all_players);
+    ClassDB::bind_method(D_METHOD("take_fog_dirty_rect", "player_index"), &GameEngine::take_fog_dirty_rect);
+    ClassDB::bind_method(D_METHOD("get_visibility_bitmask", "player_index"), &GameEngine::get_visibility_bitmask);
+    ClassDB::bind_method(D_METHOD("drain_unit_changes"), &GameEngine::drain_unit_changes);
+    ClassDB::bind_method(D_METHOD("take_effects", "player_index"), &GameEngine::take_effects);
+    ClassDB::bind_method(D_METHOD("get_presentation_snapshot"), &GameEngine::get_presentation_snapshot);
+    ClassDB::bind_method(D_METHOD("is_tile_scanned", "player_index", "pos"), &GameEngine::is_tile_scanned);
 
     // Unit access
     ClassDB::bind_method(D_METHOD("get_unit_by_id", "player_index", "unit_id"), &GameEngine::get_unit_by_id);
     ClassDB::bind_method(D_METHOD("get_player_vehicles", "player_index"), &GameEngine::get_player_vehicles);
     ClassDB::bind_method(D_METHOD("get_player_buildings", "player_index"), &GameEngine::get_player_buildings);
+    ClassDB::bind_method(D_METHOD("get_visible_units", "player_index"), &GameEngine::get_visible_units);
 
     // Action system
     ClassDB::bind_method(D_METHOD("get_actions"), &GameEngine::get_actions);
@@ -65,6 +88,7 @@ void GameEngine::_bind_methods() {
 
     // Data loading (Phase 8)
     ClassDB::bind_method(D_METHOD("load_game_data"), &GameEngine::load_game_data);
+    ClassDB::bind_method(D_METHOD("set_legacy_checksums", "enabled"), &GameEngine::set_legacy_checksums);
     ClassDB::bind_method(D_METHOD("get_available_maps"), &GameEngine::get_available_maps);
     ClassDB::bind_method(D_METHOD("get_available_clans"), &GameEngine::get_available_clans);
     ClassDB::bind_method(D_METHOD("get_unit_data_info"), &GameEngine::get_unit_data_info);
@@ -90,9 +114,19 @@ void GameEngine::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_save_game_list"), &GameEngine::get_save_game_list);
     ClassDB::bind_method(D_METHOD("get_save_game_info", "slot"), &GameEngine::get_save_game_info);
 
+    // Replays
+    ClassDB::bind_method(D_METHOD("set_replay_directory", "path"), &GameEngine::set_replay_directory);
+    ClassDB::bind_method(D_METHOD("set_desync_diagnosis_directory", "path"), &GameEngine::set_desync_diagnosis_directory);
+    ClassDB::bind_method(D_METHOD("load_replay", "path"), &GameEngine::load_replay);
+    ClassDB::bind_method(D_METHOD("advance_replay", "ticks", "animations"), &GameEngine::advance_replay, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("seek_replay", "game_time"), &GameEngine::seek_replay);
+    ClassDB::bind_method(D_METHOD("is_replay_loaded"), &GameEngine::is_replay_loaded);
+
     // Turn system & game loop (Phase 5)
     ClassDB::bind_method(D_METHOD("advance_tick"), &GameEngine::advance_tick);
     ClassDB::bind_method(D_METHOD("advance_ticks", "count"), &GameEngine::advance_ticks);
+    ClassDB::bind_method(D_METHOD("fast_forward", "max_ticks", "budget_msec", "stop_on_attack", "watch_player_id"),
+                         &GameEngine::fast_forward, DEFVAL(true), DEFVAL(-1));
     ClassDB::bind_method(D_METHOD("get_game_time"), &GameEngine::get_game_time);
     ClassDB::bind_method(D_METHOD("end_player_turn", "player_id"), &GameEngine::end_player_turn);
     ClassDB::bind_method(D_METHOD("start_player_turn", "player_id"), &GameEngine::start_player_turn);
@@ -123,6 +157,13 @@ void GameEngine::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_model_checksum"), &GameEngine::get_model_checksum);
     ClassDB::bind_method(D_METHOD("get_player_connection_states"), &GameEngine::get_player_connection_states);
 
+    // Profiling
+    ClassDB::bind_method(D_METHOD("set_profiling_enabled", "enabled"), &GameEngine::set_profiling_enabled);
+    ClassDB::bind_method(D_METHOD("is_profiling_enabled"), &GameEngine::is_profiling_enabled);
+    ClassDB::bind_method(D_METHOD("get_turn_profile"), &GameEngine::get_turn_profile);
+    ClassDB::bind_method(D_METHOD("start_profile_trace"), &GameEngine::start_profile_trace);
+    ClassDB::bind_method(D_METHOD("write_profile_trace", "path"), &GameEngine::write_profile_trace);
+
     // Signals for turn system events
     ADD_SIGNAL(MethodInfo("turn_ended"));
     ADD_SIGNAL(MethodInfo("turn_started", PropertyInfo(Variant::INT, "turn_number")));
@@ -133,6 +174,7 @@ void GameEngine::_bind_methods() {
     // Network signals
     ADD_SIGNAL(MethodInfo("freeze_mode_changed", PropertyInfo(Variant::STRING, "mode")));
     ADD_SIGNAL(MethodInfo("connection_lost"));
+    ADD_SIGNAL(MethodInfo("desync_report_written", PropertyInfo(Variant::STRING, "path")));
 
     // Phase 23: Unit event signals
     ADD_SIGNAL(MethodInfo("unit_attacked",
@@ -162,6 +204,7 @@ GameEngine::GameEngine() {
 
 GameEngine::~GameEngine() {
     // Stop server/client threads before cleanup
+    GameModelLock::set_mutex(nullptr);
     if (server) {
         server->stop();
     }
@@ -189,6 +232,13 @@ cModel* GameEngine::get_active_model() const {
 
 void GameEngine::connect_model_signals(cModel* m) {
     if (!m) return;
+    // In HOST mode the server thread emits the model's signals only inside
+    // cServer::runOnce(), which holds the model mutex. Holding it here keeps
+    // every connect below, and the destruction of the previous journal and
+    // effect channel, between two server runs.
+    GameModelLock model_lock;
+
+    m->getProfiler().setEnabled(profiling_enabled);
 
     // Core turn signals
     m->turnEnded.connect([this]() {
@@ -225,6 +275,58 @@ void GameEngine::connect_model_signals(cModel* m) {
         call_deferred("emit_signal", "sudden_death");
     });
 
+    // Fog of war dirty tracking: start with the whole map dirty so the
+    // first take_fog_dirty_rect() triggers a full refresh.
+    {
+        const auto& players = m->getPlayerList();
+        const auto map = m->getMap();
+        const Rect2i full = map ? Rect2i(0, 0, map->getSize().x(), map->getSize().y()) : Rect2i();
+        std::lock_guard<std::mutex> lock(fog_dirty_mutex);
+        fog_dirty_rects.assign(players.size(), full);
+        fog_dirty_game_times.assign(players.size(), 0);
+    }
+    for (size_t i = 0; i < m->getPlayerList().size(); i++) {
+        const auto& playerPtr = m->getPlayerList()[i];
+        if (!playerPtr) continue;
+        auto mark_fog_dirty = [this, i, m](const std::vector<cPosition>& positions) {
+            if (positions.empty()) return;
+            int min_x = positions[0].x(), max_x = min_x;
+            int min_y = positions[0].y(), max_y = min_y;
+            for (const auto& pos : positions) {
+                min_x = std::min(min_x, pos.x());
+                max_x = std::max(max_x, pos.x());
+                min_y = std::min(min_y, pos.y());
+                max_y = std::max(max_y, pos.y());
+            }
+            const Rect2i changed(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+            std::lock_guard<std::mutex> lock(fog_dirty_mutex);
+            if (i >= fog_dirty_rects.size()) return;
+            auto& rect = fog_dirty_rects[i];
+            rect = rect.has_area() ? rect.merge(changed) : changed;
+            fog_dirty_game_times[i] = m->getGameTime();
+        };
+        playerPtr->getScanMap().positionsInRange.connect(mark_fog_dirty);
+        playerPtr->getScanMap().positionsOutOfRange.connect(mark_fog_dirty);
+    }
+
+    // Unit change journal for incremental rendering
+    unit_journal = std::make_unique<cUnitChangeJournal>();
+    if (m->getMap()) unit_journal->attach(*m);
+
+    // Visible effects per player, for the renderers of the local players
+    effect_channel = std::make_unique<cEffectChannel>();
+    effect_channel->attach(*m);
+
+    // In HOST/CLIENT mode the model runs on another thread; the main thread
+    // reads the snapshots it publishes after each tick
+    model_snapshot.reset();
+    frame_snapshot = nullptr;
+    frame_snapshot_valid = false;
+    if (network_mode != SINGLE_PLAYER) {
+        model_snapshot = std::make_unique<cModelSnapshotPublisher>();
+        model_snapshot->attach(*m);
+    }
+
     // Phase 23: Per-player signals
     for (const auto& playerPtr : m->getPlayerList()) {
         if (!playerPtr) continue;
@@ -287,6 +389,9 @@ void GameEngine::accept_lobby_handoff(std::shared_ptr<cConnectionManager> conn_m
     client = std::move(cli);
     network_mode = mode;
     engine_initialized = true;
+    replay.reset();
+    // the wrappers read the server model, while the server thread runs it
+    GameModelLock::set_mutex(server && mode == HOST ? &server->getModelMutex() : nullptr);
 
     // Connect model signals from the active model
     connect_model_signals(get_active_model());
@@ -298,12 +403,24 @@ void GameEngine::accept_lobby_handoff(std::shared_ptr<cConnectionManager> conn_m
         client->connectionToServerLost.connect([this]() {
             call_deferred("emit_signal", "connection_lost");
         });
+        client->desyncReportWritten.connect([this](const std::filesystem::path& path) {
+            call_deferred("emit_signal", "desync_report_written", String(path.string().c_str()));
+        });
+        client->setDesyncDiagnosisPath(desync_diagnosis_path);
     }
 
     UtilityFunctions::print("[MaXtreme] Lobby handoff complete, mode=",
                             mode == HOST ? "HOST" : "CLIENT");
 }
 
+void GameEngine::set_desync_diagnosis_directory(String path) {
+    const String global_path = path.is_empty() ? String() : ProjectSettings::get_singleton()->globalize_path(path);
+    desync_diagnosis_path = global_path.utf8().get_data();
+    if (client) {
+        client->setDesyncDiagnosisPath(desync_diagnosis_path);
+    }
+}
+
 String GameEngine::get_network_mode() const {
     switch (network_mode) {
         case HOST: return String("host");
@@ -340,6 +457,7 @@ bool GameEngine::is_engine_initialized() const {
 }
 
 void GameEngine::initialize_engine() {
+    replay.reset();
     model = std::make_unique<cModel>();
     engine_initialized = true;
 
@@ -351,7 +469,21 @@ void GameEngine::initialize_engine() {
 
 // --- Game state ---
 
+const sModelSnapshot* GameEngine::acquire_model_snapshot() const {
+    if (!model_snapshot) return nullptr;
+    // One snapshot per frame, so that all getters called during a frame
+    // describe the same tick
+    const uint64_t frame = Engine::get_singleton()->get_process_frames();
+    if (!frame_snapshot_valid || frame != frame_snapshot_frame) {
+        frame_snapshot = model_snapshot->acquire();
+        frame_snapshot_frame = frame;
+        frame_snapshot_valid = true;
+    }
+    return frame_snapshot;
+}
+
 int GameEngine::get_turn_number() const {
+    if (auto* snapshot = acquire_model_snapshot()) return snapshot->turn;
     auto* m = get_active_model();
     if (!m) return -1;
     auto turnCounter = m->getTurnCounter();
@@ -359,6 +491,7 @@ int GameEngine::get_turn_number() const {
 }
 
 int GameEngine::get_player_count() const {
+    if (auto* snapshot = acquire_model_snapshot()) return static_cast<int>(snapshot->players.size());
     auto* m = get_active_model();
     if (!m) return 0;
     return static_cast<int>(m->getPlayerList().size());
@@ -401,6 +534,223 @@ Ref<GamePlayer> GameEngine::get_player(int index) const {
     return game_player;
 }
 
+Rect2i GameEngine::take_fog_dirty_rect(int player_index) {
+    // In multiplayer the scan map changes in a tick, whose snapshot may not be
+    // published yet. Changes between two ticks go to the snapshot of the next one.
+    // So the rect is reported again, until a snapshot after the latest change arrived.
+    const sModelSnapshot* snapshot = network_mode != SINGLE_PLAYER ? acquire_model_snapshot() : nullptr;
+    std::lock_guard<std::mutex> lock(fog_dirty_mutex);
+    if (player_index < 0 || player_index >= static_cast<int>(fog_dirty_rects.size())) return Rect2i();
+    if (network_mode != SINGLE_PLAYER) {
+        if (!snapshot) return Rect2i();
+        if (snapshot->gameTime <= fog_dirty_game_times[player_index]) return fog_dirty_rects[player_index];
+    }
+    Rect2i rect = fog_dirty_rects[player_index];
+    fog_dirty_rects[player_index] = Rect2i();
+    return rect;
+}
+
+PackedByteArray GameEngine::get_visibility_bitmask(int player_index) const {
+    if (network_mode == SINGLE_PLAYER) {
+        Ref<GamePlayer> player = get_player(player_index);
+        return player.is_valid() ? player->get_visibility_bitmask() : PackedByteArray();
+    }
+    const sModelSnapshot* snapshot = acquire_model_snapshot();
+    auto* m = get_active_model();
+    if (!snapshot || !m || !m->getMap()) return PackedByteArray();
+    if (player_index < 0 || player_index >= static_cast<int>(snapshot->players.size())) return PackedByteArray();
+    const auto& player = snapshot->players[player_index];
+    const auto& size = m->getMap()->getSize(); // the map size does not change while the game runs
+    return GamePlayer::pack_visibility_bits(player.scanBits, player.scanWordsPerRow, Vector2i(size.x(), size.y()));
+}
+
+Dictionary GameEngine::drain_unit_changes() {
+    Dictionary result;
+    if (!unit_journal) return result;
+
+    const auto entries = unit_journal->drain();
+    const int count = static_cast<int>(entries.size());
+
+    std::vector<int> index_of_player_id;
+    if (auto* m = get_active_model()) {
+        const auto& players = m->getPlayerList();
+        for (size_t i = 0; i < players.size(); i++) {
+            const int id = players[i]->getId();
+            if (id < 0) continue;
+            if (id >= static_cast<int>(index_of_player_id.size())) index_of_player_id.resize(id + 1, -1);
+            index_of_player_id[id] = static_cast<int>(i);
+        }
+    }
+
+    PackedInt32Array ids, changes, players, hitpoints, positions;
+    PackedByteArray is_building;
+    ids.resize(count);
+    changes.resize(count);
+    players.resize(count);
+    hitpoints.resize(count);
+    positions.resize(count * 2);
+    is_building.resize(count);
+    for (int i = 0; i < count; i++) {
+        const auto& entry = entries[i];
+        const int player_id = entry.playerId;
+        ids[i] = static_cast<int32_t>(entry.unitId);
+        changes[i] = entry.changes;
+        players[i] = (player_id >= 0 && player_id < static_cast<int>(index_of_player_id.size()))
+            ? index_of_player_id[player_id] : -1;
+        hitpoints[i] = entry.hitpoints;
+        positions[2 * i] = entry.position.x();
+        positions[2 * i + 1] = entry.position.y();
+        is_building[i] = entry.isBuilding ? 1 : 0;
+    }
+
+    result["ids"] = ids;
+    result["changes"] = changes;
+    result["players"] = players;
+    result["hitpoints"] = hitpoints;
+    result["positions"] = positions;
+    result["is_building"] = is_building;
+    return result;
+}
+
+Dictionary GameEngine::take_effects(int player_index) {
+    Dictionary result;
+    if (!effect_channel || player_index < 0) return result;
+
+    const auto entries = effect_channel->drain(static_cast<size_t>(player_index));
+    const int count = static_cast<int>(entries.size());
+
+    PackedStringArray types;
+    PackedInt32Array positions, target_positions, directions, lengths, flags;
+    types.resize(count);
+    positions.resize(count * 2);
+    target_positions.resize(count * 2);
+    directions.resize(count);
+    lengths.resize(count);
+    flags.resize(count);
+    for (int i = 0; i < count; i++) {
+        const auto& entry = entries[i];
+        types[i] = cEffectChannel::getTypeName(entry.type);
+        positions[2 * i] = entry.pixelPosition.x();
+        positions[2 * i + 1] = entry.pixelPosition.y();
+        target_positions[2 * i] = entry.targetPixelPosition.x();
+        target_positions[2 * i + 1] = entry.targetPixelPosition.y();
+        directions[i] = entry.direction;
+        lengths[i] = entry.length;
+        flags[i] = entry.flags;
+    }
+
+    result["types"] = types;
+    result["positions"] = positions;
+    result["target_positions"] = target_positions;
+    result["directions"] = directions;
+    result["lengths"] = lengths;
+    result["flags"] = flags;
+    return result;
+}
+
+Dictionary GameEngine::get_presentation_snapshot() const {
+    Dictionary result;
+    auto* m = get_active_model();
+    if (!m || !m->getMap() || !m->getUnitsData()) return result;
+    sModelSnapshot local;
+    const sModelSnapshot* snapshot = acquire_model_snapshot();
+    if (!snapshot && network_mode == SINGLE_PLAYER) {
+        cModelSnapshotPublisher::capture(*m, local);
+        local.version = m->getGameTime();
+        snapshot = &local;
+    }
+    if (!snapshot) return result;
+
+    result["version"] = static_cast<int64_t>(snapshot->version);
+    result["game_time"] = static_cast<int64_t>(snapshot->gameTime);
+    result["turn"] = snapshot->turn;
+    result["is_turn_active"] = snapshot->turnActive;
+
+    std::vector<int> index_of_player_id;
+    Array players;
+    for (size_t i = 0; i < snapshot->players.size(); i++) {
+        const auto& player = snapshot->players[i];
+        if (player.id >= 0) {
+            if (player.id >= static_cast<int>(index_of_player_id.size())) index_of_player_id.resize(player.id + 1, -1);
+            index_of_player_id[player.id] = static_cast<int>(i);
+        }
+        Dictionary ps;
+        ps["id"] = player.id;
+        ps["name"] = String(player.name.c_str());
+        ps["credits"] = player.credits;
+        ps["finished_turn"] = player.hasFinishedTurn;
+        ps["defeated"] = player.isDefeated;
+        players.push_back(ps);
+    }
+    result["players"] = players;
+
+    const int count = static_cast<int>(snapshot->units.size());
+    PackedInt32Array ids, unit_players, flags, hitpoints, hitpoints_max, ammo, speed, stored_units, flight_heights, positions;
+    PackedByteArray build_progress;
+    PackedStringArray type_names;
+    const auto& units_data = *m->getUnitsData(); // static unit data is not changed while the game runs
+    ids.resize(count);
+    unit_players.resize(count);
+    flags.resize(count);
+    hitpoints.resize(count);
+    hitpoints_max.resize(count);
+    ammo.resize(count);
+    speed.resize(count);
+    stored_units.resize(count);
+    flight_heights.resize(count);
+    positions.resize(count * 2);
+    build_progress.resize(count);
+    type_names.resize(count);
+    for (int i = 0; i < count; i++) {
+        const auto& unit = snapshot->units[i];
+        ids[i] = static_cast<int32_t>(unit.id);
+        unit_players[i] = (unit.playerId >= 0 && unit.playerId < static_cast<int>(index_of_player_id.size()))
+            ? index_of_player_id[unit.playerId] : -1;
+        flags[i] = unit.flags;
+        hitpoints[i] = unit.hitpoints;
+        hitpoints_max[i] = unit.hitpointsMax;
+        ammo[i] = unit.ammo;
+        speed[i] = unit.speed;
+        stored_units[i] = unit.storedUnits;
+        flight_heights[i] = unit.flightHeight;
+        positions[2 * i] = unit.position.x();
+        positions[2 * i + 1] = unit.position.y();
+        build_progress[i] = static_cast<uint8_t>(unit.buildProgress);
+        type_names[i] = String(units_data.getStaticUnitData(unit.typeId).getDefaultName().c_str());
+    }
+    result["unit_ids"] = ids;
+    result["unit_players"] = unit_players;
+    result["unit_flags"] = flags;
+    result["hitpoints"] = hitpoints;
+    result["hitpoints_max"] = hitpoints_max;
+    result["ammo"] = ammo;
+    result["speed"] = speed;
+    result["stored_units"] = stored_units;
+    result["flight_heights"] = flight_heights;
+    result["unit_positions"] = positions;
+    result["build_progress"] = build_progress;
+    result["unit_type_names"] = type_names;
+    return result;
+}
+
+bool GameEngine::is_tile_scanned(int player_index, Vector2i pos) const {
+    if (const sModelSnapshot* snapshot = acquire_model_snapshot()) {
+        if (player_index < 0 || player_index >= static_cast<int>(snapshot->players.size())) return false;
+        const auto& player = snapshot->players[player_index];
+        if (pos.x < 0 || pos.y < 0 || player.scanWordsPerRow == 0) return false;
+        const size_t word = static_cast<size_t>(pos.y) * player.scanWordsPerRow + pos.x / 64;
+        if (pos.x / 64 >= player.scanWordsPerRow || word >= player.scanBits.size()) return false;
+        return (player.scanBits[word] >> (pos.x % 64)) & 1;
+    }
+    auto* m = get_active_model();
+    if (!m || !m->getMap() || network_mode != SINGLE_PLAYER) return false;
+    const auto& players = m->getPlayerList();
+    if (player_index < 0 || player_index >= static_cast<int>(players.size())) return false;
+    const cPosition position(pos.x, pos.y);
+    if (!m->getMap()->isValidPosition(position)) return false;
+    return players[player_index]->getScanMap().get(position);
+}
+
 Array GameEngine::get_all_players() const {
     Array result;
     auto* m = get_active_model();
@@ -419,6 +769,7 @@ Array GameEngine::get_all_players() const {
 // --- Unit access ---
 
 Ref<GameUnit> GameEngine::get_unit_by_id(int player_index, int unit_id) const {
+    GameModelLock model_lock;
     Ref<GameUnit> game_unit;
     game_unit.instantiate();
     auto* m = get_active_model();
@@ -445,6 +796,7 @@ Ref<GameUnit> GameEngine::get_unit_by_id(int player_index, int unit_id) const {
 }
 
 Array GameEngine::get_player_vehicles(int player_index) const {
+    GameModelLock model_lock;
     Array result;
     auto* m = get_active_model();
     if (!m) return result;
@@ -463,6 +815,7 @@ Array GameEngine::get_player_vehicles(int player_index) const {
 }
 
 Array GameEngine::get_player_buildings(int player_index) const {
+    GameModelLock model_lock;
     Array result;
     auto* m = get_active_model();
     if (!m) return result;
@@ -480,6 +833,193 @@ Array GameEngine::get_player_buildings(int player_index) const {
     return result;
 }
 
+namespace {
+    Dictionary get_visible_units_from_snapshot(const sModelSnapshot& snapshot, const cUnitsData& units_data, int player_index) {
+        Dictionary result;
+        if (player_index >= static_cast<int>(snapshot.players.size()) || player_index >= 32) return result;
+        std::vector<int> index_of_player_id;
+        for (size_t i = 0; i < snapshot.players.size(); i++) {
+            const int id = snapshot.players[i].id;
+            if (id < 0) continue;
+            if (id >= static_cast<int>(index_of_player_id.size())) index_of_player_id.resize(id + 1, -1);
+            index_of_player_id[id] = static_cast<int>(i);
+        }
+
+        const size_t capacity = snapshot.units.size();
+        PackedInt32Array ids, unit_players, positions, types, hitpoints, hitpoints_max, flags, stored_units, flight_heights;
+        PackedByteArray build_progress;
+        PackedStringArray type_names;
+        ids.resize(capacity);
+        unit_players.resize(capacity);
+        positions.resize(capacity * 2);
+        types.resize(capacity);
+        hitpoints.resize(capacity);
+        hitpoints_max.resize(capacity);
+        flags.resize(capacity);
+        stored_units.resize(capacity);
+        flight_heights.resize(capacity);
+        build_progress.resize(capacity);
+
+        std::unordered_map<const cStaticUnitData*, int> type_index;
+        int count = 0;
+        for (const auto& unit : snapshot.units) {
+            if (player_index >= 0 && !(unit.visibleToPlayers & (uint32_t(1) << player_index))) continue;
+
+            const auto& static_data = units_data.getStaticUnitData(unit.typeId);
+            auto type = type_index.try_emplace(&static_data, static_cast<int>(type_names.size()));
+            if (type.second) type_names.push_back(String(static_data.getDefaultName().c_str()));
+
+            ids[count] = static_cast<int32_t>(unit.id);
+            unit_players[count] = (unit.playerId >= 0 && unit.playerId < static_cast<int>(index_of_player_id.size()))
+                ? index_of_player_id[unit.playerId] : -1;
+            positions[2 * count] = unit.position.x();
+            positions[2 * count + 1] = unit.position.y();
+            types[count] = type.first->second;
+            hitpoints[count] = unit.hitpoints;
+            hitpoints_max[count] = unit.hitpointsMax;
+            flags[count] = unit.flags;
+            stored_units[count] = unit.storedUnits;
+            flight_heights[count] = unit.flightHeight;
+            build_progress[count] = static_cast<uint8_t>(unit.buildProgress);
+            count++;
+        }
+        ids.resize(count);
+        unit_players.resize(count);
+        positions.resize(count * 2);
+        types.resize(count);
+        hitpoints.resize(count);
+        hitpoints_max.resize(count);
+        flags.resize(count);
+        stored_units.resize(count);
+        flight_heights.resize(count);
+        build_progress.resize(count);
+
+        result["unit_ids"] = ids;
+        result["unit_players"] = unit_players;
+        result["unit_positions"] = positions;
+        result["unit_types"] = types;
+        result["hitpoints"] = hitpoints;
+        result["hitpoints_max"] = hitpoints_max;
+        result["unit_flags"] = flags;
+        result["stored_units"] = stored_units;
+        result["flight_heights"] = flight_heights;
+        result["build_progress"] = build_progress;
+        result["type_names"] = type_names;
+        return result;
+    }
+}
+
+Dictionary GameEngine::get_visible_units(int player_index) const {
+    Dictionary result;
+    auto* m = get_active_model();
+    if (!m || !m->getMap()) return result;
+    if (network_mode != SINGLE_PLAYER) {
+        // the server or client thread changes the model, so only the published snapshot may be read
+        const sModelSnapshot* snapshot = acquire_model_snapshot();
+        if (!snapshot || !m->getUnitsData()) return result;
+        return get_visible_units_from_snapshot(*snapshot, *m->getUnitsData(), player_index);
+    }
+
+    const auto& players = m->getPlayerList();
+    const cPlayer* viewer = nullptr;
+    if (player_index >= 0) {
+        if (player_index >= static_cast<int>(players.size())) return result;
+        viewer = players[player_index].get();
+    }
+    std::vector<int> index_of_player_id;
+    for (size_t i = 0; i < players.size(); i++) {
+        const int id = players[i]->getId();
+        if (id < 0) continue;
+        if (id >= static_cast<int>(index_of_player_id.size())) index_of_player_id.resize(id + 1, -1);
+        index_of_player_id[id] = static_cast<int>(i);
+    }
+
+    // The store keeps the hot state of every unit in dense arrays ordered by id.
+    // Only flags, visibility and build progress need the unit objects.
+    const auto& store = m->getUnitStore();
+    const auto& map = *m->getMap();
+    const auto& store_ids = store.getIds();
+    const auto& store_owners = store.getOwners();
+    const auto& store_positions = store.getPositions();
+    const auto& store_flags = store.getFlags();
+    const auto& store_hitpoints = store.getHitpoints();
+    const auto& store_hitpoints_max = store.getHitpointsMax();
+
+    const size_t capacity = store.size();
+    PackedInt32Array ids, unit_players, positions, types, hitpoints, hitpoints_max, flags, stored_units, flight_heights;
+    PackedByteArray build_progress;
+    PackedStringArray type_names;
+    ids.resize(capacity);
+    unit_players.resize(capacity);
+    positions.resize(capacity * 2);
+    types.resize(capacity);
+    hitpoints.resize(capacity);
+    hitpoints_max.resize(capacity);
+    flags.resize(capacity);
+    stored_units.resize(capacity);
+    flight_heights.resize(capacity);
+    build_progress.resize(capacity);
+    int32_t* ids_w = ids.ptrw();
+    int32_t* players_w = unit_players.ptrw();
+    int32_t* positions_w = positions.ptrw();
+    int32_t* types_w = types.ptrw();
+    int32_t* hitpoints_w = hitpoints.ptrw();
+    int32_t* hitpoints_max_w = hitpoints_max.ptrw();
+    int32_t* flags_w = flags.ptrw();
+    int32_t* stored_units_w = stored_units.ptrw();
+    int32_t* flight_heights_w = flight_heights.ptrw();
+    uint8_t* build_progress_w = build_progress.ptrw();
+
+    std::unordered_map<const cStaticUnitData*, int> type_index;
+    int count = 0;
+    for (size_t i = 0; i < capacity; i++) {
+        if (store_flags[i] & cUnitStore::Loaded) continue;
+        const cUnit& unit = store.getUnit(i);
+        if (viewer && store_owners[i] != viewer->getId() && !viewer->canSeeUnit(unit, map)) continue;
+
+        const auto& static_data = unit.getStaticUnitData();
+        auto type = type_index.try_emplace(&static_data, static_cast<int>(type_names.size()));
+        if (type.second) type_names.push_back(String(static_data.getDefaultName().c_str()));
+
+        const int owner = store_owners[i];
+        ids_w[count] = static_cast<int32_t>(store_ids[i]);
+        players_w[count] = (owner >= 0 && owner < static_cast<int>(index_of_player_id.size())) ? index_of_player_id[owner] : -1;
+        positions_w[2 * count] = store_positions[i].x();
+        positions_w[2 * count + 1] = store_positions[i].y();
+        types_w[count] = type.first->second;
+        hitpoints_w[count] = store_hitpoints[i];
+        hitpoints_max_w[count] = store_hitpoints_max[i];
+        flags_w[count] = sModelSnapshot::getUnitFlags(unit);
+        stored_units_w[count] = static_cast<int32_t>(unit.storedUnits.size());
+        flight_heights_w[count] = (store_flags[i] & cUnitStore::Vehicle) ? static_cast<const cVehicle&>(unit).getFlightHeight() : 0;
+        build_progress_w[count] = static_cast<uint8_t>(sModelSnapshot::getBuildProgress(unit));
+        count++;
+    }
+    ids.resize(count);
+    unit_players.resize(count);
+    positions.resize(count * 2);
+    types.resize(count);
+    hitpoints.resize(count);
+    hitpoints_max.resize(count);
+    flags.resize(count);
+    stored_units.resize(count);
+    flight_heights.resize(count);
+    build_progress.resize(count);
+
+    result["unit_ids"] = ids;
+    result["unit_players"] = unit_players;
+    result["unit_positions"] = positions;
+    result["unit_types"] = types;
+    result["hitpoints"] = hitpoints;
+    result["hitpoints_max"] = hitpoints_max;
+    result["unit_flags"] = flags;
+    result["stored_units"] = stored_units;
+    result["flight_heights"] = flight_heights;
+    result["build_progress"] = build_progress;
+    result["type_names"] = type_names;
+    return result;
+}
+
 // --- Phase 18: Pre-game setup data ---
 
 Array GameEngine::get_purchasable_vehicles(int clan) const {
@@ -538,6 +1078,16 @@ bool GameEngine::load_game_data() {
     return GameSetup::ensure_data_loaded();
 }
 
+bool GameEngine::set_legacy_checksums(bool enabled) {
+    // the units data caches its checksum, when it is loaded
+    if (GameSetup::is_data_loaded()) {
+        UtilityFunctions::push_error("[MaXtreme] set_legacy_checksums() must be called before load_game_data()");
+        return false;
+    }
+    setCheckSumAlgorithm(enabled ? eCheckSumAlgorithm::Legacy : eCheckSumAlgorithm::Crc32c);
+    return true;
+}
+
 Array GameEngine::get_available_maps() const {
     return GameSetup::get_available_maps();
 }
@@ -557,6 +1107,7 @@ Dictionary GameEngine::new_game_test() {
         initialize_engine();
     }
     // Reset model for new game
+    replay.reset();
     model = std::make_unique<cModel>();
     auto result = GameSetup::setup_test_game(*model);
 
@@ -573,6 +1124,7 @@ Dictionary GameEngine::new_game(String map_name, Array player_names, Array playe
         initialize_engine();
     }
     // Reset model for new game
+    replay.reset();
     model = std::make_unique<cModel>();
     auto result = GameSetup::setup_custom_game(*model, map_name, player_names, player_colors, player_clans, start_credits);
 
@@ -589,6 +1141,7 @@ Dictionary GameEngine::new_game_ex(Dictionary game_settings) {
         initialize_engine();
     }
     // Reset model for new game
+    replay.reset();
     model = std::make_unique<cModel>();
     auto result = GameSetup::setup_custom_game_ex(*model, game_settings);
 
@@ -627,6 +1180,7 @@ Dictionary GameEngine::load_game(int slot) {
             initialize_engine();
         }
         // Reset model for loading
+        replay.reset();
         model = std::make_unique<cModel>();
 
         cSavegame savegame;
@@ -705,6 +1259,114 @@ Dictionary GameEngine::get_save_game_info(int slot) {
     return result;
 }
 
+// --- Replays ---
+
+void GameEngine::set_replay_directory(String path) {
+    const String global_path = path.is_empty() ? String() : ProjectSettings::get_singleton()->globalize_path(path);
+    cSettings::getInstance().setReplaysPath(std::filesystem::path(global_path.utf8().get_data()));
+}
+
+Dictionary GameEngine::load_replay(String path) {
+    Dictionary result;
+    if (network_mode != SINGLE_PLAYER) {
+        result["success"] = false;
+        result["error"] = String("Replays can only be played in single-player mode");
+        return result;
+    }
+    try {
+        if (!engine_initialized) {
+            initialize_engine();
+        }
+        const String global_path = ProjectSettings::get_singleton()->globalize_path(path);
+        auto loaded = std::make_unique<cReplay>(std::filesystem::path(global_path.utf8().get_data()));
+
+        model = std::make_unique<cModel>();
+        loaded->restore(*model);
+        replay = std::move(loaded);
+        connect_model_signals(model.get());
+
+        result["success"] = true;
+        result["start_game_time"] = static_cast<int>(replay->getStartGameTime());
+        result["end_game_time"] = static_cast<int>(replay->getEndGameTime());
+        result["action_count"] = static_cast<int>(replay->getActionCount());
+        result["keyframe_count"] = static_cast<int>(replay->getKeyframes().size());
+        result["turn"] = get_turn_number();
+        result["player_count"] = get_player_count();
+        result["map_name"] = get_map_name();
+    } catch (const std::exception& e) {
+        replay.reset();
+        result["success"] = false;
+        result["error"] = String(e.what());
+        UtilityFunctions::push_error("[MaXtreme] load_replay failed: ", e.what());
+    }
+    return result;
+}
+
+namespace {
+    /// Sets the animation signals of the model and restores them on scope exit,
+    /// so an exception from a tick can not leave them switched off.
+    class AnimationSignalsScope {
+    public:
+        AnimationSignalsScope(cModel& model, bool enabled) : model(model) { model.setAnimationSignalsEnabled(enabled); }
+        ~AnimationSignalsScope() { model.setAnimationSignalsEnabled(true); }
+        AnimationSignalsScope(const AnimationSignalsScope&) = delete;
+        AnimationSignalsScope& operator=(const AnimationSignalsScope&) = delete;
+
+    private:
+        cModel& model;
+    };
+}
+
+Dictionary GameEngine::advance_replay(int ticks, bool animations) {
+    Dictionary result;
+    if (!replay || !model) {
+        result["ticks"] = 0;
+        result["finished"] = true;
+        return result;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    AnimationSignalsScope animation_signals(*model, animations);
+    const unsigned int ticks_run = replay->advance(*model, ticks < 0 ? std::numeric_limits<unsigned int>::max() : static_cast<unsigned int>(ticks));
+    const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    const auto divergence = replay->getDivergenceGameTime();
+    result["ticks"] = static_cast<int>(ticks_run);
+    result["usec"] = static_cast<int64_t>(usec);
+    result["game_time"] = static_cast<int>(model->getGameTime());
+    result["end_game_time"] = static_cast<int>(replay->getEndGameTime());
+    result["finished"] = replay->isFinished(*model);
+    result["checksum"] = static_cast<int64_t>(model->getChecksum());
+    result["divergence_game_time"] = divergence ? static_cast<int>(*divergence) : -1;
+    return result;
+}
+
+Dictionary GameEngine::seek_replay(int game_time) {
+    Dictionary result;
+    if (!replay || !model) {
+        result["finished"] = true;
+        return result;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    AnimationSignalsScope animation_signals(*model, false);
+    replay->seek(*model, static_cast<unsigned int>(std::max(game_time, 0)));
+    const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    const auto divergence = replay->getDivergenceGameTime();
+    result["usec"] = static_cast<int64_t>(usec);
+    result["game_time"] = static_cast<int>(model->getGameTime());
+    result["end_game_time"] = static_cast<int>(replay->getEndGameTime());
+    result["finished"] = replay->isFinished(*model);
+    result["checksum"] = static_cast<int64_t>(model->getChecksum());
+    result["divergence_game_time"] = divergence ? static_cast<int>(*divergence) : -1;
+    return result;
+}
+
+bool GameEngine::is_replay_loaded() const {
+    return replay != nullptr;
+}
+
 // --- Turn System & Game Loop (Phase 5) ---
 
 void GameEngine::advance_tick() {
@@ -712,6 +1374,10 @@ void GameEngine::advance_tick() {
     if (network_mode != SINGLE_PLAYER) return;
     auto* m = get_active_model();
     if (!m) return;
+    if (replay) {
+        replay->advance(*m, 1);
+        return;
+    }
     m->advanceGameTime();
 }
 
@@ -719,12 +1385,98 @@ void GameEngine::advance_ticks(int count) {
     if (network_mode != SINGLE_PLAYER) return;
     auto* m = get_active_model();
     if (!m) return;
+    if (replay) {
+        replay->advance(*m, static_cast<unsigned int>(std::max(count, 0)));
+        return;
+    }
     for (int i = 0; i < count; i++) {
         m->advanceGameTime();
     }
 }
 
+Dictionary GameEngine::fast_forward(int max_ticks, double budget_msec, bool stop_on_attack, int watch_player_id) {
+    Dictionary result;
+    result["ticks"] = 0;
+    result["stop_reason"] = String();
+    auto* m = get_active_model();
+    if (!m || network_mode != SINGLE_PLAYER) {
+        result["game_time"] = get_game_time();
+        result["turn"] = get_turn_number();
+        result["turn_changed"] = false;
+        result["is_turn_active"] = is_turn_active();
+        return result;
+    }
+
+    const int prev_turn = get_turn_number();
+    bool attack_started = false;
+    bool unit_seen = false;
+
+    std::unique_ptr<cMapView> watch_view;
+    cSignalConnectionManager connections; // declared after watch_view, so it disconnects first
+    if (stop_on_attack) {
+        connections.connect(m->attackJobAdded, [&attack_started](const cUnit&, const cPosition&) {
+            attack_started = true;
+        });
+    }
+    if (watch_player_id >= 0 && m->getMap()) {
+        for (const auto& player : m->getPlayerList()) {
+            if (player->getId() != watch_player_id) continue;
+            watch_view = std::make_unique<cMapView>(m->getMap(), player);
+            connections.connect(watch_view->unitAppeared, [&unit_seen](const cUnit&) {
+                unit_seen = true;
+            });
+            break;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<double, std::milli>(budget_msec);
+    int ticks = 0;
+    String stop_reason = "max_ticks";
+
+    AnimationSignalsScope animation_signals(*m, false);
+    while (ticks < max_ticks) {
+        if (is_turn_active()) {
+            stop_reason = "turn_active";
+            break;
+        }
+        if (replay) {
+            // the recorded actions have to be executed in the ticks, they were recorded for
+            if (replay->advance(*m, 1) == 0) {
+                stop_reason = "replay_finished";
+                break;
+            }
+        } else {
+            m->advanceGameTime();
+        }
+        ticks++;
+        if (attack_started) {
+            stop_reason = "attack";
+            break;
+        }
+        if (unit_seen) {
+            stop_reason = "unit_seen";
+            break;
+        }
+        if (budget_msec > 0.0 && std::chrono::steady_clock::now() - start >= budget) {
+            stop_reason = "budget";
+            break;
+        }
+    }
+    if (stop_reason == "max_ticks" && is_turn_active()) stop_reason = "turn_active";
+
+    const int new_turn = get_turn_number();
+    result["ticks"] = ticks;
+    result["stop_reason"] = stop_reason;
+    result["game_time"] = get_game_time();
+    result["turn"] = new_turn;
+    result["turn_changed"] = (new_turn != prev_turn);
+    result["is_turn_active"] = is_turn_active();
+    return result;
+}
+
 int GameEngine::get_game_time() const {
+    if (auto* snapshot = acquire_model_snapshot()) return static_cast<int>(snapshot->gameTime);
     auto* m = get_active_model();
     if (!m) return 0;
     return static_cast<int>(m->getGameTime());
@@ -771,6 +1523,7 @@ bool GameEngine::start_player_turn(int player_id) {
 }
 
 bool GameEngine::is_turn_active() const {
+    if (auto* snapshot = acquire_model_snapshot()) return snapshot->turnActive;
     auto* m = get_active_model();
     if (!m) return false;
     const auto& players = m->getPlayerList();
@@ -863,7 +1616,11 @@ Dictionary GameEngine::process_game_tick() {
 
     int prev_turn = get_turn_number();
 
-    m->advanceGameTime();
+    if (replay) {
+        replay->advance(*m, 1);
+    } else {
+        m->advanceGameTime();
+    }
 
     int new_turn = get_turn_number();
 
@@ -1139,3 +1896,64 @@ Array GameEngine::get_player_connection_states() const {
     }
     return result;
 }
+
+// ========== PROFILING ==========
+
+static Dictionary phases_to_dictionary(const std::vector<cProfiler::sPhase>& phases) {
+    Dictionary result;
+    for (const auto& phase : phases) {
+        Dictionary entry;
+        entry["usec"] = phase.microseconds;
+        entry["count"] = phase.count;
+        result[String(phase.name.c_str())] = entry;
+    }
+    return result;
+}
+
+void GameEngine::set_profiling_enabled(bool enabled) {
+    profiling_enabled = enabled;
+    if (auto* m = get_active_model()) {
+        m->getProfiler().setEnabled(enabled);
+    }
+}
+
+bool GameEngine::is_profiling_enabled() const {
+    return profiling_enabled;
+}
+
+Dictionary GameEngine::get_turn_profile() const {
+    Dictionary result;
+    result["enabled"] = profiling_enabled;
+    auto* m = get_active_model();
+    if (!m) return result;
+
+    const cProfiler& profiler = m->getProfiler();
+    result["last_tick"] = phases_to_dictionary(profiler.getLastTick());
+    result["current_turn"] = phases_to_dictionary(profiler.getCurrentTurn());
+    result["last_turn"] = phases_to_dictionary(profiler.getLastTurn());
+    result["last_turn_ticks"] = static_cast<int>(profiler.getLastTurnTickCount());
+    return result;
+}
+
+bool GameEngine::start_profile_trace() {
+    auto* m = get_active_model();
+    if (!m) return false;
+
+    set_profiling_enabled(true);
+    m->getProfiler().startTrace();
+    return true;
+}
+
+bool GameEngine::write_profile_trace(String path) {
+    auto* m = get_active_model();
+    if (!m) return false;
+
+    cProfiler& profiler = m->getProfiler();
+    profiler.stopTrace();
+    const String global_path = ProjectSettings::get_singleton()->globalize_path(path);
+    if (!profiler.writeTrace(std::filesystem::path(global_path.utf8().get_data()))) {
+        UtilityFunctions::push_warning("[MaXtreme] write_profile_trace: could not write ", global_path);
+        return false;
+    }
+    return true;
+}
@@ -5,8 +5,12 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
 
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 // Forward declarations of M.A.X.R. core types
 class cModel;
@@ -14,6 +18,11 @@ class cUnitsData;
 class cServer;
 class cClient;
 class cConnectionManager;
+class cUnitChangeJournal;
+class cEffectChannel;
+class cReplay;
+class cModelSnapshotPublisher;
+struct sModelSnapshot;
 
 // Forward declarations of wrapper types
 namespace godot {
@@ -58,8 +67,50 @@ private:
 
     /// Connect all model + player signals to Godot signals.
     /// Called from every game init path (new_game, load_game, lobby handoff).
+    /// Holds the model lock, so the server thread cannot emit meanwhile.
     void connect_model_signals(cModel* m);
 
+    // Fog of war: per-player bounding box of tiles whose visibility changed
+    // since the last take_fog_dirty_rect(). Fed by the scan map signals, which
+    // fire on the server thread in HOST mode, hence the mutex.
+    std::mutex fog_dirty_mutex;
+    std::vector<Rect2i> fog_dirty_rects;
+    // HOST/CLIENT: game time of the latest change in each rect. The rect is
+    // cleared only by a take with a snapshot taken after that time.
+    std::vector<unsigned int> fog_dirty_game_times;
+
+    // Units added/removed/moved/damaged/changed since the last drain_unit_changes()
+    std::unique_ptr<cUnitChangeJournal> unit_journal;
+
+    // Effects each player could see since the last take_effects()
+    std::unique_ptr<cEffectChannel> effect_channel;
+
+    // Single-player: replay played back on model, see load_replay()
+    std::unique_ptr<cReplay> replay;
+
+    // HOST/CLIENT: directory for desync reports, empty when disabled.
+    // Applied to the client at the lobby handoff.
+    std::string desync_diagnosis_path;
+
+    // Applied to every model passed to connect_model_signals()
+    bool profiling_enabled = false;
+
+    // HOST/CLIENT: state published by the thread running the model after each
+    // tick. Read instead of the live model, which that thread mutates meanwhile.
+    // Only the GameEngine getters, that use acquire_model_snapshot(), read it.
+    // The GameMap, GamePlayer, GameUnit and GamePathfinder wrappers read the
+    // live model under a GameModelLock, which waits for the server thread in HOST.
+    std::unique_ptr<cModelSnapshotPublisher> model_snapshot;
+    mutable const sModelSnapshot* frame_snapshot = nullptr;
+    mutable uint64_t frame_snapshot_frame = 0;
+    mutable bool frame_snapshot_valid = false;
+
+    /// Returns the snapshot of the current frame, or nullptr in single-player
+    /// mode and before the first tick. The latest published snapshot is picked
+    /// up by the first call in a frame, later calls in the same frame return
+    /// the same one. Main thread only.
+    const sModelSnapshot* acquire_model_snapshot() const;
+
 protected:
     static void _bind_methods();
 
@@ -85,11 +136,73 @@ public:
     Ref<GamePlayer> get_player(int index) const;
     Array get_all_players() const;
 
+    /// Returns the bounding rect of tiles whose visibility changed for the
+    /// given player since the previous call, and clears it. An empty rect
+    /// means nothing changed; the first call after game start covers the map.
+    /// In HOST/CLIENT mode a change is reported in every frame, until the
+    /// snapshot read by get_visibility_bitmask() in that frame contains it.
+    Rect2i take_fog_dirty_rect(int player_index);
+
+    /// Returns the player's visible tiles, see GamePlayer.get_visibility_bitmask().
+    /// In HOST/CLIENT mode taken from the latest snapshot (see get_presentation_snapshot),
+    /// empty before the first one.
+    PackedByteArray get_visibility_bitmask(int player_index) const;
+
+    /// Returns the units that changed since the previous call, and clears the journal.
+    /// {ids, changes, players, hitpoints: PackedInt32Array,
+    ///  positions: PackedInt32Array (x, y pairs), is_building: PackedByteArray}
+    /// changes is a bit set: 1 added, 2 removed, 4 moved, 8 damaged, 16 state changed.
+    /// players holds the player index, -1 for neutral units. The first call after
+    /// game start reports every unit on the map as added.
+    Dictionary drain_unit_changes();
+
+    /// Returns the effects (muzzle flashes, explosions, ...) at positions the
+    /// given player could see since the previous call, oldest first, and clears them.
+    /// {types: PackedStringArray, positions, target_positions: PackedInt32Array
+    ///  (pixel x, y pairs), directions, lengths, flags: PackedInt32Array}
+    /// types are e.g. "muzzle_big", "explo_small", "rocket", "hit".
+    /// target_positions differ from positions only for rockets. directions is -1
+    /// for effects without direction, lengths is in game ticks. flags is a bit set:
+    /// 1 big, 2 target hit, 4 on water, 8 drawn below units.
+    /// Only the latest 256 effects per player are kept.
+    Dictionary take_effects(int player_index);
+
+    /// Returns the model state published after the latest tick, safe to read
+    /// while the server thread runs the model (HOST/CLIENT). In single-player
+    /// mode it is taken from the model directly.
+    /// {version, game_time, turn, is_turn_active,
+    ///  players: [{id, name, credits, finished_turn, defeated}],
+    ///  unit_ids, unit_players, unit_flags, hitpoints, hitpoints_max, ammo, speed,
+    ///  stored_units, flight_heights: PackedInt32Array, unit_positions: PackedInt32Array
+    ///  (x, y pairs), build_progress: PackedByteArray, unit_type_names: PackedStringArray}
+    /// unit_players holds the player index. build_progress is the same as in get_visible_units(). unit_flags is a bit set: 1 building, 2 big,
+    /// 4 working, 8 building a building, 16 sentry, 32 manual fire, 64 disabled, 128 rubble,
+    /// 256 plane, 512 stealth, 1024 connects to base, 2048 mine, 4096 armed.
+    /// Empty when no snapshot is available yet.
+    Dictionary get_presentation_snapshot() const;
+
+    /// Returns true, if the tile is in the scan range of the player in the
+    /// latest snapshot (see get_presentation_snapshot).
+    bool is_tile_scanned(int player_index, Vector2i pos) const;
+
     // --- Unit access ---
     Ref<GameUnit> get_unit_by_id(int player_index, int unit_id) const;
     Array get_player_vehicles(int player_index) const;
     Array get_player_buildings(int player_index) const;
 
+    /// Returns all units the player can see, in one pass and ordered by id.
+    /// player_index -1 returns the units of all players without visibility check.
+    /// {unit_ids, unit_players, unit_types, hitpoints, hitpoints_max, unit_flags, stored_units,
+    ///  flight_heights: PackedInt32Array, unit_positions: PackedInt32Array (x, y pairs), build_progress: PackedByteArray,
+    ///  type_names: PackedStringArray}
+    /// unit_players holds the player index, -1 for neutral units. unit_types indexes
+    /// type_names. unit_flags uses the bits of get_presentation_snapshot().
+    /// build_progress is the percentage of the current construction or
+    /// production job, 0 when there is none. Loaded vehicles are not included.
+    /// In HOST/CLIENT mode the units are taken from the latest snapshot (see
+    /// get_presentation_snapshot), ordered by player and without neutral units.
+    Dictionary get_visible_units(int player_index) const;
+
     // --- Action system ---
     Ref<GameActions> get_actions() const;
 
@@ -103,6 +216,11 @@ public:
     /// Returns true if data loaded successfully.
     bool load_game_data();
 
+    /// Use the checksum algorithm of older versions, so that their players can join.
+    /// All players of a game need the same algorithm. Must be called before load_game_data().
+    /// Returns false if the game data is already loaded.
+    bool set_legacy_checksums(bool enabled);
+
     /// Get list of available map filenames from data/maps/
     Array get_available_maps() const;
 
@@ -170,6 +288,33 @@ public:
     /// Get info for a specific save slot. Returns a Dictionary (empty if slot not found).
     Dictionary get_save_game_info(int slot);
 
+    // --- Replays ---
+
+    /// Set the directory hosted games record their replays to (e.g. "user://replays").
+    /// Applies to games started afterwards. An empty path disables recording (default).
+    void set_replay_directory(String path);
+
+    /// Load a replay file in single-player mode and show its initial state.
+    /// {success, error, start_game_time, end_game_time, action_count, keyframe_count,
+    ///  turn, player_count, map_name}
+    /// While a replay is loaded, advance_tick(s) and process_game_tick play it back.
+    Dictionary load_replay(String path);
+
+    /// Run the loaded replay for the given number of ticks (< 0: to the end),
+    /// executing the recorded actions. Without animations, the model triggers no
+    /// effect and track signals (benchmarks, playback at maximum speed).
+    /// {ticks, usec, game_time, end_game_time, finished, checksum,
+    ///  divergence_game_time: first keyframe with another checksum than recorded, -1 if none}
+    Dictionary advance_replay(int ticks, bool animations);
+
+    /// Jump the loaded replay to a game time. Starts from the nearest in-memory
+    /// snapshot taken while playing (every turn start and every few hundred
+    /// ticks), so seeking back and forth does not re-run the whole recording.
+    /// {usec, game_time, end_game_time, finished, checksum, divergence_game_time}
+    Dictionary seek_replay(int game_time);
+
+    bool is_replay_loaded() const;
+
     // --- Networking (Phase 16) ---
 
     /// Set up as host: creates cConnectionManager, cServer, cClient (local).
@@ -197,6 +342,13 @@ public:
     /// Get the cClient pointer (for GameActions routing in multiplayer).
     cClient* get_client() const;
 
+    /// Diagnose desyncs: when the client model gets out of sync, it exchanges
+    /// per-part checksums (player fields, units, jobs, map resources, turn clock,
+    /// random generator) with the server and writes the state of the diverging
+    /// parts on both sides to a JSON file in the directory (e.g. "user://desync").
+    /// Emits desync_report_written(path). An empty path disables it (default).
+    void set_desync_diagnosis_directory(String path);
+
     // --- Turn System & Game Loop (Phase 5) ---
 
     /// Advance game time by one tick (10ms of game time).
@@ -207,6 +359,18 @@ public:
     /// Useful for fast-forwarding or processing a batch of ticks per frame.
     void advance_ticks(int count);
 
+    /// Run ticks without waiting for frames until the turn is active again,
+    /// or max_ticks or the wall-clock budget (budget_msec > 0) is exhausted.
+    /// With stop_on_attack, stops after the tick in which an attack started.
+    /// With watch_player_id >= 0, stops after the tick in which a unit
+    /// appeared on that player's map view. Track and effect signals, which
+    /// only feed animations, are not triggered meanwhile.
+    /// Returns {ticks, stop_reason, game_time, turn, turn_changed, is_turn_active};
+    /// stop_reason is "turn_active", "attack", "unit_seen", "max_ticks", "budget",
+    /// "replay_finished" or "" if nothing was run (multiplayer or no game).
+    /// While a replay is loaded, the ticks run through it like advance_ticks().
+    Dictionary fast_forward(int max_ticks, double budget_msec, bool stop_on_attack = true, int watch_player_id = -1);
+
     /// Get the current game time (in ticks, each tick = 10ms).
     int get_game_time() const;
 
@@ -282,6 +446,27 @@ public:
     /// Get player connection states as Array of Dictionaries.
     /// [{player_id, player_name, state: "connected"/"disconnected"/"not_responding"/"inactive"}]
     Array get_player_connection_states() const;
+
+    // --- Profiling ---
+
+    /// Enable the per-phase timers of the model (advanceGameTime, job runs, turn start phases).
+    void set_profiling_enabled(bool enabled);
+    bool is_profiling_enabled() const;
+
+    /// Get the measured phase times.
+    /// {enabled, last_tick, current_turn, last_turn: {phase_name: {usec, count}},
+    ///  last_turn_ticks: int}. last_turn covers the ticks up to and including
+    /// the most recent turn start. The counters "pool allocations",
+    /// "pool slab allocations" and "pool heap allocations" report the
+    /// allocations of the model's object pool in their count, with usec 0.
+    Dictionary get_turn_profile() const;
+
+    /// Start recording every timed phase as trace event (enables profiling).
+    bool start_profile_trace();
+
+    /// Stop recording and write the events as Chrome trace-event JSON
+    /// (chrome://tracing, ui.perfetto.dev). Accepts user:// and res:// paths.
+    bool write_profile_trace(String path);
 };
 
 } // namespace godot
@@ -144,10 +144,10 @@ bool GameLobby::select_map(String map_name) {
 
     try {
         std::string name = map_name.utf8().get_data();
-        auto staticMap = std::make_shared<cStaticMap>();
         std::filesystem::path mapPath = name;
+        auto staticMap = cStaticMapCache::get(mapPath);
 
-        if (!staticMap->loadMap(mapPath)) {
+        if (!staticMap) {
             UtilityFunctions::push_warning("[MaXtreme] GameLobby: Failed to load map: ", map_name);
             return false;
         }
@@ -208,6 +208,9 @@ bool GameLobby::join_game(String host, int port, String player_name, Color playe
         cPlayerBasicData localPlayer;
         localPlayer.setName(std::move(name));
         localPlayer.setColor(color);
+        // No player number until the server assigns one, otherwise the
+        // server discards the connect request as coming from a wrong sender.
+        localPlayer.setNr(-1);
 
         lobby_client = std::make_unique<cLobbyClient>(connection_manager, localPlayer);
 
@@ -393,6 +396,7 @@ void GameLobby::connect_client_signals() {
     lobby_client->onConnectionFailed.connect([this](eDeclineConnectionReason reason) {
         String reason_str;
         switch (reason) {
+            case eDeclineConnectionReason::DifferentCheckSumAlgorithm: reason_str = "Different checksum algorithm (legacy checksums)"; break;
             default: reason_str = "Connection failed"; break;
         }
         call_deferred("emit_signal", "connection_failed", reason_str);
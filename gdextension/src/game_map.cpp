@@ -1,10 +1,13 @@
 #include "game_map.h"
+#include "game_model_lock.h"
 
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #include "game/data/map/map.h"
 #include "utility/position.h"
 
+#include <vector>
+
 using namespace godot;
 
 void GameMap::_bind_methods() {
@@ -19,6 +22,11 @@ void GameMap::_bind_methods() {
     ClassDB::bind_method(D_METHOD("is_ground", "pos"), &GameMap::is_ground);
     ClassDB::bind_method(D_METHOD("get_terrain_type", "pos"), &GameMap::get_terrain_type);
 
+    ClassDB::bind_method(D_METHOD("get_terrain_grid"), &GameMap::get_terrain_grid);
+    ClassDB::bind_method(D_METHOD("get_coast_neighbor_grid"), &GameMap::get_coast_neighbor_grid);
+    ClassDB::bind_method(D_METHOD("get_resource_type_grid"), &GameMap::get_resource_type_grid);
+    ClassDB::bind_method(D_METHOD("get_resource_value_grid"), &GameMap::get_resource_value_grid);
+
     ClassDB::bind_method(D_METHOD("get_resource_at", "pos"), &GameMap::get_resource_at);
     ClassDB::bind_method(D_METHOD("get_filename"), &GameMap::get_filename);
 
@@ -89,9 +97,94 @@ String GameMap::get_terrain_type(Vector2i pos) const {
     return String("ground");
 }
 
+// --- Whole map grids ---
+
+PackedByteArray GameMap::get_terrain_grid() const {
+    PackedByteArray result;
+    if (!map) return result;
+
+    // Classify each terrain type once, then map the tile numbers
+    const auto& terrains = map->staticMap->getTerrains();
+    std::vector<uint8_t> terrain_class(terrains.size());
+    for (size_t i = 0; i < terrains.size(); i++) {
+        if (terrains[i].water) terrain_class[i] = 1;
+        else if (terrains[i].coast) terrain_class[i] = 2;
+        else if (terrains[i].blocked) terrain_class[i] = 3;
+        else terrain_class[i] = 0;
+    }
+    const auto& tiles = map->staticMap->getTileIndices();
+    result.resize(tiles.size());
+    uint8_t* out = result.ptrw();
+    for (size_t i = 0; i < tiles.size(); i++) {
+        out[i] = terrain_class[tiles[i]];
+    }
+    return result;
+}
+
+PackedByteArray GameMap::get_coast_neighbor_grid() const {
+    PackedByteArray result;
+    if (!map) return result;
+
+    const int w = map->getSize().x();
+    const int h = map->getSize().y();
+    const auto& terrains = map->staticMap->getTerrains();
+    const auto& tiles = map->staticMap->getTileIndices();
+
+    // Water mask with a border of one dry tile, so the neighbors need no bounds checks
+    const int stride = w + 2;
+    std::vector<uint8_t> water(static_cast<size_t>(stride) * (h + 2), 0);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            water[(y + 1) * stride + x + 1] = terrains[tiles[y * w + x]].water ? 1 : 0;
+        }
+    }
+
+    result.resize(static_cast<int64_t>(w) * h);
+    uint8_t* out = result.ptrw();
+    for (int y = 0; y < h; y++) {
+        const uint8_t* above = &water[y * stride + 1];
+        const uint8_t* row = &water[(y + 1) * stride + 1];
+        const uint8_t* below = &water[(y + 2) * stride + 1];
+        for (int x = 0; x < w; x++) {
+            out[y * w + x] = above[x] | (above[x + 1] << 1) | (row[x + 1] << 2) | (below[x + 1] << 3)
+                | (below[x] << 4) | (below[x - 1] << 5) | (row[x - 1] << 6) | (above[x - 1] << 7);
+        }
+    }
+    return result;
+}
+
+PackedByteArray GameMap::get_resource_type_grid() const {
+    GameModelLock model_lock;
+    PackedByteArray result;
+    if (!map) return result;
+
+    const auto& resources = map->getResources();
+    result.resize(resources.size());
+    uint8_t* out = result.ptrw();
+    for (size_t i = 0; i < resources.size(); i++) {
+        out[i] = static_cast<uint8_t>(resources[i].typ);
+    }
+    return result;
+}
+
+PackedByteArray GameMap::get_resource_value_grid() const {
+    GameModelLock model_lock;
+    PackedByteArray result;
+    if (!map) return result;
+
+    const auto& resources = map->getResources();
+    result.resize(resources.size());
+    uint8_t* out = result.ptrw();
+    for (size_t i = 0; i < resources.size(); i++) {
+        out[i] = resources[i].value;
+    }
+    return result;
+}
+
 // --- Resource queries ---
 
 Dictionary GameMap::get_resource_at(Vector2i pos) const {
+    GameModelLock model_lock;
     Dictionary result;
     if (!map) return result;
 
@@ -123,6 +216,7 @@ String GameMap::get_filename() const {
 // --- Field queries ---
 
 int GameMap::get_building_count_at(Vector2i pos) const {
+    GameModelLock model_lock;
     if (!map) return 0;
     cPosition p(pos.x, pos.y);
     if (!map->isValidPosition(p)) return 0;
@@ -130,6 +224,7 @@ int GameMap::get_building_count_at(Vector2i pos) const {
 }
 
 int GameMap::get_vehicle_count_at(Vector2i pos) const {
+    GameModelLock model_lock;
     if (!map) return 0;
     cPosition p(pos.x, pos.y);
     if (!map->isValidPosition(p)) return 0;
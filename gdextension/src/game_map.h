@@ -6,6 +6,7 @@
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 
 #include <memory>
 
@@ -16,6 +17,8 @@ namespace godot {
 
 /// GameMap - GDScript wrapper around M.A.X.R.'s cMap / cStaticMap.
 /// Exposes map geometry, terrain queries, and resource data to Godot.
+/// Geometry and terrain come from the static map and are read without locking;
+/// resources and units hold a GameModelLock.
 class GameMap : public RefCounted {
     GDCLASS(GameMap, RefCounted)
 
@@ -47,6 +50,20 @@ public:
     // --- Terrain type as string (for easy GDScript use) ---
     String get_terrain_type(Vector2i pos) const;
 
+    // --- Whole map grids, one byte per tile, row by row (index y * width + x) ---
+
+    /// Terrain class of each tile: 0 ground, 1 water, 2 coast, 3 blocked.
+    PackedByteArray get_terrain_grid() const;
+
+    /// Water neighbors of each tile, for coastal transitions.
+    /// Bits: N=1, NE=2, E=4, SE=8, S=16, SW=32, W=64, NW=128. Outside the map counts as no water.
+    PackedByteArray get_coast_neighbor_grid() const;
+
+    /// Resource type of each tile: 0 none, 1 metal, 2 oil, 3 gold.
+    PackedByteArray get_resource_type_grid() const;
+    /// Resource amount of each tile.
+    PackedByteArray get_resource_value_grid() const;
+
     // --- Resource queries ---
     Dictionary get_resource_at(Vector2i pos) const;
 
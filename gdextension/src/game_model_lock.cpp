@@ -0,0 +1,15 @@
+#include "game_model_lock.h"
+
+using namespace godot;
+
+namespace {
+    std::recursive_mutex* model_mutex = nullptr;
+}
+
+GameModelLock::GameModelLock() {
+    if (model_mutex) lock = std::unique_lock<std::recursive_mutex>(*model_mutex);
+}
+
+void GameModelLock::set_mutex(std::recursive_mutex* mutex) {
+    model_mutex = mutex;
+}
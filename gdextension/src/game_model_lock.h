@@ -0,0 +1,26 @@
+#ifndef MAXTREME_GAME_MODEL_LOCK_H
+#define MAXTREME_GAME_MODEL_LOCK_H
+
+#include <mutex>
+
+namespace godot {
+
+/// GameModelLock - Held by the GameMap, GamePlayer, GameUnit and GamePathfinder
+/// methods while they read the live model. In HOST mode the server thread runs
+/// that model and holds the same mutex while it processes messages and ticks.
+/// Without a mutex (single-player, CLIENT) nothing is locked.
+class GameModelLock {
+public:
+    GameModelLock();
+
+    /// Called by GameEngine, when a server starts or stops running the model.
+    /// Main thread only.
+    static void set_mutex(std::recursive_mutex* mutex);
+
+private:
+    std::unique_lock<std::recursive_mutex> lock;
+};
+
+} // namespace godot
+
+#endif // MAXTREME_GAME_MODEL_LOCK_H
@@ -1,4 +1,5 @@
 #include "game_pathfinder.h"
+#include "game_model_lock.h"
 
 #include <godot_cpp/variant/utility_functions.hpp>
 
@@ -71,6 +72,7 @@ static std::shared_ptr<cPlayer> find_owner(cModel* model, const cVehicle* vehicl
 // ============================================================
 
 PackedVector2Array GamePathfinder::calculate_path(int unit_id, Vector2i target) const {
+    GameModelLock model_lock;
     PackedVector2Array result;
     if (!model) return result;
 
@@ -92,7 +94,7 @@ PackedVector2Array GamePathfinder::calculate_path(int unit_id, Vector2i target)
     cPathCalculator pathCalc(*vehicle, mapView, dest, nullptr);
     auto path = pathCalc.calcPath();
 
-    // Convert forward_list to PackedVector2Array
+    // Convert path to PackedVector2Array
     for (const auto& pos : path) {
         result.push_back(Vector2(static_cast<float>(pos.x()), static_cast<float>(pos.y())));
     }
@@ -101,6 +103,7 @@ PackedVector2Array GamePathfinder::calculate_path(int unit_id, Vector2i target)
 }
 
 int GamePathfinder::get_path_cost(int unit_id, PackedVector2Array path) const {
+    GameModelLock model_lock;
     if (!model || path.size() < 2) return -1;
 
     auto* vehicle = find_vehicle(model, unit_id);
@@ -122,6 +125,7 @@ int GamePathfinder::get_path_cost(int unit_id, PackedVector2Array path) const {
 }
 
 int GamePathfinder::get_step_cost(int unit_id, Vector2i from, Vector2i to) const {
+    GameModelLock model_lock;
     if (!model) return -1;
 
     auto* vehicle = find_vehicle(model, unit_id);
@@ -147,6 +151,7 @@ struct ReachableNode {
 };
 
 Array GamePathfinder::get_reachable_tiles(int unit_id) const {
+    GameModelLock model_lock;
     Array result;
     if (!model) return result;
 
@@ -239,6 +244,7 @@ Array GamePathfinder::get_reachable_tiles(int unit_id) const {
 }
 
 PackedVector2Array GamePathfinder::get_reachable_positions(int unit_id) const {
+    GameModelLock model_lock;
     PackedVector2Array result;
     Array tiles = get_reachable_tiles(unit_id);
     for (int i = 0; i < tiles.size(); i++) {
@@ -250,6 +256,7 @@ PackedVector2Array GamePathfinder::get_reachable_positions(int unit_id) const {
 }
 
 bool GamePathfinder::is_tile_reachable(int unit_id, Vector2i target) const {
+    GameModelLock model_lock;
     if (!model) return false;
 
     // Quick check: calculate direct path and see if cost is within range
@@ -268,6 +275,7 @@ bool GamePathfinder::is_tile_reachable(int unit_id, Vector2i target) const {
 // ============================================================
 
 Array GamePathfinder::get_enemies_in_range(int unit_id) const {
+    GameModelLock model_lock;
     Array result;
     if (!model) return result;
 
@@ -347,6 +355,7 @@ Array GamePathfinder::get_enemies_in_range(int unit_id) const {
 }
 
 PackedVector2Array GamePathfinder::get_attack_range_tiles(int unit_id) const {
+    GameModelLock model_lock;
     PackedVector2Array result;
     if (!model) return result;
 
@@ -379,6 +388,7 @@ PackedVector2Array GamePathfinder::get_attack_range_tiles(int unit_id) const {
 }
 
 bool GamePathfinder::can_attack_position(int unit_id, Vector2i target) const {
+    GameModelLock model_lock;
     if (!model) return false;
 
     auto* vehicle = find_vehicle(model, unit_id);
@@ -399,6 +409,7 @@ bool GamePathfinder::can_attack_position(int unit_id, Vector2i target) const {
 }
 
 Dictionary GamePathfinder::preview_attack(int attacker_id, int target_id) const {
+    GameModelLock model_lock;
     Dictionary result;
     result["damage"] = 0;
     result["target_hp_after"] = 0;
@@ -440,6 +451,7 @@ Dictionary GamePathfinder::preview_attack(int attacker_id, int target_id) const
 // ============================================================
 
 int GamePathfinder::get_movement_points(int unit_id) const {
+    GameModelLock model_lock;
     if (!model) return 0;
     auto* vehicle = find_vehicle(model, unit_id);
     if (!vehicle) return 0;
@@ -447,6 +459,7 @@ int GamePathfinder::get_movement_points(int unit_id) const {
 }
 
 int GamePathfinder::get_movement_points_max(int unit_id) const {
+    GameModelLock model_lock;
     if (!model) return 0;
     auto* vehicle = find_vehicle(model, unit_id);
     if (!vehicle) return 0;
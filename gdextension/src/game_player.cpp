@@ -1,4 +1,5 @@
 #include "game_player.h"
+#include "game_model_lock.h"
 
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
@@ -72,6 +73,8 @@ void GamePlayer::_bind_methods() {
     ClassDB::bind_method(D_METHOD("can_see_at", "pos"), &GamePlayer::can_see_at);
     ClassDB::bind_method(D_METHOD("get_scan_map_data"), &GamePlayer::get_scan_map_data);
     ClassDB::bind_method(D_METHOD("get_scan_map_size"), &GamePlayer::get_scan_map_size);
+    ClassDB::bind_method(D_METHOD("get_visibility_bitmask"), &GamePlayer::get_visibility_bitmask);
+    ClassDB::bind_method(D_METHOD("get_visibility_image"), &GamePlayer::get_visibility_image);
 }
 
 GamePlayer::GamePlayer() {}
@@ -84,22 +87,26 @@ void GamePlayer::set_internal_player(std::shared_ptr<cPlayer> p) {
 // --- Identity ---
 
 String GamePlayer::get_name() const {
+    GameModelLock model_lock;
     if (!player) return String("");
     return String(player->getName().c_str());
 }
 
 int GamePlayer::get_id() const {
+    GameModelLock model_lock;
     if (!player) return -1;
     return player->getId();
 }
 
 Color GamePlayer::get_color() const {
+    GameModelLock model_lock;
     if (!player) return Color(1, 1, 1);
     const auto& c = player->getColor();
     return Color(c.r / 255.0f, c.g / 255.0f, c.b / 255.0f);
 }
 
 int GamePlayer::get_clan() const {
+    GameModelLock model_lock;
     if (!player) return -1;
     return player->getClan();
 }
@@ -107,11 +114,13 @@ int GamePlayer::get_clan() const {
 // --- Economy ---
 
 int GamePlayer::get_credits() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return player->getCredits();
 }
 
 int GamePlayer::get_score() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return player->getScore();
 }
@@ -119,11 +128,13 @@ int GamePlayer::get_score() const {
 // --- Unit counts ---
 
 int GamePlayer::get_vehicle_count() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return static_cast<int>(player->getVehicles().size());
 }
 
 int GamePlayer::get_building_count() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return static_cast<int>(player->getBuildings().size());
 }
@@ -131,6 +142,7 @@ int GamePlayer::get_building_count() const {
 // --- Research ---
 
 int GamePlayer::get_research_centers_working() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return player->getResearchCentersWorkingTotal();
 }
@@ -138,11 +150,13 @@ int GamePlayer::get_research_centers_working() const {
 // --- Game state ---
 
 bool GamePlayer::is_defeated() const {
+    GameModelLock model_lock;
     if (!player) return false;
     return player->isDefeated;
 }
 
 bool GamePlayer::has_finished_turn() const {
+    GameModelLock model_lock;
     if (!player) return false;
     return player->getHasFinishedTurn();
 }
@@ -150,21 +164,25 @@ bool GamePlayer::has_finished_turn() const {
 // --- Statistics ---
 
 int GamePlayer::get_built_vehicles_count() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return static_cast<int>(player->getGameOverStat().builtVehiclesCount);
 }
 
 int GamePlayer::get_lost_vehicles_count() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return static_cast<int>(player->getGameOverStat().lostVehiclesCount);
 }
 
 int GamePlayer::get_built_buildings_count() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return static_cast<int>(player->getGameOverStat().builtBuildingsCount);
 }
 
 int GamePlayer::get_lost_buildings_count() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return static_cast<int>(player->getGameOverStat().lostBuildingsCount);
 }
@@ -172,6 +190,7 @@ int GamePlayer::get_lost_buildings_count() const {
 // --- Phase 27: End-game stats ---
 
 PackedInt32Array GamePlayer::get_score_history() const {
+    GameModelLock model_lock;
     PackedInt32Array result;
     if (!player) return result;
     // getScore(turn) returns the historical score for that turn.
@@ -191,16 +210,19 @@ PackedInt32Array GamePlayer::get_score_history() const {
 }
 
 int GamePlayer::get_num_eco_spheres() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return player->getNumEcoSpheres();
 }
 
 int GamePlayer::get_total_upgrade_cost() const {
+    GameModelLock model_lock;
     if (!player) return 0;
     return static_cast<int>(player->getGameOverStat().totalUpgradeCost);
 }
 
 Dictionary GamePlayer::get_game_over_stats() const {
+    GameModelLock model_lock;
     Dictionary result;
     if (!player) return result;
     const auto& stats = player->getGameOverStat();
@@ -222,6 +244,7 @@ Dictionary GamePlayer::get_game_over_stats() const {
 // ========== BASE RESOURCE STORAGE (Phase 8) ==========
 
 Dictionary GamePlayer::get_resource_storage() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["metal"] = 0;
     result["oil"] = 0;
@@ -255,6 +278,7 @@ Dictionary GamePlayer::get_resource_storage() const {
 }
 
 Dictionary GamePlayer::get_resource_production() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["metal"] = 0;
     result["oil"] = 0;
@@ -277,6 +301,7 @@ Dictionary GamePlayer::get_resource_production() const {
 }
 
 Dictionary GamePlayer::get_resource_needed() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["metal"] = 0;
     result["oil"] = 0;
@@ -301,6 +326,7 @@ Dictionary GamePlayer::get_resource_needed() const {
 // ========== ENERGY BALANCE ==========
 
 Dictionary GamePlayer::get_energy_balance() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["production"] = 0;
     result["need"] = 0;
@@ -327,6 +353,7 @@ Dictionary GamePlayer::get_energy_balance() const {
 // ========== HUMAN BALANCE ==========
 
 Dictionary GamePlayer::get_human_balance() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["production"] = 0;
     result["need"] = 0;
@@ -350,6 +377,7 @@ Dictionary GamePlayer::get_human_balance() const {
 // ========== RESEARCH STATE ==========
 
 Dictionary GamePlayer::get_research_levels() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["attack"] = 0;
     result["shots"] = 0;
@@ -374,6 +402,7 @@ Dictionary GamePlayer::get_research_levels() const {
 }
 
 Array GamePlayer::get_research_centers_per_area() const {
+    GameModelLock model_lock;
     Array result;
     for (int i = 0; i < 8; ++i) result.push_back(0);
     if (!player) return result;
@@ -392,6 +421,7 @@ Array GamePlayer::get_research_centers_per_area() const {
 // ========== RESEARCH PROGRESS (Phase 21) ==========
 
 Array GamePlayer::get_research_remaining_turns() const {
+    GameModelLock model_lock;
     Array result;
     for (int i = 0; i < 8; ++i) result.push_back(0);
     if (!player) return result;
@@ -419,6 +449,7 @@ Array GamePlayer::get_research_remaining_turns() const {
 // ========== ECONOMY SUMMARY ==========
 
 Dictionary GamePlayer::get_economy_summary() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["credits"] = get_credits();
     result["resources"] = get_resource_storage();
@@ -433,11 +464,13 @@ Dictionary GamePlayer::get_economy_summary() const {
 // ========== RESOURCE SURVEY & SUB-BASES (Phase 22) ==========
 
 bool GamePlayer::has_resource_explored(Vector2i pos) const {
+    GameModelLock model_lock;
     if (!player) return false;
     return player->hasResourceExplored(cPosition(pos.x, pos.y));
 }
 
 Array GamePlayer::get_sub_bases() const {
+    GameModelLock model_lock;
     Array result;
     if (!player) return result;
 
@@ -485,16 +518,18 @@ Array GamePlayer::get_sub_bases() const {
 // ========== FOG OF WAR / VISIBILITY (Phase 14) ==========
 
 bool GamePlayer::can_see_at(Vector2i pos) const {
+    GameModelLock model_lock;
     if (!player) return false;
     return player->canSeeAt(cPosition(pos.x, pos.y));
 }
 
 PackedInt32Array GamePlayer::get_scan_map_data() const {
+    GameModelLock model_lock;
     PackedInt32Array result;
     if (!player) return result;
 
     const auto& scanMap = player->getScanMap();
-    auto raw = scanMap.getMap();
+    const auto& raw = scanMap.getMap();
     result.resize(static_cast<int>(raw.size()));
     for (size_t i = 0; i < raw.size(); i++) {
         result[static_cast<int>(i)] = static_cast<int32_t>(raw[i]);
@@ -503,18 +538,57 @@ PackedInt32Array GamePlayer::get_scan_map_data() const {
 }
 
 Vector2i GamePlayer::get_scan_map_size() const {
+    GameModelLock model_lock;
     if (!player) return Vector2i(0, 0);
-    // The scan map size matches the game map size.
-    // We can get it from the scan map data length and map width.
+    // The scan map is resized to match the game map.
+    const auto& size = player->getScanMap().getSize();
+    return Vector2i(size.x(), size.y());
+}
+
+PackedByteArray GamePlayer::get_visibility_bitmask() const {
+    GameModelLock model_lock;
+    if (!player) return PackedByteArray();
+
+    const auto& scanMap = player->getScanMap();
+    const auto& size = scanMap.getSize();
+    return pack_visibility_bits(scanMap.getBits(), scanMap.getWordsPerRow(), Vector2i(size.x(), size.y()));
+}
+
+PackedByteArray GamePlayer::pack_visibility_bits(const std::vector<uint64_t>& bits, int words_per_row, Vector2i size) {
+    PackedByteArray result;
+    const int row_bytes = (size.x + 7) / 8;
+    if (row_bytes <= 0 || size.y <= 0) return result;
+    if (words_per_row * 8 < row_bytes || bits.size() < static_cast<size_t>(words_per_row) * size.y) return result;
+
+    result.resize(row_bytes * size.y);
+    uint8_t* out = result.ptrw();
+    for (int y = 0; y < size.y; y++) {
+        const uint64_t* row = bits.data() + static_cast<size_t>(y) * words_per_row;
+        for (int b = 0; b < row_bytes; b++) {
+            *out++ = static_cast<uint8_t>(row[b / 8] >> (8 * (b % 8)));
+        }
+    }
+    return result;
+}
+
+Ref<Image> GamePlayer::get_visibility_image() const {
+    GameModelLock model_lock;
+    if (!player) return Ref<Image>();
+
     const auto& scanMap = player->getScanMap();
-    auto raw = scanMap.getMap();
-    if (raw.empty()) return Vector2i(0, 0);
-
-    // We need the map dimensions. The scan map is resized to match the map.
-    // Since we don't have direct access to map here, we infer from the player's first unit
-    // or we can use a simpler approach: the scan map stores size internally.
-    // Actually, let's just return the data size and let GDScript use the map dimensions.
-    // For convenience, we compute sqrt if it's square, otherwise GDScript uses map.get_size().
-    int total = static_cast<int>(raw.size());
-    return Vector2i(total, 1);  // GDScript should use game_map.get_size() for proper w/h
+    const auto& size = scanMap.getSize();
+    const auto& bits = scanMap.getBits();
+    const int words_per_row = scanMap.getWordsPerRow();
+    if (size.x() <= 0 || size.y() <= 0) return Ref<Image>();
+
+    PackedByteArray pixels;
+    pixels.resize(size.x() * size.y());
+    uint8_t* out = pixels.ptrw();
+    for (int y = 0; y < size.y(); y++) {
+        const uint64_t* row = bits.data() + static_cast<size_t>(y) * words_per_row;
+        for (int x = 0; x < size.x(); x++) {
+            *out++ = ((row[x / 64] >> (x % 64)) & 1) ? 255 : 0;
+        }
+    }
+    return Image::create_from_data(size.x(), size.y(), false, Image::FORMAT_L8, pixels);
 }
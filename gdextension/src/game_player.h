@@ -7,10 +7,14 @@
 #include <godot_cpp/variant/color.hpp>
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/packed_int32_array.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 class cPlayer;
 
@@ -146,6 +150,20 @@ public:
 
     /// Returns the map dimensions for interpreting scan map data.
     Vector2i get_scan_map_size() const;
+
+    /// Returns the visible tiles as a packed bit mask, one bit per tile.
+    /// Each row is (width + 7) / 8 bytes; tile (x, y) is bit (x & 7) of
+    /// byte y * row_bytes + (x >> 3). Copied straight from the scan map's
+    /// bit storage, so no per-tile work is done on either side.
+    PackedByteArray get_visibility_bitmask() const;
+
+    /// Packs scan map bits (see cRangeMap::getBits()) into the layout of
+    /// get_visibility_bitmask(). Empty if the bits do not cover size.
+    static PackedByteArray pack_visibility_bits(const std::vector<uint64_t>& bits, int words_per_row, Vector2i size);
+
+    /// Returns the visible tiles as an L8 image (width x height),
+    /// 255 = visible, 0 = not visible. Suitable for an ImageTexture fog mask.
+    Ref<Image> get_visibility_image() const;
 };
 
 } // namespace godot
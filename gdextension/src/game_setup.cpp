@@ -153,9 +153,10 @@ Dictionary GameSetup::get_unit_data_info() {
 // ========== MAP LOADING ==========
 
 std::shared_ptr<cStaticMap> GameSetup::load_map(const std::string& map_filename) {
-    auto staticMap = std::make_shared<cStaticMap>();
+    // Shared with lobby previews and previous games on the same map file
+    auto staticMap = cStaticMapCache::get(map_filename);
 
-    if (staticMap->loadMap(map_filename)) {
+    if (staticMap) {
         UtilityFunctions::print("[MaXtreme]   Map loaded: ", String(map_filename.c_str()),
             " (", staticMap->getSize().x(), "x", staticMap->getSize().y(), ")");
         return staticMap;
@@ -223,8 +224,8 @@ std::shared_ptr<cStaticMap> GameSetup::create_and_load_flat_map(int size) {
         return nullptr;
     }
 
-    auto staticMap = std::make_shared<cStaticMap>();
-    if (staticMap->loadMap("fallback_flat.wrl")) {
+    auto staticMap = cStaticMapCache::get("fallback_flat.wrl");
+    if (staticMap) {
         UtilityFunctions::print("[MaXtreme]   Fallback flat map loaded: ", size, "x", size);
         return staticMap;
     }
@@ -293,7 +294,7 @@ Dictionary GameSetup::setup_custom_game(
         }
 
         // Set UnitsDataGlobal on the model via shared_ptr
-        // The model needs its own copy of the units data
+        // The model shares equal units data with other games (see cUnitsDataCache)
         auto unitsData = std::make_shared<cUnitsData>(UnitsDataGlobal);
         model.setUnitsData(unitsData);
 
@@ -392,7 +393,7 @@ Dictionary GameSetup::setup_custom_game(
             if (clanIdx >= 0 && clanIdx < static_cast<int>(ClanDataGlobal.getClans().size())) {
                 auto* player = model.getPlayer(i);
                 if (player) {
-                    player->setClan(clanIdx, *unitsData);
+                    player->setClan(clanIdx, model.getUnitsData());
                 }
             }
         }
@@ -708,7 +709,7 @@ Dictionary GameSetup::setup_custom_game_ex(
             if (clanIdx >= 0 && clanIdx < static_cast<int>(ClanDataGlobal.getClans().size())) {
                 auto* player = model.getPlayer(i);
                 if (player) {
-                    player->setClan(clanIdx, *unitsData);
+                    player->setClan(clanIdx, model.getUnitsData());
                 }
             }
         }
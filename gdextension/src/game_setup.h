@@ -54,6 +54,9 @@ public:
     /// Returns true if data was loaded successfully.
     static bool ensure_data_loaded();
 
+    /// Whether the game data was loaded already
+    static bool is_data_loaded() { return data_loaded; }
+
     /// Get list of available map filenames from data/maps/
     static Array get_available_maps();
 
@@ -1,4 +1,5 @@
 #include "game_unit.h"
+#include "game_model_lock.h"
 
 #include <godot_cpp/variant/utility_functions.hpp>
 
@@ -154,11 +155,13 @@ void GameUnit::set_internal_unit(cUnit* u) {
 // --- Identity ---
 
 int GameUnit::get_id() const {
+    GameModelLock model_lock;
     if (!unit) return -1;
     return static_cast<int>(unit->getId());
 }
 
 String GameUnit::get_name() const {
+    GameModelLock model_lock;
     if (!unit) return String("");
     auto custom = unit->getCustomName();
     if (custom.has_value()) return String(custom.value().c_str());
@@ -166,21 +169,25 @@ String GameUnit::get_name() const {
 }
 
 String GameUnit::get_type_name() const {
+    GameModelLock model_lock;
     if (!unit) return String("");
     return String(unit->getStaticUnitData().getDefaultName().c_str());
 }
 
 String GameUnit::get_description() const {
+    GameModelLock model_lock;
     if (!unit) return String("");
     return String(unit->getStaticUnitData().getDefaultDescription().c_str());
 }
 
 bool GameUnit::is_vehicle() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->isAVehicle();
 }
 
 bool GameUnit::is_building() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->isABuilding();
 }
@@ -188,12 +195,14 @@ bool GameUnit::is_building() const {
 // --- Position ---
 
 Vector2i GameUnit::get_position() const {
+    GameModelLock model_lock;
     if (!unit) return Vector2i(-1, -1);
     const auto& pos = unit->getPosition();
     return Vector2i(pos.x(), pos.y());
 }
 
 bool GameUnit::is_big() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->getIsBig();
 }
@@ -201,66 +210,79 @@ bool GameUnit::is_big() const {
 // --- Core stats ---
 
 int GameUnit::get_hitpoints() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getHitpoints();
 }
 
 int GameUnit::get_hitpoints_max() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getHitpointsMax();
 }
 
 int GameUnit::get_armor() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getArmor();
 }
 
 int GameUnit::get_damage() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getDamage();
 }
 
 int GameUnit::get_speed() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getSpeed();
 }
 
 int GameUnit::get_speed_max() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getSpeedMax();
 }
 
 int GameUnit::get_scan() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getScan();
 }
 
 int GameUnit::get_range() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getRange();
 }
 
 int GameUnit::get_shots() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getShots();
 }
 
 int GameUnit::get_shots_max() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getShotsMax();
 }
 
 int GameUnit::get_ammo() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getAmmo();
 }
 
 int GameUnit::get_ammo_max() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getAmmoMax();
 }
 
 int GameUnit::get_build_cost() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getBuildCost();
 }
@@ -268,31 +290,37 @@ int GameUnit::get_build_cost() const {
 // --- Combat capability ---
 
 int GameUnit::get_can_attack() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return static_cast<int>(unit->getStaticUnitData().canAttack);
 }
 
 bool GameUnit::can_attack_air() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return (unit->getStaticUnitData().canAttack & 1) != 0; // eTerrainFlag::Air = 1
 }
 
 bool GameUnit::can_attack_ground() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return (unit->getStaticUnitData().canAttack & 4) != 0; // eTerrainFlag::Ground = 4
 }
 
 bool GameUnit::can_attack_sea() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return (unit->getStaticUnitData().canAttack & 2) != 0; // eTerrainFlag::Sea = 2
 }
 
 bool GameUnit::has_weapon() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->getStaticUnitData().canAttack != 0;
 }
 
 String GameUnit::get_muzzle_type() const {
+    GameModelLock model_lock;
     if (!unit) return String("None");
     switch (unit->getStaticUnitData().muzzleType) {
         case eMuzzleType::Big: return String("Big");
@@ -308,12 +336,14 @@ String GameUnit::get_muzzle_type() const {
 }
 
 int GameUnit::calc_damage_to(int target_armor) const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     int dmg = unit->data.getDamage() - target_armor;
     return std::max(1, dmg); // Minimum damage is always 1
 }
 
 bool GameUnit::is_in_range_of(Vector2i target_pos) const {
+    GameModelLock model_lock;
     if (!unit) return false;
     int range = unit->data.getRange();
     if (range <= 0) return false;
@@ -326,41 +356,49 @@ bool GameUnit::is_in_range_of(Vector2i target_pos) const {
 // --- State ---
 
 bool GameUnit::is_disabled() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->isDisabled();
 }
 
 int GameUnit::get_disabled_turns() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->getDisabledTurns();
 }
 
 bool GameUnit::is_sentry_active() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->isSentryActive();
 }
 
 bool GameUnit::is_manual_fire() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->isManualFireActive();
 }
 
 bool GameUnit::is_attacking() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->isAttacking();
 }
 
 bool GameUnit::is_being_attacked() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->isBeingAttacked();
 }
 
 int GameUnit::get_stored_resources() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->getStoredResources();
 }
 
 int GameUnit::get_stored_units_count() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return static_cast<int>(unit->storedUnits.size());
 }
@@ -368,6 +406,7 @@ int GameUnit::get_stored_units_count() const {
 // --- Owner ---
 
 int GameUnit::get_owner_id() const {
+    GameModelLock model_lock;
     if (!unit || !unit->getOwner()) return -1;
     return unit->getOwner()->getId();
 }
@@ -375,6 +414,7 @@ int GameUnit::get_owner_id() const {
 // --- Full stats dictionary ---
 
 Dictionary GameUnit::get_stats() const {
+    GameModelLock model_lock;
     Dictionary stats;
     if (!unit) return stats;
 
@@ -428,16 +468,19 @@ Dictionary GameUnit::get_stats() const {
 // ========== CONSTRUCTION CAPABILITY (vehicles) ==========
 
 String GameUnit::get_can_build() const {
+    GameModelLock model_lock;
     if (!unit) return String("");
     return String(unit->getStaticUnitData().canBuild.c_str());
 }
 
 bool GameUnit::is_constructor() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return !unit->getStaticUnitData().canBuild.empty();
 }
 
 Array GameUnit::get_buildable_types() const {
+    GameModelLock model_lock;
     Array result;
     if (!unit) return result;
 
@@ -466,24 +509,28 @@ Array GameUnit::get_buildable_types() const {
 }
 
 bool GameUnit::is_building_a_building() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return false;
     return v->isUnitBuildingABuilding();
 }
 
 int GameUnit::get_build_turns_remaining() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return 0;
     return v->getBuildTurns();
 }
 
 int GameUnit::get_build_costs_remaining() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return 0;
     return v->getBuildCosts();
 }
 
 int GameUnit::get_build_costs_start() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return 0;
     return v->getBuildCostsStart();
@@ -492,6 +539,7 @@ int GameUnit::get_build_costs_start() const {
 // ========== BUILDING PRODUCTION STATE ==========
 
 bool GameUnit::is_working() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (b) return b->isUnitWorking();
     // For vehicles, check if building a building
@@ -501,18 +549,21 @@ bool GameUnit::is_working() const {
 }
 
 bool GameUnit::can_start_work() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return false;
     return b->buildingCanBeStarted();
 }
 
 int GameUnit::get_build_list_size() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return 0;
     return static_cast<int>(b->getBuildListSize());
 }
 
 Array GameUnit::get_build_list() const {
+    GameModelLock model_lock;
     Array result;
     auto* b = as_building();
     if (!b) return result;
@@ -539,6 +590,7 @@ Array GameUnit::get_build_list() const {
 }
 
 Array GameUnit::get_producible_types() const {
+    GameModelLock model_lock;
     Array result;
     auto* b = as_building();
     if (!b) return result;
@@ -565,18 +617,21 @@ Array GameUnit::get_producible_types() const {
 }
 
 int GameUnit::get_build_speed() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return 0;
     return b->getBuildSpeed();
 }
 
 int GameUnit::get_metal_per_round() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return 0;
     return b->getMetalPerRound();
 }
 
 bool GameUnit::get_repeat_build() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return false;
     return b->getRepeatBuild();
@@ -585,6 +640,7 @@ bool GameUnit::get_repeat_build() const {
 // ========== BUILDING MINING STATE ==========
 
 Dictionary GameUnit::get_mining_production() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["metal"] = 0;
     result["oil"] = 0;
@@ -601,6 +657,7 @@ Dictionary GameUnit::get_mining_production() const {
 }
 
 Dictionary GameUnit::get_mining_max() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["metal"] = 0;
     result["oil"] = 0;
@@ -619,6 +676,7 @@ Dictionary GameUnit::get_mining_max() const {
 // ========== BUILDING RESEARCH STATE ==========
 
 int GameUnit::get_research_area() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return -1;
     if (!unit->getStaticUnitData().buildingData.canResearch) return -1;
@@ -628,22 +686,26 @@ int GameUnit::get_research_area() const {
 // ========== BUILDING UPGRADE & MISC ==========
 
 bool GameUnit::can_be_upgraded() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return false;
     return b->buildingCanBeUpgraded();
 }
 
 bool GameUnit::connects_to_base() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->getStaticUnitData().buildingData.connectsToBase;
 }
 
 int GameUnit::get_energy_production() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->getStaticUnitData().produceEnergy;
 }
 
 int GameUnit::get_energy_need() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->getStaticUnitData().needsEnergy;
 }
@@ -651,6 +713,7 @@ int GameUnit::get_energy_need() const {
 // ========== EXPERIENCE & VERSION (Phase 20) ==========
 
 int GameUnit::get_commando_rank() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return -1;
     // Only commandos (units with canCapture or canDisable) have ranks
@@ -660,6 +723,7 @@ int GameUnit::get_commando_rank() const {
 }
 
 String GameUnit::get_commando_rank_name() const {
+    GameModelLock model_lock;
     int rank = get_commando_rank();
     if (rank < 0) return String("");
     // Rank names from the original game
@@ -671,13 +735,15 @@ String GameUnit::get_commando_rank_name() const {
 }
 
 bool GameUnit::is_dated() const {
+    GameModelLock model_lock;
     if (!unit || !unit->getOwner()) return false;
-    const auto* latestData = unit->getOwner()->getLastUnitData(unit->data.getId());
+    const auto* latestData = std::as_const(*unit->getOwner()).getLastUnitData(unit->data.getId());
     if (!latestData) return false;
     return unit->data.getVersion() < latestData->getVersion();
 }
 
 int GameUnit::get_version() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->data.getVersion();
 }
@@ -685,6 +751,7 @@ int GameUnit::get_version() const {
 // ========== CAPABILITY FLAGS ==========
 
 Dictionary GameUnit::get_capabilities() const {
+    GameModelLock model_lock;
     Dictionary caps;
     if (!unit) return caps;
 
@@ -716,6 +783,7 @@ Dictionary GameUnit::get_capabilities() const {
 // ========== STORED UNITS (CARGO) ==========
 
 Array GameUnit::get_stored_units() const {
+    GameModelLock model_lock;
     Array result;
     if (!unit) return result;
 
@@ -737,6 +805,7 @@ Array GameUnit::get_stored_units() const {
 // ========== PHASE 26: CONSTRUCTION ENHANCEMENTS ==========
 
 Dictionary GameUnit::get_turbo_build_info(String building_type_id) const {
+    GameModelLock model_lock;
     Dictionary result;
     result["turns_0"] = 0; result["cost_0"] = 0;
     result["turns_1"] = 0; result["cost_1"] = 0;
@@ -757,7 +826,7 @@ Dictionary GameUnit::get_turbo_build_info(String building_type_id) const {
     // Get the build cost from the player's latest unit data
     int buildCost = 0;
     if (v->getOwner()) {
-        const auto* lastData = v->getOwner()->getLastUnitData(buildingID);
+        const auto* lastData = std::as_const(*v->getOwner()).getLastUnitData(buildingID);
         if (lastData) buildCost = lastData->getBuildCost();
     }
     if (buildCost <= 0) {
@@ -781,12 +850,14 @@ Dictionary GameUnit::get_turbo_build_info(String building_type_id) const {
 }
 
 bool GameUnit::can_build_path() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return false;
     return v->getStaticUnitData().vehicleData.canBuildPath;
 }
 
 Dictionary GameUnit::get_connection_flags() const {
+    GameModelLock model_lock;
     Dictionary result;
     result["connects_to_base"] = false;
     result["BaseN"] = false;
@@ -815,6 +886,7 @@ Dictionary GameUnit::get_connection_flags() const {
 }
 
 int GameUnit::get_max_build_factor() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return unit->getStaticUnitData().buildingData.maxBuildFactor;
 }
@@ -822,17 +894,20 @@ int GameUnit::get_max_build_factor() const {
 // ========== PHASE 31: ADVANCED UNIT FEATURES ==========
 
 bool GameUnit::is_plane() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->getStaticUnitData().factorAir > 0;
 }
 
 int GameUnit::get_flight_height() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return 0;
     return v->getFlightHeight();
 }
 
 bool GameUnit::can_land() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return false;
     if (v->getStaticUnitData().factorAir <= 0) return false;
@@ -842,27 +917,32 @@ bool GameUnit::can_land() const {
 }
 
 bool GameUnit::is_stealth() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->getStaticUnitData().isStealthOn != 0;
 }
 
 int GameUnit::get_stealth_flags() const {
+    GameModelLock model_lock;
     if (!unit) return 0;
     return static_cast<int>(unit->getStaticUnitData().isStealthOn);
 }
 
 bool GameUnit::can_detect_stealth() const {
+    GameModelLock model_lock;
     if (!unit) return false;
     return unit->getStaticUnitData().canDetectStealthOn != 0;
 }
 
 bool GameUnit::is_rubble() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return false;
     return b->isRubble();
 }
 
 int GameUnit::get_rubble_value() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return 0;
     if (!b->isRubble()) return 0;
@@ -870,6 +950,7 @@ int GameUnit::get_rubble_value() const {
 }
 
 bool GameUnit::is_mine_building() const {
+    GameModelLock model_lock;
     auto* b = as_building();
     if (!b) return false;
     const auto& sd = b->getStaticUnitData();
@@ -879,18 +960,21 @@ bool GameUnit::is_mine_building() const {
 }
 
 bool GameUnit::can_drive_and_fire() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return false;
     return v->getStaticUnitData().vehicleData.canDriveAndFire;
 }
 
 int GameUnit::get_clearing_turns() const {
+    GameModelLock model_lock;
     auto* v = as_vehicle();
     if (!v) return 0;
     return v->getClearingTurns();
 }
 
 bool GameUnit::has_pending_move() const {
+    GameModelLock model_lock;
     // A vehicle has a pending move if it's in a move job with Waiting state
     // We can check this via the unit's getMoveJob() if available
     auto* v = as_vehicle();
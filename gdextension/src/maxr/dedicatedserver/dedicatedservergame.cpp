@@ -0,0 +1,188 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "dedicatedserver/dedicatedservergame.h"
+
+#include "game/connectionmanager.h"
+#include "game/data/player/playerbasicdata.h"
+#include "game/logic/server.h"
+#include "game/startup/lobbyserver.h"
+#include "utility/log.h"
+
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+cDedicatedServerGame::cDedicatedServerGame (int port, std::shared_ptr<const sEngineContext> context, std::chrono::seconds abandonTimeout) :
+	port (port),
+	context (std::move (context)),
+	abandonTimeout (abandonTimeout)
+{}
+
+//------------------------------------------------------------------------------
+cDedicatedServerGame::~cDedicatedServerGame()
+{
+	close();
+}
+
+//------------------------------------------------------------------------------
+bool cDedicatedServerGame::open()
+{
+	close();
+
+	connectionManager = std::make_shared<cConnectionManager>();
+	lobbyServer = std::make_unique<cLobbyServer> (connectionManager, context);
+
+	signalConnectionManager.connect (lobbyServer->onClientConnected, [this] (const cPlayerBasicData& player) {
+		++connectedPlayers;
+		Log.info ("Port " + std::to_string (port) + ": " + player.getName() + " connected");
+	});
+	signalConnectionManager.connect (lobbyServer->onClientDisconnected, [this] (const cPlayerBasicData& player) {
+		connectedPlayers = std::max (0, connectedPlayers - 1);
+		Log.info ("Port " + std::to_string (port) + ": " + player.getName() + " disconnected");
+	});
+	signalConnectionManager.connect (lobbyServer->onStartNewGame, [this] (cServer& newServer) { onGameStarted (newServer); });
+	signalConnectionManager.connect (lobbyServer->onStartSavedGame, [this] (cServer& newServer, const cSaveGameInfo&) { onGameStarted (newServer); });
+
+	if (lobbyServer->startServer (port) != eOpenServerResult::Success)
+	{
+		Log.error ("Could not open port " + std::to_string (port));
+		close();
+		return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void cDedicatedServerGame::close()
+{
+	snapshot.detach();
+	signalConnectionManager.disconnectAll();
+	if (connectionManager)
+	{
+		connectionManager->disconnectAll();
+		connectionManager->closeServer();
+	}
+	// destroys the server and stops its thread
+	lobbyServer.reset();
+	connectionManager.reset();
+	server = nullptr;
+	connectedPlayers = 0;
+	abandonedSince.reset();
+}
+
+//------------------------------------------------------------------------------
+void cDedicatedServerGame::onGameStarted (cServer& newServer)
+{
+	server = &newServer;
+	gameStartTime = std::chrono::steady_clock::now();
+	// the server may already run. tickFinished can be connected from any thread.
+	snapshot.attach (server->getModel());
+	Log.info ("Port " + std::to_string (port) + ": game started");
+}
+
+//------------------------------------------------------------------------------
+void cDedicatedServerGame::run()
+{
+	if (!lobbyServer) return;
+
+	lobbyServer->run();
+
+	if (!server) return;
+	const auto* state = snapshot.acquire();
+	if (!state) return;
+
+	const auto alive = std::ranges::count_if (state->players, [] (const auto& player) { return !player.isDefeated; });
+	if (state->players.size() > 1 && alive <= 1)
+	{
+		Log.info ("Port " + std::to_string (port) + ": game over, reopening lobby");
+		++finishedGames;
+		open();
+		return;
+	}
+
+	// the lobby only counts the players until the game starts. Nobody is defeated,
+	// when all clients leave, so the game would block the slot forever.
+	if (countConnectedPlayers (*state) > 0)
+	{
+		abandonedSince.reset();
+		return;
+	}
+	const auto now = std::chrono::steady_clock::now();
+	if (!abandonedSince)
+	{
+		Log.info ("Port " + std::to_string (port) + ": all players disconnected");
+		abandonedSince = now;
+	}
+	else if (now - *abandonedSince >= abandonTimeout)
+	{
+		Log.info ("Port " + std::to_string (port) + ": game abandoned, reopening lobby");
+		++abandonedGames;
+		open();
+	}
+}
+
+//------------------------------------------------------------------------------
+int cDedicatedServerGame::countConnectedPlayers (const sModelSnapshot& state) const
+{
+	return static_cast<int> (std::ranges::count_if (state.players, [this] (const auto& player) { return connectionManager->isPlayerConnected (player.id); }));
+}
+
+//------------------------------------------------------------------------------
+nlohmann::json cDedicatedServerGame::getStats()
+{
+	nlohmann::json stats;
+	stats["port"] = port;
+	stats["finished_games"] = finishedGames;
+	stats["abandoned_games"] = abandonedGames;
+	stats["connected_players"] = connectedPlayers;
+	if (!lobbyServer)
+	{
+		stats["state"] = "closed";
+		return stats;
+	}
+	const auto* state = server ? snapshot.acquire() : nullptr;
+	if (!state)
+	{
+		stats["state"] = server ? "starting" : "lobby";
+		stats["lobby"] = lobbyServer->getGameState();
+		return stats;
+	}
+
+	stats["connected_players"] = countConnectedPlayers (*state);
+	if (abandonedSince)
+	{
+		const auto abandonedSeconds = std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now() - *abandonedSince);
+		stats["state"] = "abandoned";
+		stats["abandoned_seconds"] = abandonedSeconds.count();
+		stats["reopen_in_seconds"] = std::max<std::chrono::seconds::rep> (0, (abandonTimeout - abandonedSeconds).count());
+	}
+	else
+		stats["state"] = "running";
+	stats["turn"] = state->turn;
+	stats["game_time"] = state->gameTime;
+	stats["running_seconds"] = std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now() - gameStartTime).count();
+	auto& players = stats["players"];
+	players = nlohmann::json::array();
+	for (const auto& player : state->players)
+	{
+		const auto units = std::ranges::count_if (state->units, [&] (const auto& unit) { return unit.playerId == player.id; });
+		players.push_back ({{"id", player.id}, {"name", player.name}, {"credits", player.credits}, {"units", units}, {"finished_turn", player.hasFinishedTurn}, {"defeated", player.isDefeated}});
+	}
+	return stats;
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef dedicatedserver_dedicatedservergameH
+#define dedicatedserver_dedicatedservergameH
+
+#include "game/enginecontext.h"
+#include "game/logic/modelsnapshot.h"
+#include "utility/signal/signalconnectionmanager.h"
+
+#include <chrono>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+
+class cConnectionManager;
+class cLobbyServer;
+class cServer;
+
+/**
+ * One game slot of the dedicated server: a lobby listening on its own port,
+ * and the game started from it. Remote clients choose map and settings in the
+ * lobby, as there is no local host player. The server autosaves according
+ * to the context. When the game is over, or no player has been connected
+ * for the abandon timeout, the slot opens a new lobby on the same port.
+ * All functions must be called from the same (main) thread.
+ */
+class cDedicatedServerGame
+{
+public:
+	cDedicatedServerGame (int port, std::shared_ptr<const sEngineContext>, std::chrono::seconds abandonTimeout);
+	~cDedicatedServerGame();
+
+	cDedicatedServerGame (const cDedicatedServerGame&) = delete;
+	cDedicatedServerGame& operator= (const cDedicatedServerGame&) = delete;
+
+	/** Opens the lobby. Returns false, when the port could not be opened. */
+	bool open();
+
+	/**
+	 * Handles the lobby messages and reopens the lobby after the game has ended
+	 * or has been abandoned by all players.
+	 */
+	void run();
+
+	nlohmann::json getStats();
+
+	int getPort() const { return port; }
+
+private:
+	void close();
+	void onGameStarted (cServer&);
+	int countConnectedPlayers (const sModelSnapshot&) const;
+
+private:
+	const int port;
+	const std::shared_ptr<const sEngineContext> context;
+	const std::chrono::seconds abandonTimeout;
+
+	std::shared_ptr<cConnectionManager> connectionManager;
+	std::unique_ptr<cLobbyServer> lobbyServer;
+	cServer* server = nullptr;
+	cModelSnapshotPublisher snapshot;
+	cSignalConnectionManager signalConnectionManager;
+
+	int connectedPlayers = 0;
+	int finishedGames = 0;
+	int abandonedGames = 0;
+	std::chrono::steady_clock::time_point gameStartTime;
+	std::optional<std::chrono::steady_clock::time_point> abandonedSince; // no player connected since then
+};
+
+#endif // dedicatedserver_dedicatedservergameH
@@ -0,0 +1,221 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/*
+ * Headless dedicated server. Runs one or more games without Godot:
+ * maxtreme_server --data <dir> [--saves <dir>] [--port <port>] [--games <n>]
+ *                 [--threads <n>] [--stats <socket path>] [--autosave-slot <slot>]
+ *                 [--history-budget <MiB>] [--abandon-timeout <s>]
+ *                 [--log <file>] [--legacy-checksums] [--quiet]
+ */
+
+#include "dedicatedserver/dedicatedservergame.h"
+#include "dedicatedserver/statssocket.h"
+#include "game/logic/serverpool.h"
+#include "resources/loaddata.h"
+#include "settings.h"
+#include "utility/crc.h"
+#include "utility/log.h"
+#include "utility/thread/parallelfor.h"
+
+#include <SDL.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+	std::atomic<bool> quitRequested = false;
+
+	//--------------------------------------------------------------------------
+	void onQuitSignal (int)
+	{
+		quitRequested = true;
+	}
+
+	//--------------------------------------------------------------------------
+	struct sOptions
+	{
+		std::filesystem::path dataDir = "data";
+		std::filesystem::path savesDir = "saves";
+		std::filesystem::path replaysDir;
+		std::filesystem::path statsPath = "maxtreme_server.sock";
+		std::filesystem::path logPath;
+		int port = 58600;
+		int games = 1;
+		int threads = 0;
+		int autosaveSlot = 10;
+		int historyBudget = 0;
+		int abandonTimeout = 300;
+		bool legacyCheckSums = false;
+		bool quiet = false;
+	};
+
+	//--------------------------------------------------------------------------
+	void printUsage (const char* name)
+	{
+		std::cout << "Usage: " << name << " [options]\n"
+				  << "  --data <dir>            game data directory (default: data)\n"
+				  << "  --saves <dir>           save game directory, one sub directory per game (default: saves)\n"
+				  << "  --replays <dir>         record replays, one sub directory per game (default: no replays)\n"
+				  << "  --port <port>           port of the first game (default: 58600)\n"
+				  << "  --games <n>             number of games, on consecutive ports (default: 1)\n"
+				  << "  --threads <n>           threads running the games (default: one per core)\n"
+				  << "  --stats <path>          unix socket for stats (default: maxtreme_server.sock)\n"
+				  << "  --autosave-slot <slot>  autosave slot of every game (default: 10)\n"
+				  << "  --history-budget <MiB>  model history per game, to diagnose desyncs of the clients (default: 0, none)\n"
+				  << "  --abandon-timeout <s>   reopen the lobby, when no player was connected for this long (default: 300)\n"
+				  << "  --log <file>            log file\n"
+				  << "  --legacy-checksums      checksum algorithm of older versions, to let their clients join\n"
+				  << "  --quiet                 no debug output\n";
+	}
+
+	//--------------------------------------------------------------------------
+	bool parseOptions (int argc, char* argv[], sOptions& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+
+			try
+			{
+				if (arg == "--quiet") options.quiet = true;
+				else if (arg == "--legacy-checksums") options.legacyCheckSums = true;
+				else if (arg == "--data" && hasValue) options.dataDir = argv[++i];
+				else if (arg == "--saves" && hasValue) options.savesDir = argv[++i];
+				else if (arg == "--replays" && hasValue) options.replaysDir = argv[++i];
+				else if (arg == "--stats" && hasValue) options.statsPath = argv[++i];
+				else if (arg == "--log" && hasValue) options.logPath = argv[++i];
+				else if (arg == "--port" && hasValue) options.port = std::stoi (argv[++i]);
+				else if (arg == "--games" && hasValue) options.games = std::stoi (argv[++i]);
+				else if (arg == "--threads" && hasValue) options.threads = std::stoi (argv[++i]);
+				else if (arg == "--autosave-slot" && hasValue) options.autosaveSlot = std::stoi (argv[++i]);
+				else if (arg == "--history-budget" && hasValue) options.historyBudget = std::stoi (argv[++i]);
+				else if (arg == "--abandon-timeout" && hasValue) options.abandonTimeout = std::stoi (argv[++i]);
+				else return false;
+			}
+			catch (const std::exception&)
+			{
+				return false;
+			}
+		}
+		return options.games > 0 && options.threads >= 0 && options.historyBudget >= 0 && options.abandonTimeout >= 0 && options.port > 0 && options.port + options.games <= 65536;
+	}
+
+	//--------------------------------------------------------------------------
+	long getResidentMemoryKB()
+	{
+		std::ifstream statm ("/proc/self/statm");
+		long size = 0;
+		long resident = 0;
+		if (!(statm >> size >> resident)) return 0;
+		return resident * (sysconf (_SC_PAGESIZE) / 1024);
+	}
+} // namespace
+
+//------------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+	sOptions options;
+	if (!parseOptions (argc, argv, options))
+	{
+		printUsage (argv[0]);
+		return 1;
+	}
+
+	if (!options.logPath.empty())
+	{
+		Log.setLogPath (options.logPath);
+		NetLog.setLogPath (options.logPath.string() + ".net");
+	}
+	Log.showDebug (!options.quiet);
+	NetLog.showDebug (!options.quiet);
+
+	// before any checksum is calculated and cached
+	setCheckSumAlgorithm (options.legacyCheckSums ? eCheckSumAlgorithm::Legacy : eCheckSumAlgorithm::Crc32c);
+
+	auto& settings = cSettings::getInstance();
+	settings.setDataDir (options.dataDir);
+	settings.setSavesPath (options.savesDir);
+	std::error_code ec;
+	std::filesystem::create_directories (options.savesDir, ec);
+
+	if (LoadData (false) != eLoadingState::Finished)
+	{
+		std::cerr << "Could not load the game data from " << options.dataDir << "\n";
+		return 1;
+	}
+
+	// all games share the units data and the threads
+	const auto sharedContext = sEngineContext::fromSettings();
+	const std::size_t threads = options.threads > 0 ? options.threads : std::min<std::size_t> (options.games, getParallelWorkerCount());
+	const auto serverPool = std::make_shared<cServerPool> (threads);
+
+	std::vector<std::unique_ptr<cDedicatedServerGame>> games;
+	for (int i = 0; i < options.games; ++i)
+	{
+		// each game gets its own save directory
+		auto context = std::make_shared<sEngineContext> (*sharedContext);
+		context->savesPath = options.savesDir / std::to_string (options.port + i);
+		if (!options.replaysDir.empty()) context->replaysPath = options.replaysDir / std::to_string (options.port + i);
+		context->autosaveSlot = options.autosaveSlot;
+		context->modelHistoryBudget = static_cast<std::size_t> (options.historyBudget) * 1024 * 1024;
+		context->serverPool = serverPool;
+
+		games.push_back (std::make_unique<cDedicatedServerGame> (options.port + i, std::move (context), std::chrono::seconds (options.abandonTimeout)));
+		if (!games.back()->open()) return 1;
+	}
+
+	cStatsSocket stats;
+	stats.open (options.statsPath);
+
+	std::signal (SIGINT, onQuitSignal);
+	std::signal (SIGTERM, onQuitSignal);
+	std::cout << "Dedicated server running " << options.games << " game(s) from port " << options.port << " on " << threads << " thread(s)" << std::endl;
+
+	while (!quitRequested)
+	{
+		for (auto& game : games)
+			game->run();
+
+		stats.poll ([&]() {
+			nlohmann::json json;
+			json["resident_memory_kb"] = getResidentMemoryKB();
+			auto& gamesJson = json["games"];
+			gamesJson = nlohmann::json::array();
+			for (auto& game : games)
+				gamesJson.push_back (game->getStats());
+			return json.dump();
+		});
+
+		SDL_Delay (10);
+	}
+
+	std::cout << "Shutting down" << std::endl;
+	games.clear();
+	return 0;
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "dedicatedserver/statssocket.h"
+
+#include "utility/log.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+cStatsSocket::~cStatsSocket()
+{
+	close();
+}
+
+//------------------------------------------------------------------------------
+bool cStatsSocket::open (const std::filesystem::path& socketPath)
+{
+	close();
+
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	const auto pathString = socketPath.string();
+	if (pathString.size() >= sizeof (address.sun_path))
+	{
+		Log.error ("Stats socket path too long: " + pathString);
+		return false;
+	}
+	std::memcpy (address.sun_path, pathString.c_str(), pathString.size() + 1);
+
+	fd = ::socket (AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		Log.error ("Could not create stats socket");
+		return false;
+	}
+	// remove a stale socket of a previous run
+	std::error_code ec;
+	std::filesystem::remove (socketPath, ec);
+	if (::bind (fd, reinterpret_cast<const sockaddr*> (&address), sizeof (address)) != 0 || ::listen (fd, 8) != 0)
+	{
+		Log.error ("Could not open stats socket " + pathString + ": " + std::strerror (errno));
+		::close (fd);
+		fd = -1;
+		return false;
+	}
+	::fcntl (fd, F_SETFL, ::fcntl (fd, F_GETFL) | O_NONBLOCK);
+	path = socketPath;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void cStatsSocket::close()
+{
+	if (fd < 0) return;
+
+	::close (fd);
+	fd = -1;
+	std::error_code ec;
+	std::filesystem::remove (path, ec);
+	path.clear();
+}
+
+//------------------------------------------------------------------------------
+void cStatsSocket::poll (const std::function<std::string()>& getStats)
+{
+	if (fd < 0) return;
+
+	while (true)
+	{
+		const int client = ::accept (fd, nullptr, nullptr);
+		if (client < 0) return;
+
+		const auto text = getStats() + "\n";
+		std::size_t written = 0;
+		while (written < text.size())
+		{
+			const auto n = ::send (client, text.data() + written, text.size() - written, MSG_NOSIGNAL);
+			if (n <= 0) break;
+			written += n;
+		}
+		::close (client);
+	}
+}
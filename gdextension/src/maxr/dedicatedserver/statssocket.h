@@ -0,0 +1,55 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef dedicatedserver_statssocketH
+#define dedicatedserver_statssocketH
+
+#include <filesystem>
+#include <functional>
+#include <string>
+
+/**
+ * Local unix domain socket for monitoring the dedicated server.
+ * Each client, that connects, gets the current stats as one json document,
+ * then the connection is closed. E.g.: socat - UNIX-CONNECT:maxtreme_server.sock
+ */
+class cStatsSocket
+{
+public:
+	cStatsSocket() = default;
+	~cStatsSocket();
+
+	cStatsSocket (const cStatsSocket&) = delete;
+	cStatsSocket& operator= (const cStatsSocket&) = delete;
+
+	bool open (const std::filesystem::path&);
+	void close();
+
+	/**
+	 * Answers all pending connections with the text returned by getStats.
+	 * Does not block. getStats is only called, when there is a connection.
+	 */
+	void poll (const std::function<std::string()>& getStats);
+
+private:
+	std::filesystem::path path;
+	int fd = -1;
+};
+
+#endif // dedicatedserver_statssocketH
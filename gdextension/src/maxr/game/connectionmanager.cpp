@@ -24,6 +24,7 @@
 #include "game/network.h"
 #include "game/protocol/netmessage.h"
 #include "maxrversion.h"
+#include "utility/crc.h"
 #include "utility/log.h"
 
 #include <mutex>
@@ -497,7 +498,7 @@ bool cConnectionManager::handleConnectionHandshake (const std::unique_ptr<cNetMe
 
 			//check compatible game version
 			const auto& msgTcpHello = static_cast<cNetMessageTcpHello&> (*message);
-			if (msgTcpHello.packageVersion != PACKAGE_VERSION)
+			if (msgTcpHello.packageVersion != PACKAGE_VERSION || msgTcpHello.checkSumAlgorithm != getCheckSumAlgorithm())
 			{
 				network->close (socket);
 			}
@@ -531,6 +532,13 @@ bool cConnectionManager::handleConnectionHandshake (const std::unique_ptr<cNetMe
 				network->close (socket);
 				return true;
 			}
+			// the model checksums of the game would never match
+			if (msgTcpWantConnect.checkSumAlgorithm != getCheckSumAlgorithm())
+			{
+				NetLog.warn ("ConnectionManager: Client uses a different checksum algorithm");
+				declineConnection (socket, eDeclineConnectionReason::DifferentCheckSumAlgorithm);
+				return true;
+			}
 			break;
 		}
 		case eNetMessageType::TCP_CONNECTED:
@@ -47,7 +47,8 @@ enum class eDeclineConnectionReason
 {
 	NotPartOfTheGame,
 	AlreadyConnected,
-	Other
+	Other,
+	DifferentCheckSumAlgorithm
 };
 
 class cConnectionManager
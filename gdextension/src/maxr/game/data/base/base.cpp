@@ -26,6 +26,8 @@
 #include "utility/crc.h"
 #include "utility/listhelpers.h"
 
+#include <unordered_map>
+
 namespace
 {
 
@@ -76,6 +78,22 @@ namespace
 		return {pos.relative (0, -1), pos.relative (1, 0), pos.relative (0, 1), pos.relative (-1, 0)};
 	}
 
+	//--------------------------------------------------------------------------
+	template <typename F>
+	void forEachNeighbourInSubBase (const cBuilding& building, const cSubBase& subBase, const cMap& map, F&& f)
+	{
+		for (const auto& position : getSurroundingPositions (building.getPosition(), building.getIsBig()))
+		{
+			if (!map.isValidPosition (position)) continue;
+			cBuilding* neighbour = map.getField (position).getBuilding();
+
+			if (neighbour && neighbour != &building && neighbour->subBase == &subBase)
+			{
+				f (*neighbour);
+			}
+		}
+	}
+
 } // namespace
 
 //------------------------------------------------------------------------------
@@ -715,21 +733,62 @@ void cSubBase::addBuilding (cBuilding& b)
 	buildings.push_back (&b);
 	b.subBase = this;
 
+	const sMiningResource oldStored = stored;
+	addToTotals (b);
+
+	if (stored.metal != oldStored.metal) metalChanged();
+	if (stored.oil != oldStored.oil) oilChanged();
+	if (stored.gold != oldStored.gold) goldChanged();
+}
+
+//------------------------------------------------------------------------------
+void cSubBase::removeDetachedBuildings()
+{
+	std::erase_if (buildings, [this] (const cBuilding* building) { return building->subBase != this; });
+
+	const sMiningResource oldStored = stored;
+
+	stored = sMiningResource();
+	maxStored = sMiningResource();
+	needed = sMiningResource();
+	maxNeeded = sMiningResource();
+	prod = sMiningResource();
+	maxEnergyProd = 0;
+	energyProd = 0;
+	maxEnergyNeed = 0;
+	energyNeed = 0;
+	humanProd = 0;
+	humanNeed = 0;
+	maxHumanNeed = 0;
+
+	for (const cBuilding* building : buildings)
+	{
+		addToTotals (*building);
+	}
+
+	if (stored.metal != oldStored.metal) metalChanged();
+	if (stored.oil != oldStored.oil) oilChanged();
+	if (stored.gold != oldStored.gold) goldChanged();
+}
+
+//------------------------------------------------------------------------------
+void cSubBase::addToTotals (const cBuilding& b)
+{
 	const cStaticUnitData& staticUnitData = b.getStaticUnitData();
 	// calculate storage level
 	switch (staticUnitData.storeResType)
 	{
 		case eResourceType::Metal:
 			maxStored.metal += staticUnitData.storageResMax;
-			setMetal (stored.metal + b.getStoredResources());
+			stored.metal += b.getStoredResources();
 			break;
 		case eResourceType::Oil:
 			maxStored.oil += staticUnitData.storageResMax;
-			setOil (stored.oil + b.getStoredResources());
+			stored.oil += b.getStoredResources();
 			break;
 		case eResourceType::Gold:
 			maxStored.gold += staticUnitData.storageResMax;
-			setGold (stored.gold + b.getStoredResources());
+			stored.gold += b.getStoredResources();
 			break;
 		case eResourceType::None:
 			break;
@@ -1044,19 +1103,132 @@ void cBase::deleteBuilding (cBuilding& building, const cMap& map)
 {
 	if (!building.getStaticData().connectsToBase) return;
 
-	auto buildings = building.subBase->getBuildings();
-	std::erase_if (SubBases, ByGetTo (building.subBase));
+	cSubBase& subBase = *building.subBase;
+	building.subBase = nullptr;
 
-	// add all the buildings again
-	for (auto b : buildings)
+	std::vector<cBuilding*> changedBuildings = splitSubBase (subBase, building, map);
+	changedBuildings.push_back (&building);
+
+	subBase.removeDetachedBuildings();
+	if (subBase.getBuildings().empty())
 	{
-		if (b == &building) continue;
-		addBuilding (*b, map, false);
+		std::erase_if (SubBases, ByGetTo (&subBase));
 	}
 
 	if (building.isUnitWorking() && building.getStaticData().canResearch && building.getOwner())
 		building.getOwner()->stopAResearch (building.getResearchArea());
-	onSubbaseConfigurationChanged (buildings);
+	onSubbaseConfigurationChanged (changedBuildings);
+}
+
+//------------------------------------------------------------------------------
+std::vector<cBuilding*> cBase::splitSubBase (cSubBase& subBase, const cBuilding& deletedBuilding, const cMap& map)
+{
+	// each remaining neighbour of the deleted building starts a search
+	std::vector<cBuilding*> seeds;
+	forEachNeighbourInSubBase (deletedBuilding, subBase, map, [&] (cBuilding& neighbour) { seeds.push_back (&neighbour); });
+	RemoveDuplicates (seeds);
+
+	for (cBuilding* seed : seeds)
+	{
+		seed->CheckNeighbours (map);
+	}
+	if (seeds.size() < 2) return {};
+
+	// Run the searches interleaved. When two searches meet, they are united.
+	// As soon as at most one search has unexplored buildings left,
+	// all other searches have found a complete, separated part of the subbase.
+	// So only the separated parts are explored completely,
+	// and the biggest part usually stays untouched.
+	struct sSearch
+	{
+		std::vector<cBuilding*> open;
+		std::size_t parent = 0;
+		std::size_t size = 1;
+	};
+	std::vector<sSearch> searches (seeds.size());
+	std::unordered_map<const cBuilding*, std::size_t> labels;
+	for (std::size_t i = 0; i != seeds.size(); ++i)
+	{
+		searches[i].open.push_back (seeds[i]);
+		searches[i].parent = i;
+		labels.emplace (seeds[i], i);
+	}
+	const auto findRoot = [&] (std::size_t i) {
+		while (searches[i].parent != i)
+		{
+			searches[i].parent = searches[searches[i].parent].parent;
+			i = searches[i].parent;
+		}
+		return i;
+	};
+	const auto countActive = [&]() {
+		std::size_t active = 0;
+		for (std::size_t i = 0; i != searches.size(); ++i)
+		{
+			if (searches[i].parent == i && !searches[i].open.empty()) ++active;
+		}
+		return active;
+	};
+
+	while (countActive() > 1)
+	{
+		for (std::size_t i = 0; i != searches.size(); ++i)
+		{
+			if (searches[i].parent != i || searches[i].open.empty()) continue;
+
+			cBuilding* current = searches[i].open.back();
+			searches[i].open.pop_back();
+			forEachNeighbourInSubBase (*current, subBase, map, [&] (cBuilding& neighbour) {
+				const auto [it, inserted] = labels.emplace (&neighbour, i);
+				if (inserted)
+				{
+					searches[i].open.push_back (&neighbour);
+					++searches[i].size;
+					return;
+				}
+				const std::size_t other = findRoot (it->second);
+				if (other == i) return;
+
+				searches[other].parent = i;
+				searches[i].size += searches[other].size;
+				searches[i].open.insert (searches[i].open.end(), searches[other].open.begin(), searches[other].open.end());
+				searches[other].open.clear();
+			});
+		}
+	}
+
+	// keep the unfinished part in the existing subbase, or otherwise the biggest one
+	std::size_t kept = searches.size();
+	for (std::size_t i = 0; i != searches.size(); ++i)
+	{
+		if (searches[i].parent != i) continue;
+		if (!searches[i].open.empty())
+		{
+			kept = i;
+			break;
+		}
+		if (kept == searches.size() || searches[i].size > searches[kept].size) kept = i;
+	}
+
+	// move all other parts to new subbases, keeping the order of the buildings
+	std::vector<cSubBase*> newSubBases (searches.size(), nullptr);
+	std::vector<cBuilding*> movedBuildings;
+	for (cBuilding* building : subBase.getBuildings())
+	{
+		const auto it = labels.find (building);
+		if (it == labels.end()) continue;
+		const std::size_t root = findRoot (it->second);
+		if (root == kept) continue;
+
+		if (newSubBases[root] == nullptr)
+		{
+			SubBases.push_back (std::make_unique<cSubBase> (*this));
+			newSubBases[root] = SubBases.back().get();
+		}
+		newSubBases[root]->addBuilding (*building);
+		movedBuildings.push_back (building);
+	}
+	return movedBuildings;
 }
 
 //------------------------------------------------------------------------------
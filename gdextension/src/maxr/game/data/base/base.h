@@ -48,6 +48,12 @@ public:
 	void merge (cSubBase&);
 
 	void addBuilding (cBuilding&);
+	/**
+	* removes all buildings, that have been moved to another subbase
+	* (or have been detached from any subbase) and recalculates the totals
+	* of the remaining buildings
+	*/
+	void removeDetachedBuildings();
 
 	bool startBuilding (cBuilding&);
 	bool stopBuilding (cBuilding&, bool forced = false);
@@ -160,6 +166,12 @@ private:
 	void setOil (int value);
 	void setGold (int value);
 
+	/**
+	* adds the storage, energy, resource and human values
+	* of the building to the totals of the subbase without signaling
+	*/
+	void addToTotals (const cBuilding&);
+
 private:
 	std::vector<cBuilding*> buildings;
 
@@ -238,6 +250,13 @@ public:
 
 private:
 	void addBuilding (cBuilding&, const cMap&, bool signalChange);
+	/**
+	* splits the subbase, which lost the given building, into its remaining
+	* connected parts. Only the parts, that are separated from the rest are
+	* explored and moved to new subbases.
+	* @return the buildings, that have been moved to a new subbase
+	*/
+	std::vector<cBuilding*> splitSubBase (cSubBase&, const cBuilding& deletedBuilding, const cMap&);
 
 public:
 	std::vector<std::unique_ptr<cSubBase>> SubBases;
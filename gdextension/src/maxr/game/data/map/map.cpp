@@ -19,8 +19,6 @@
 
 #include "map.h"
 
-#include <SDL.h>  // MaXtreme: for SDL_RWops stubs
-
 #include "game/data/map/mapfieldview.h"
 #include "game/data/player/player.h"
 #include "game/data/units/building.h"
@@ -30,6 +28,7 @@
 #include "utility/crc.h"
 #include "utility/listhelpers.h"
 #include "utility/log.h"
+#include "utility/mappedfile.h"
 #include "utility/narrow_cast.h"
 #include "utility/position.h"
 #include "utility/ranges.h"
@@ -37,6 +36,7 @@
 #include "utility/string/utf-8.h"
 
 #include <cassert>
+#include <mutex>
 
 static constexpr int MAX_PLANES_PER_FIELD = 5;
 
@@ -368,130 +368,114 @@ std::vector<cPosition> cStaticMap::collectAroundPositions (const cPosition& posi
 bool cStaticMap::loadMap (const std::filesystem::path& filename_)
 {
 	clear();
-	// Open File
-	filename = filename_;
 	Log.debug ("Loading map \"" + utf8::to_string (filename_) + "\"");
 
-	// first try in the factory maps directory
-	auto fullFilename = cSettings::getInstance().getMapsPath() / filename;
-	SDL_RWops* fpMapFile = SDL_RWFromFile (utf8::to_string (fullFilename).c_str(), "rb");
-	if (fpMapFile == nullptr)
+	// first try in the factory maps directory, then in the user's map directory
+	const auto fullFilename = MapDownload::getExistingMapFilePath (filename_);
+	cMappedFile file;
+	if (fullFilename.empty() || !file.open (fullFilename))
 	{
-		// now try in the user's map directory
-		auto userMapsDir = cSettings::getInstance().getUserMapsDir();
-		if (!userMapsDir.empty())
-		{
-			fullFilename = userMapsDir / filename;
-			fpMapFile = SDL_RWFromFile (utf8::to_string (fullFilename).c_str(), "rb");
-		}
+		Log.warn ("Cannot load map file: \"" + utf8::to_string (filename_) + "\"");
+		return false;
 	}
-	if (fpMapFile == nullptr)
-	{
-		Log.warn ("Cannot load map file: \"" + utf8::to_string (filename) + "\"");
+	const auto content = file.getData();
+	return loadMap (filename_, content, MapDownload::calculateCheckSum (content));
+}
+
+//------------------------------------------------------------------------------
+/**
+* Parses the content of a map file.
+* Only the header, the tile index array and the terrain type infos are read.
+* Mini map, terrain graphics and palette are skipped,
+* as the graphics are handled by the renderer.
+*/
+bool cStaticMap::loadMap (const std::filesystem::path& filename_, std::span<const unsigned char> content, uint32_t fileCrc)
+{
+	clear();
+	filename = filename_;
+
+	const auto readLE16 = [&] (std::size_t offset) {
+		return static_cast<int> (content[offset] | (content[offset + 1] << 8));
+	};
+	const auto fail = [this] (const std::string& message) {
+		Log.warn (message + ": \"" + utf8::to_string (filename) + "\"");
 		clear();
 		return false;
-	}
-	char szFileTyp[4];
+	};
 
 	// check for typ
-	SDL_RWread (fpMapFile, &szFileTyp, 1, 3);
-	szFileTyp[3] = '\0';
 	// WRL - interplays original mapformat
 	// WRX - mapformat from russian mapeditor
 	// DMO - for some reason some original maps have this filetype
-	if (strcmp (szFileTyp, "WRL") != 0 && strcmp (szFileTyp, "WRX") != 0 && strcmp (szFileTyp, "DMO") != 0)
-	{
-		Log.warn ("Wrong file format: \"" + utf8::to_string (filename) + "\"");
-		SDL_RWclose (fpMapFile);
-		clear();
-		return false;
-	}
-	SDL_RWseek (fpMapFile, 2, SEEK_CUR);
+	const std::size_t headerSize = 9;
+	if (content.size() < headerSize) return fail ("Wrong file format");
+	const std::string_view fileType (reinterpret_cast<const char*> (content.data()), 3);
+	if (fileType != "WRL" && fileType != "WRX" && fileType != "DMO") return fail ("Wrong file format");
 
 	// Read informations and get positions from the map-file
-	const Sint64 sWidth = SDL_ReadLE16 (fpMapFile);
-	Log.debug ("SizeX: " + std::to_string (sWidth));
-	const Sint64 sHeight = SDL_ReadLE16 (fpMapFile);
-	Log.debug ("SizeY: " + std::to_string (sHeight));
-	SDL_RWseek (fpMapFile, sWidth * sHeight, SEEK_CUR); // Ignore Mini-Map
-	const Sint64 iDataPos = SDL_RWtell (fpMapFile); // Map-Data
-	SDL_RWseek (fpMapFile, sWidth * sHeight * 2, SEEK_CUR);
-	const Sint64 iNumberOfTerrains = SDL_ReadLE16 (fpMapFile); // Read PicCount
-	Log.debug ("Number of terrains: " + std::to_string (iNumberOfTerrains));
-	const Sint64 iGraphicsPos = SDL_RWtell (fpMapFile); // Terrain Graphics
-	const Sint64 iPalettePos = iGraphicsPos + iNumberOfTerrains * 64 * 64; // Palette
-	const Sint64 iInfoPos = iPalettePos + 256 * 3; // Special informations
-
-	if (sWidth != sHeight)
-	{
-		Log.warn ("Map must be quadratic!: \"" + utf8::to_string (filename) + "\"");
-		SDL_RWclose (fpMapFile);
-		clear();
-		return false;
-	}
+	const int width = readLE16 (5);
+	Log.debug ("SizeX: " + std::to_string (width));
+	const int height = readLE16 (7);
+	Log.debug ("SizeY: " + std::to_string (height));
+
+	if (width != height) return fail ("Map must be quadratic!");
+
+	const std::size_t fieldCount = static_cast<std::size_t> (width) * height;
+	const std::size_t dataPos = headerSize + fieldCount; // Map-Data, after the mini map
+	const std::size_t terrainCountPos = dataPos + fieldCount * 2;
+	if (content.size() < terrainCountPos + 2) return fail ("Map file is truncated");
+
+	const int numberOfTerrains = readLE16 (terrainCountPos);
+	Log.debug ("Number of terrains: " + std::to_string (numberOfTerrains));
+	const std::size_t graphicsPos = terrainCountPos + 2; // Terrain Graphics
+	const std::size_t palettePos = graphicsPos + static_cast<std::size_t> (numberOfTerrains) * 64 * 64;
+	const std::size_t infoPos = palettePos + 256 * 3; // Special informations
+	if (content.size() < infoPos + numberOfTerrains) return fail ("Map file is truncated");
 
 	// Generate new Map
-	this->size = std::max<int> (16, narrow_cast<int> (sWidth));
-	Kacheln.resize (size * size, 0);
-	terrains.resize (narrow_cast<std::size_t> (iNumberOfTerrains));
+	size = std::max (16, width);
+	const std::size_t tileCount = static_cast<std::size_t> (size) * size;
+	if (content.size() < dataPos + tileCount * 2) return fail ("Map file is truncated");
 
-	graphic.loadPalette (fpMapFile, narrow_cast<std::size_t> (iPalettePos), narrow_cast<std::size_t> (iNumberOfTerrains));
-	// Load necessary Terrain Graphics
-	for (int iNum = 0; iNum < iNumberOfTerrains; iNum++)
+	terrains.resize (numberOfTerrains);
+	for (int i = 0; i < numberOfTerrains; ++i)
 	{
-		unsigned char cByte; // one Byte
-		// load terrain type info
-		SDL_RWseek (fpMapFile, iInfoPos + iNum, SEEK_SET);
-		SDL_RWread (fpMapFile, &cByte, 1, 1);
-
-		switch (cByte)
+		const unsigned char terrainType = content[infoPos + i];
+		switch (terrainType)
 		{
 			case 0:
 				//normal terrain without special property
 				break;
 			case 1:
-				terrains[iNum].water = true;
+				terrains[i].water = true;
 				break;
 			case 2:
-				terrains[iNum].coast = true;
+				terrains[i].coast = true;
 				break;
 			case 3:
-				terrains[iNum].blocked = true;
+				terrains[i].blocked = true;
 				break;
 			default:
-				Log.warn ("unknown terrain type " + std::to_string (cByte) + " on tile " + std::to_string (iNum) + " found. Handled as blocked!");
-				terrains[iNum].blocked = true;
-				//SDL_RWclose (fpMapFile);
-				//return false;
-		}
-		if (!graphic.loadTile (fpMapFile, narrow_cast<std::size_t> (iGraphicsPos), iNum))
-		{
-			clear();
-			return false;
+				Log.warn ("unknown terrain type " + std::to_string (terrainType) + " on tile " + std::to_string (i) + " found. Handled as blocked!");
+				terrains[i].blocked = true;
 		}
 	}
 
 	// Load map data
-	SDL_RWseek (fpMapFile, iDataPos, SEEK_SET);
-	for (int iY = 0; iY < size; iY++)
+	Kacheln.resize (tileCount);
+	const unsigned char* tileData = content.data() + dataPos;
+	for (std::size_t i = 0; i != tileCount; ++i)
 	{
-		for (int iX = 0; iX < size; iX++)
-		{
-			int Kachel = SDL_ReadLE16 (fpMapFile);
-			if (Kachel >= iNumberOfTerrains)
-			{
-				Log.warn ("a map field referred to a nonexisting terrain: " + std::to_string (Kachel));
-				SDL_RWclose (fpMapFile);
-				clear();
-				return false;
-			}
-			Kacheln[iY * size + iX] = Kachel;
-		}
+		Kacheln[i] = static_cast<uint16_t> (tileData[2 * i] | (tileData[2 * i + 1] << 8));
+	}
+	const auto maxTile = std::ranges::max_element (Kacheln);
+	if (maxTile != Kacheln.end() && *maxTile >= numberOfTerrains)
+	{
+		return fail ("a map field referred to a nonexisting terrain: " + std::to_string (*maxTile));
 	}
-	SDL_RWclose (fpMapFile);
 
 	//save crc, to check map file equality when loading a game
-	crc = MapDownload::calculateCheckSum (filename);
+	crc = fileCrc;
 	return true;
 }
 
@@ -501,6 +485,57 @@ uint32_t cStaticMap::getChecksum (uint32_t crc) const
 	return calcCheckSum (this->crc, crc);
 }
 
+// cStaticMapCache //////////////////////////////////////////////////
+
+namespace
+{
+	std::mutex staticMapCacheMutex;
+	std::vector<std::shared_ptr<cStaticMap>> staticMapCache;
+} // namespace
+
+//------------------------------------------------------------------------------
+std::shared_ptr<cStaticMap> cStaticMapCache::get (const std::filesystem::path& filename)
+{
+	const auto fullFilename = MapDownload::getExistingMapFilePath (filename);
+	cMappedFile file;
+	if (fullFilename.empty() || !file.open (fullFilename))
+	{
+		Log.warn ("Cannot load map file: \"" + utf8::to_string (filename) + "\"");
+		return nullptr;
+	}
+	const auto content = file.getData();
+	const auto crc = MapDownload::calculateCheckSum (content);
+
+	std::unique_lock<std::mutex> lock (staticMapCacheMutex);
+	auto it = std::ranges::find_if (staticMapCache, [&] (const auto& map) { return map->getFilename() == filename; });
+	if (it != staticMapCache.end())
+	{
+		if ((*it)->getFileCrc() == crc)
+		{
+			NetLog.debug ("Static map \"" + utf8::to_string (filename) + "\" taken from cache");
+			return *it;
+		}
+		// the file has been changed on disk
+		staticMapCache.erase (it);
+	}
+
+	auto staticMap = std::make_shared<cStaticMap>();
+	Log.debug ("Loading map \"" + utf8::to_string (filename) + "\"");
+	if (!staticMap->loadMap (filename, content, crc))
+	{
+		return nullptr;
+	}
+	staticMapCache.push_back (staticMap);
+	return staticMap;
+}
+
+//------------------------------------------------------------------------------
+void cStaticMapCache::clear()
+{
+	std::unique_lock<std::mutex> lock (staticMapCacheMutex);
+	staticMapCache.clear();
+}
+
 // Funktionen der Map-Klasse /////////////////////////////////////////////////
 //------------------------------------------------------------------------------
 cMap::cMap (std::shared_ptr<cStaticMap> staticMap_) :
@@ -626,7 +661,7 @@ void cMap::addVehicle (cVehicle& vehicle)
 	{
 		const auto targetPosition = vehicle.getPosition();
 		vehicle.setPosition (*vehicle.buildBigSavedPosition);
-		vehicle.buildBigSavedPosition.reset();
+		vehicle.setBuildBigSavedPosition (std::nullopt);
 		moveVehicleBig (vehicle, targetPosition);
 	}
 	addedUnit (vehicle);
@@ -691,7 +726,7 @@ void cMap::moveVehicle (cVehicle& vehicle, const cPosition& position, int height
 		{
 			getField (pos).removeVehicle (vehicle);
 		}
-		vehicle.buildBigSavedPosition.reset();
+		vehicle.setBuildBigSavedPosition (std::nullopt);
 		getField (position).addVehicle (vehicle, 0);
 	}
 	movedVehicle (vehicle, oldPosition);
@@ -719,7 +754,7 @@ void cMap::moveVehicleBig (cVehicle& vehicle, const cPosition& position)
 	getField (position + cPosition (1, 1)).addVehicle (vehicle, 0);
 	getField (position + cPosition (0, 1)).addVehicle (vehicle, 0);
 
-	vehicle.buildBigSavedPosition = oldPosition;
+	vehicle.setBuildBigSavedPosition (oldPosition);
 
 	movedVehicle (vehicle, oldPosition);
 }
@@ -32,6 +32,7 @@
 #include <cassert>
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -154,6 +155,8 @@ public:
 	bool isValid() const;
 
 	const std::filesystem::path& getFilename() const { return filename; }
+	/** returns the checksum of the map file, as computed by MapDownload::calculateCheckSum */
+	uint32_t getFileCrc() const { return crc; }
 	cPosition getSize() const { return cPosition (size, size); }
 	int getOffset (const cPosition& pos) const
 	{
@@ -172,6 +175,9 @@ public:
 
 	std::size_t getTileIndex (const cPosition&) const;
 	const sTerrain& getTerrain (const cPosition&) const;
+	/** terrain number of each field, row by row. Indexes getTerrains() */
+	const std::vector<uint16_t>& getTileIndices() const { return Kacheln; }
+	const std::vector<sTerrain>& getTerrains() const { return terrains; }
 
 	std::vector<cPosition> collectPositions (const cBox<cPosition>&) const;
 	std::vector<cPosition> collectAroundPositions (const cPosition&, bool isBig) const;
@@ -207,15 +213,54 @@ public:
 	}
 
 	SERIALIZATION_SPLIT_MEMBER()
+private:
+	friend class cStaticMapCache;
+
+	bool loadMap (const std::filesystem::path& filename, std::span<const unsigned char> content, uint32_t fileCrc);
+
 private:
 	std::filesystem::path filename; // Name of the current map
 	uint32_t crc = 0;
 	int size = 0;
-	std::vector<int> Kacheln; // Terrain numbers of the map fields
+	std::vector<uint16_t> Kacheln; // Terrain numbers of the map fields
 	std::vector<sTerrain> terrains; // The different terrain type.
 	mutable cGraphicStaticMap graphic;
 };
 
+/**
+* The part of a static map, that is stored in save games.
+* Layout is identical to the serialization of cStaticMap.
+*/
+struct sStaticMapReference
+{
+	template <ArchiveInOrOut Archive>
+	void serialize (Archive& archive)
+	{
+		// clang-format off
+		// See https://github.com/llvm/llvm-project/issues/44312
+		archive & NVP (filename);
+		archive & NVP (crc);
+		// clang-format on
+	}
+
+	std::filesystem::path filename;
+	uint32_t crc = 0;
+};
+
+/**
+* Shares parsed static maps between lobby map previews and games.
+* A map is identified by its filename and the checksum of the map file,
+* so a map file changed on disk is parsed again.
+* The returned maps are shared and must not be reloaded in place.
+*/
+class cStaticMapCache
+{
+public:
+	/** returns the parsed map or nullptr, if the map file cannot be loaded */
+	static std::shared_ptr<cStaticMap> get (const std::filesystem::path& filename);
+	static void clear();
+};
+
 class cMap
 {
 public:
@@ -235,6 +280,8 @@ public:
 	bool isWaterOrCoast (const cPosition&) const;
 
 	const sResources& getResource (const cPosition& position) const { return Resources[getOffset (position)]; }
+	/** resources of all fields, row by row */
+	const cArrayCrc<sResources>& getResources() const { return Resources; }
 	void setResource (const cPosition& position, const sResources& res) { return Resources.set (getOffset (position), res); }
 
 	cMapField& getField (const cPosition&);
@@ -289,8 +336,22 @@ public:
 	template <ArchiveIn Archive>
 	void load (Archive& archive)
 	{
-		assert (staticMap != nullptr);
-		archive >> serialization::makeNvp ("mapFile", *staticMap);
+		sStaticMapReference mapFile;
+		archive >> NVP (mapFile);
+		if (staticMap == nullptr || staticMap->getFilename() != mapFile.filename || staticMap->getFileCrc() != mapFile.crc)
+		{
+			// don't reload the current static map in place, it may be shared
+			auto loadedMap = cStaticMapCache::get (mapFile.filename);
+			if (loadedMap == nullptr)
+				throw std::runtime_error ("Loading map failed.");
+			if (loadedMap->getFileCrc() != mapFile.crc && mapFile.crc != 0)
+				throw std::runtime_error ("CRC error while loading map. The loaded map file is not equal to the one the game was started with.");
+			staticMap = std::move (loadedMap);
+		}
+		else
+		{
+			NetLog.debug ("Static map already loaded. Skipped...");
+		}
 		init();
 
 		std::string resources;
@@ -252,9 +252,9 @@ const sResources& cMapView::getResource (const cPosition& position) const
 	}
 	else
 	{
-		static sResources res;
-		res.typ = eResourceType::None;
-		return res;
+		// shared by all games of the process, so it must not be written
+		static const sResources unexplored;
+		return unexplored;
 	}
 }
 
@@ -21,6 +21,7 @@
 
 #include "game/data/gamesettings.h"
 #include "game/logic/casualtiestracker.h"
+#include "game/logic/desyncdiagnosis.h"
 #include "game/logic/fxeffects.h"
 #include "game/logic/jobs/destroyjob.h"
 #include "game/logic/movejob.h"
@@ -39,6 +40,7 @@
 
 #include <cassert>
 #include <set>
+#include <utility>
 
 namespace
 {
@@ -47,11 +49,23 @@ namespace
 	{
 		return [=] (const std::shared_ptr<cPlayer>& player) { return player->getId() == playerId; };
 	}
+
+	//--------------------------------------------------------------------------
+	bool canSeeFx (const cPlayer& player, const cFx& fx)
+	{
+		// effects are placed in pixel coordinates
+		if (const auto* rocket = dynamic_cast<const cFxRocket*> (&fx))
+		{
+			return player.canSeeAt (rocket->getStartPosition() / 64) || player.canSeeAt (rocket->getEndPosition() / 64);
+		}
+		return player.canSeeAt (fx.getPixelPosition() / 64);
+	}
 } // namespace
 
 //------------------------------------------------------------------------------
 cModel::cModel() :
 	gameSettings (std::make_shared<cGameSettings>()),
+	objectPool (std::make_shared<cObjectPool>()),
 	unitsData (std::make_shared<cUnitsData>()),
 	turnCounter (std::make_shared<cTurnCounter> (1)),
 	casualtiesTracker (std::make_shared<cCasualtiesTracker>())
@@ -76,14 +90,46 @@ void cModel::initGameId()
 //------------------------------------------------------------------------------
 void cModel::advanceGameTime()
 {
-	gameTime++;
-	gameTimeChanged();
+	const bool wasTurnStart = turnEndState == eTurnEndState::ExecuteTurnStart;
+	{
+		cProfiler::cScope scope (profiler, "advanceGameTime");
+
+		gameTime++;
+		gameTimeChanged();
 
-	runMoveJobs();
-	runAttackJobs();
-	effectsList.run();
-	handleTurnEnd();
-	helperJobs.run (*this);
+		{
+			cProfiler::cScope moveScope (profiler, turnEndState == eTurnEndState::TurnActive ? "runMoveJobs" : "runMoveJobs (turn end)");
+			runMoveJobs();
+		}
+		{
+			cProfiler::cScope attackScope (profiler, "runAttackJobs");
+			runAttackJobs();
+		}
+		{
+			cProfiler::cScope effectsScope (profiler, "effectsList.run");
+			effectsList.run();
+		}
+		{
+			cProfiler::cScope turnEndScope (profiler, "handleTurnEnd");
+			handleTurnEnd();
+		}
+		{
+			cProfiler::cScope helperScope (profiler, "helperJobs.run");
+			helperJobs.run (*this);
+		}
+	}
+	{
+		// includes the allocations between the ticks, e.g. by actions
+		const auto& statistics = objectPool->getStatistics();
+		profiler.addCount ("pool allocations", statistics.allocations - reportedPoolStatistics.allocations);
+		profiler.addCount ("pool slab allocations", statistics.slabAllocations - reportedPoolStatistics.slabAllocations);
+		profiler.addCount ("pool heap allocations", statistics.heapAllocations - reportedPoolStatistics.heapAllocations);
+		reportedPoolStatistics = statistics;
+	}
+	profiler.endTick();
+	if (wasTurnStart) profiler.endTurn();
+
+	tickFinished();
 }
 
 //------------------------------------------------------------------------------
@@ -119,6 +165,59 @@ uint32_t cModel::getChecksum() const
 
 	return crc;
 }
+
+//------------------------------------------------------------------------------
+std::vector<sChecksumPart> cModel::getChecksumParts() const
+{
+	// keep in sync with getChecksum()
+	std::vector<sChecksumPart> parts;
+	parts.push_back ({"randomGenerator", calcCheckSum (randomGenerator, 0), [this]() { return desync::toJson (randomGenerator); }});
+	parts.push_back ({"gameId", calcCheckSum (gameId, 0), [this]() { return desync::toJson (gameId); }});
+	parts.push_back ({"gameSettings", calcCheckSum (*gameSettings, 0), [this]() { return desync::toJson (*gameSettings); }});
+	parts.push_back ({"staticMap", map->staticMap->getChecksum (0), [this]() { return desync::toJson (map->getFilename().string()); }});
+	parts.push_back ({"mapResources", calcCheckSum (map->getResources(), 0), [this]() {
+		std::vector<sResources> resources;
+		for (std::size_t i = 0; i != map->getResources().size(); ++i)
+			resources.push_back (map->getResources()[i]);
+		return desync::toJson (resources);
+	}});
+
+	const auto addUnits = [&] (const auto& vehicles, const auto& buildings) {
+		for (const auto& vehicle : vehicles)
+		{
+			parts.push_back ({"vehicle " + std::to_string (vehicle->getId()), calcCheckSum (vehicle, 0), [&vehicle]() { return desync::toJson (*vehicle); }});
+		}
+		for (const auto& building : buildings)
+		{
+			parts.push_back ({"building " + std::to_string (building->getId()), calcCheckSum (building, 0), [&building]() { return desync::toJson (*building); }});
+		}
+	};
+	for (const auto& player : playerList)
+	{
+		const auto prefix = "player " + std::to_string (player->getId()) + "/";
+		for (auto& part : player->getChecksumParts())
+		{
+			part.name = prefix + part.name;
+			parts.push_back (std::move (part));
+		}
+		addUnits (player->getVehicles(), player->getBuildings());
+	}
+	addUnits (neutralVehicles, neutralBuildings);
+
+	parts.push_back ({"nextUnitId", calcCheckSum (nextUnitId, 0), [this]() { return desync::toJson (nextUnitId); }});
+	parts.push_back ({"unitsData", calcCheckSum (*unitsData, 0), {}});
+	parts.push_back ({"moveJobs", calcCheckSum (moveJobs, 0), [this]() { return desync::toJson (moveJobs); }});
+	parts.push_back ({"attackJobs", calcCheckSum (attackJobs, 0), [this]() { return desync::toJson (attackJobs); }});
+	parts.push_back ({"turnCounter", calcCheckSum (*turnCounter, 0), [this]() { return desync::toJson (*turnCounter); }});
+	parts.push_back ({"turnEndState", calcCheckSum (turnEndState, 0), [this]() { return desync::toJson (static_cast<int> (turnEndState)); }});
+	parts.push_back ({"activeTurnPlayer", calcCheckSum (activeTurnPlayer->getId(), 0), [this]() { return desync::toJson (activeTurnPlayer->getId()); }});
+	parts.push_back ({"turnEndDeadline", calcCheckSum (turnEndDeadline, 0), [this]() { return desync::toJson (turnEndDeadline); }});
+	parts.push_back ({"turnLimitDeadline", calcCheckSum (turnLimitDeadline, 0), [this]() { return desync::toJson (turnLimitDeadline); }});
+	parts.push_back ({"turnTimeClock", calcCheckSum (*turnTimeClock, 0), [this]() { return desync::toJson (*turnTimeClock); }});
+	parts.push_back ({"helperJobs", calcCheckSum (helperJobs, 0), [this]() { return desync::toJson (helperJobs); }});
+	parts.push_back ({"casualtiesTracker", calcCheckSum (*casualtiesTracker, 0), [this]() { return desync::toJson (*casualtiesTracker); }});
+	return parts;
+}
 //------------------------------------------------------------------------------
 void cModel::setGameSettings (const cGameSettings& gameSettings_)
 {
@@ -169,7 +268,7 @@ void cModel::setPlayerList (const std::vector<cPlayerBasicData>& splayers)
 
 	for (const auto& playerInfo : splayers)
 	{
-		auto player = std::make_shared<cPlayer> (playerInfo, *unitsData);
+		auto player = std::make_shared<cPlayer> (playerInfo, unitsData);
 		if (map) player->initMaps (map->getSize());
 		playerList.push_back (player);
 	}
@@ -186,10 +285,11 @@ const cPlayer* cModel::getActiveTurnPlayer() const
 cBuilding& cModel::addBuilding (const cPosition& position, const sID& id, cPlayer* player)
 {
 	const auto& staticUnitData = unitsData->getStaticUnitData (id);
-	const auto& dynamicUnitData = player ? *player->getLastUnitData (id) : unitsData->getDynamicUnitData (id);
-	auto addedBuilding = std::make_shared<cBuilding> (&staticUnitData, &dynamicUnitData, player, nextUnitId++);
+	const auto& dynamicUnitData = player ? *std::as_const (*player).getLastUnitData (id) : unitsData->getDynamicUnitData (id);
+	auto addedBuilding = objectPool->makeShared<cBuilding> (&staticUnitData, &dynamicUnitData, player, nextUnitId++);
 
 	addedBuilding->setPosition (position);
+	unitStore.add (*addedBuilding);
 	map->addBuilding (*addedBuilding);
 	if (player)
 	{
@@ -237,9 +337,10 @@ cBuilding& cModel::addBuilding (const cPosition& position, const sID& id, cPlaye
 cVehicle& cModel::addVehicle (const cPosition& position, const sID& id, cPlayer* player)
 {
 	const auto& staticUnitData = unitsData->getStaticUnitData (id);
-	const auto& dynamicUnitData = player ? *player->getLastUnitData (id) : unitsData->getDynamicUnitData (id);
-	auto addedVehicle = std::make_shared<cVehicle> (staticUnitData, dynamicUnitData, player, nextUnitId++);
+	const auto& dynamicUnitData = player ? *std::as_const (*player).getLastUnitData (id) : unitsData->getDynamicUnitData (id);
+	auto addedVehicle = objectPool->makeShared<cVehicle> (staticUnitData, dynamicUnitData, player, nextUnitId++);
 	addedVehicle->setPosition (position);
+	unitStore.add (*addedVehicle);
 
 	map->addVehicle (*addedVehicle);
 	if (player)
@@ -310,17 +411,18 @@ void cModel::addRubble (const cPosition& position, int value, bool big)
 	std::shared_ptr<cBuilding> rubble;
 	if (big)
 	{
-		rubble = std::make_shared<cBuilding> (&unitsData->getRubbleBigData(), nullptr, nullptr, nextUnitId);
+		rubble = objectPool->makeShared<cBuilding> (&unitsData->getRubbleBigData(), nullptr, nullptr, nextUnitId);
 	}
 	else
 	{
-		rubble = std::make_shared<cBuilding> (&unitsData->getRubbleSmallData(), nullptr, nullptr, nextUnitId);
+		rubble = objectPool->makeShared<cBuilding> (&unitsData->getRubbleSmallData(), nullptr, nullptr, nextUnitId);
 	}
 
 	nextUnitId++;
 
 	rubble->setPosition (position);
 	rubble->setRubbleValue (value, randomGenerator);
+	unitStore.add (*rubble);
 
 	map->addBuilding (*rubble);
 
@@ -355,8 +457,12 @@ void cModel::deleteUnit (cUnit* unit)
 		{
 			owningPtr = owner->removeUnit (*vehicle);
 		}
-		unit->forEachStoredUnits ([owner] (const auto& storedVehicle) { owner->removeUnit (storedVehicle); });
+		unit->forEachStoredUnits ([this, owner] (cVehicle& storedVehicle) {
+			unitStore.remove (storedVehicle);
+			owner->removeUnit (storedVehicle);
+		});
 	}
+	unitStore.remove (*unit);
 	helperJobs.onRemoveUnit (*unit);
 
 	// detach from move job
@@ -389,8 +495,9 @@ void cModel::deleteUnit (cUnit* unit)
 
 	if (owner != nullptr)
 	{
-		owner->removeFromSentryMap (*unit);
-		owner->removeFromScan (*unit);
+		// only units in sentry mode are in the sentry maps, disabled units are not in the scan maps
+		if (unit->isSentryActive()) owner->removeFromSentryMap (*unit);
+		if (!unit->isDisabled()) owner->removeFromScan (*unit);
 	}
 }
 //------------------------------------------------------------------------------
@@ -398,6 +505,7 @@ void cModel::deleteRubble (cBuilding& rubble)
 {
 	assert (rubble.isRubble());
 
+	unitStore.remove (rubble);
 	map->deleteBuilding (rubble);
 
 	auto iter = neutralBuildings.find (rubble);
@@ -424,7 +532,7 @@ cMoveJob* cModel::addMoveJob (cVehicle& vehicle, const cPosition& destination)
 }
 
 //------------------------------------------------------------------------------
-cMoveJob* cModel::addMoveJob (cVehicle& vehicle, const std::forward_list<cPosition>& path)
+cMoveJob* cModel::addMoveJob (cVehicle& vehicle, const cPath& path)
 {
 	cMoveJob* currentMoveJob = vehicle.getMoveJob();
 	if (currentMoveJob)
@@ -441,7 +549,7 @@ cMoveJob* cModel::addMoveJob (cVehicle& vehicle, const std::forward_list<cPositi
 			currentMoveJob->removeVehicle();
 		}
 	}
-	auto moveJob = std::make_unique<cMoveJob> (path, vehicle);
+	auto moveJob = objectPool->makeUnique<cMoveJob> (path, vehicle);
 	vehicle.setMoveJob (moveJob.get());
 
 	moveJobs.push_back (std::move (moveJob));
@@ -475,7 +583,8 @@ std::vector<const cPlayer*> cModel::resumeMoveJobs (const cPlayer* player /*= nu
 //------------------------------------------------------------------------------
 void cModel::addAttackJob (cUnit& aggressor, const cPosition& targetPosition)
 {
-	attackJobs.push_back (std::make_unique<cAttackJob> (aggressor, targetPosition, *this));
+	attackJobs.push_back (objectPool->makeUnique<cAttackJob> (aggressor, targetPosition, *this));
+	attackJobAdded (aggressor, targetPosition);
 }
 
 //------------------------------------------------------------------------------
@@ -508,8 +617,14 @@ void cModel::handlePlayerFinishedTurn (cPlayer& player)
 //------------------------------------------------------------------------------
 void cModel::addFx (std::shared_ptr<cFx> fx)
 {
-	effectsList.push_back (fx);
+	if (!animationSignalsEnabled) return;
+
+	for (const auto& player : playerList)
+	{
+		if (canSeeFx (*player, *fx)) player->addedEffect (fx);
+	}
 	addedEffect (fx);
+	effectsList.push_back (std::move (fx));
 }
 
 //------------------------------------------------------------------------------
@@ -642,8 +757,12 @@ void cModel::handleTurnEnd()
 			}
 			if (turnFinished || turnTimeClock->hasReachedAnyDeadline())
 			{
-				turnEnded();
+				{
+					cProfiler::cScope scope (profiler, "turnEnded signal");
+					turnEnded();
+				}
 
+				cProfiler::cScope scope (profiler, "resumeMoveJobs");
 				const auto resumedMJobOwners = resumeMoveJobs (gameSettings->gameType == eGameSettingsGameType::Simultaneous ? nullptr : activeTurnPlayer);
 				for (const auto& player : resumedMJobOwners)
 				{
@@ -676,6 +795,7 @@ void cModel::handleTurnEnd()
 				}
 
 				// check game end conditions, after turn start, so generated points from this turn are also counted
+				cProfiler::cScope scope (profiler, "checkDefeats");
 				checkDefeats();
 			}
 			else
@@ -707,6 +827,7 @@ void cModel::handleTurnEnd()
 				{
 					// check game end conditions, after turn start, so generated points from this turn are also counted
 					// and only check when first player starts the turn. So all players have played the same amount of turns.
+					cProfiler::cScope scope (profiler, "checkDefeats");
 					checkDefeats();
 				}
 			}
@@ -726,6 +847,7 @@ void cModel::handleTurnEnd()
 			}
 
 			turnEndState = eTurnEndState::TurnActive;
+			cProfiler::cScope scope (profiler, "newTurnStarted signal");
 			newTurnStarted (newTurnReport);
 		}
 		break;
@@ -733,9 +855,9 @@ void cModel::handleTurnEnd()
 }
 
 //------------------------------------------------------------------------------
-void cModel::setUnitsData (std::shared_ptr<cUnitsData> unitsData_)
+void cModel::setUnitsData (std::shared_ptr<const cUnitsData> unitsData_)
 {
-	unitsData = unitsData_;
+	unitsData = cUnitsDataCache::share (std::move (unitsData_));
 }
 
 //------------------------------------------------------------------------------
@@ -832,9 +954,7 @@ void cModel::sideStepStealthUnit (const cPosition& position, const cStaticUnitDa
 
 	if (bestPosition)
 	{
-		std::forward_list<cPosition> path;
-		path.push_front (*bestPosition);
-		if (auto moveJob = addMoveJob (*stealthVehicle, path))
+		if (auto moveJob = addMoveJob (*stealthVehicle, cPath {*bestPosition}))
 		{
 			moveJob->resume();
 		}
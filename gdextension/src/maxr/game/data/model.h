@@ -31,14 +31,18 @@
 #include "game/logic/movejob.h"
 #include "game/logic/turncounter.h"
 #include "units/unit.h"
+#include "units/unitstore.h"
 #include "utility/crossplattformrandom.h"
 #include "utility/flatset.h"
+#include "utility/objectpool.h"
+#include "utility/profiler.h"
 #include "utility/serialization/binaryarchive.h"
 #include "utility/serialization/serialization.h"
 
 #include <cassert>
-#include <forward_list>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string_view>
 #include <vector>
 
@@ -52,6 +56,7 @@ class cTurnTimeDeadline;
 class cUnit;
 class cVehicle;
 
+struct sChecksumPart;
 struct sID;
 
 struct sNewTurnReport
@@ -76,8 +81,14 @@ public:
 	unsigned int getGameTime() const;
 
 	uint32_t getChecksum() const;
+	/**
+	 * The parts of getChecksum() (random generator, map, player fields, units, jobs, turn state),
+	 * checksummed separately. Used to find the cause of a desync.
+	 */
+	std::vector<sChecksumPart> getChecksumParts() const;
 
-	void setUnitsData (std::shared_ptr<cUnitsData>);
+	/** the units data is shared with other models, see cUnitsDataCache */
+	void setUnitsData (std::shared_ptr<const cUnitsData>);
 	std::shared_ptr<const cUnitsData> getUnitsData() const { return unitsData; }
 
 	std::shared_ptr<const cGameSettings> getGameSettings() const { return gameSettings; }
@@ -90,6 +101,13 @@ public:
 	const std::shared_ptr<cCasualtiesTracker>& getCasualtiesTracker() { return casualtiesTracker; }
 	std::shared_ptr<const cCasualtiesTracker> getCasualtiesTracker() const { return casualtiesTracker; }
 
+	/** the hot state of all units of the model. See cUnitStore */
+	cUnitStore& getUnitStore() { return unitStore; }
+	const cUnitStore& getUnitStore() const { return unitStore; }
+
+	/** Memory pool for units, move jobs, attack jobs and effects created by this model */
+	cObjectPool& getObjectPool() const { return *objectPool; }
+
 	cPlayer* getPlayer (int playerNr);
 	const cPlayer* getPlayer (int playerNr) const;
 	const cPlayer* getPlayer (std::string_view player) const;
@@ -116,7 +134,7 @@ public:
 	std::shared_ptr<cBuilding> extractNeutralUnit (const cBuilding& building) { return neutralBuildings.extract (building); }
 	std::shared_ptr<cVehicle> extractNeutralUnit (const cVehicle& vehicle) { return neutralVehicles.extract (vehicle); }
 
-	cMoveJob* addMoveJob (cVehicle&, const std::forward_list<cPosition>& path);
+	cMoveJob* addMoveJob (cVehicle&, const cPath& path);
 	cMoveJob* addMoveJob (cVehicle&, const cPosition& destination);
 	std::vector<const cPlayer*> resumeMoveJobs (const cPlayer* = nullptr);
 
@@ -134,12 +152,27 @@ public:
 	void sideStepStealthUnit (const cPosition&, const cVehicle&, const cPosition& bigOffset = cPosition (-1, -1));
 	void sideStepStealthUnit (const cPosition&, const cStaticUnitData& vehicleData, cPlayer* vehicleOwner, const cPosition& bigOffset = cPosition (-1, -1));
 
+	/** time measurement of the model phases. Not part of the game state. */
+	cProfiler& getProfiler() const { return profiler; }
+
+	/**
+	* When disabled, the model does not trigger signals, that only feed
+	* animations (tracks, effects). Used to fast forward game time.
+	* Not part of the game state.
+	*/
+	void setAnimationSignalsEnabled (bool enabled) { animationSignalsEnabled = enabled; }
+	bool getAnimationSignalsEnabled() const { return animationSignalsEnabled; }
+
 	mutable cSignal<void()> gameTimeChanged;
+	/** Triggered at the end of advanceGameTime(). Thread safe, as the model may run on a non gui thread */
+	mutable cSignal<void(), std::recursive_mutex> tickFinished;
 	mutable cSignal<void (const cVehicle&)> triggeredAddTracks;
 	mutable cSignal<void (const cPlayer&)> playerFinishedTurn; // triggered when a player wants to end the turn
 	mutable cSignal<void()> turnEnded; // triggered when all players ended the turn or the turn time clock reached a deadline
 	mutable cSignal<void (const sNewTurnReport&)> newTurnStarted; // triggered when the model has done all calculations for the new turn.
+	/** Triggered for every effect. Effects are cosmetic, not part of the game state. See also cPlayer::addedEffect */
 	mutable cSignal<void (const std::shared_ptr<cFx>&)> addedEffect;
+	mutable cSignal<void (const cUnit& aggressor, const cPosition& targetPosition)> attackJobAdded;
 
 	mutable cSignal<void (const cUnit& storingUnit, const cUnit& storedUnit)> unitStored;
 	mutable cSignal<void (const cUnit& storingUnit, const cUnit& storedUnit)> unitActivated;
@@ -158,15 +191,27 @@ public:
 	mutable cSignal<void (const cPlayer&)> playerHasWon;
 	mutable cSignal<void()> suddenDeathMode;
 
+	/**
+	* When includeUnitsData is false, only the checksum of the units data is written.
+	* The reading side has to know the units data already.
+	*/
 	template <ArchiveOut Archive>
-	void save (Archive& archive) const
+	void save (Archive& archive, bool includeUnitsData = true) const
 	{
 		archive << NVP (gameId);
 		archive << NVP (gameTime);
 		archive << NVP (randomGenerator);
 		archive << serialization::makeNvp ("gameSettings", *gameSettings);
 		archive << serialization::makeNvp ("map", *map);
-		archive << serialization::makeNvp ("unitsData", *unitsData);
+		if (includeUnitsData)
+		{
+			archive << serialization::makeNvp ("unitsData", *unitsData);
+		}
+		else
+		{
+			const uint32_t unitsDataChecksum = unitsData->getChecksum (0);
+			archive << NVP (unitsDataChecksum);
+		}
 		archive << serialization::makeNvp ("players", playerList);
 		archive << NVP (moveJobs);
 		archive << NVP (attackJobs);
@@ -186,7 +231,7 @@ public:
 		//TODO: serialize effectList
 	}
 	template <ArchiveIn Archive>
-	void load (Archive& archive)
+	void load (Archive& archive, bool includeUnitsData = true)
 	{
 		archive >> NVP (gameId);
 		archive >> NVP (gameTime);
@@ -203,11 +248,22 @@ public:
 		archive >> serialization::makeNvp ("map", *map);
 		map->reset();
 
-		if (unitsData == nullptr)
+		if (includeUnitsData)
 		{
-			unitsData = std::make_shared<cUnitsData>();
+			auto loadedUnitsData = std::make_shared<cUnitsData>();
+			archive >> serialization::makeNvp ("unitsData", *loadedUnitsData);
+			setUnitsData (std::move (loadedUnitsData));
+		}
+		else
+		{
+			uint32_t unitsDataChecksum = 0;
+			archive >> NVP (unitsDataChecksum);
+			if (unitsData == nullptr || unitsData->getChecksum (0) != unitsDataChecksum)
+			{
+				unitsData = cUnitsDataCache::find (unitsDataChecksum);
+				if (unitsData == nullptr) throw std::runtime_error ("Unknown units data " + std::to_string (unitsDataChecksum));
+			}
 		}
-		archive >> serialization::makeNvp ("unitsData", *unitsData);
 		//TODO: check UIData available
 
 		// Don't load directly playerList as pointer might be stored (signal, gui, ...)
@@ -299,6 +355,9 @@ private:
 
 	std::shared_ptr<cGameSettings> gameSettings;
 	std::shared_ptr<cMap> map;
+	std::shared_ptr<cObjectPool> objectPool; // declared before the units and jobs, so that it outlives them
+	cObjectPool::sStatistics reportedPoolStatistics; // state of the pool at the end of the last tick
+	cUnitStore unitStore; // declared before the units, so that it outlives them
 	std::vector<std::shared_ptr<cPlayer>> playerList;
 	cPlayer* activeTurnPlayer = nullptr;
 
@@ -307,10 +366,10 @@ private:
 
 	int nextUnitId = 0;
 
-	std::shared_ptr<cUnitsData> unitsData;
+	std::shared_ptr<const cUnitsData> unitsData;
 
-	std::vector<std::unique_ptr<cMoveJob>> moveJobs;
-	std::vector<std::unique_ptr<cAttackJob>> attackJobs;
+	std::vector<tPoolPtr<cMoveJob>> moveJobs;
+	std::vector<tPoolPtr<cAttackJob>> attackJobs;
 
 	std::shared_ptr<cTurnCounter> turnCounter;
 	std::shared_ptr<cTurnTimeClock> turnTimeClock;
@@ -332,6 +391,9 @@ private:
 
 	/** little helper jobs, that do some time dependent actions */
 	cJobContainer helperJobs;
+
+	mutable cProfiler profiler;
+	bool animationSignalsEnabled = true;
 };
 
 #endif
@@ -20,16 +20,31 @@
 #include "game/data/player/player.h"
 
 #include "game/data/map/map.h"
+#include "game/data/map/mapview.h"
 #include "game/data/model.h"
 #include "game/data/units/building.h"
 #include "game/data/units/vehicle.h"
+#include "game/logic/desyncdiagnosis.h"
 #include "playerbasicdata.h"
 #include "utility/crc.h"
 #include "utility/string/toString.h"
+#include "utility/thread/parallelfor.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 
+namespace
+{
+	//--------------------------------------------------------------------------
+	cDynamicUnitData& takeVersionState (cDynamicUnitData& copy, const cDynamicUnitData& original)
+	{
+		// the copy constructor does not take the version state
+		if (original.isVersionDirty()) copy.makeVersionDirty();
+		return copy;
+	}
+} // namespace
+
 //------------------------------------------------------------------------------
 void sNewTurnPlayerReport::addUnitBuilt (const sID& unitTypeId)
 {
@@ -57,13 +72,12 @@ cPlayer::cPlayer() :
 {
 }
 //------------------------------------------------------------------------------
-cPlayer::cPlayer (const cPlayerBasicData& splayer, const cUnitsData& unitsData) :
+cPlayer::cPlayer (const cPlayerBasicData& splayer, std::shared_ptr<const cUnitsData> unitsData) :
+	unitsData (std::move (unitsData)),
 	player ({splayer.getName(), splayer.getColor()}),
 	id (splayer.getNr()),
 	base (*this)
 {
-	// get the default (no clan) unit data
-	dynamicUnitsData = unitsData.getDynamicUnitsData (-1);
 }
 
 //------------------------------------------------------------------------------
@@ -73,6 +87,12 @@ cPlayer::~cPlayer()
 //------------------------------------------------------------------------------
 void cPlayer::postLoad (cModel& model)
 {
+	unitsData = model.getUnitsData();
+	std::erase_if (upgradedUnitsData, [this] (const auto& entry) {
+		const auto* originalData = getOriginalUnitData (entry.first);
+		return originalData && *originalData == entry.second;
+	});
+
 	for (auto& building : getBuildings())
 	{
 		building->postLoad (model);
@@ -89,16 +109,17 @@ void cPlayer::postLoad (cModel& model)
 }
 
 //------------------------------------------------------------------------------
-void cPlayer::setClan (int newClan, const cUnitsData& unitsData)
+void cPlayer::setClan (int newClan, std::shared_ptr<const cUnitsData> newUnitsData)
 {
 	if (newClan < -1)
 		return;
-	if (newClan > 0 && static_cast<size_t> (newClan) >= unitsData.getNrOfClans())
+	if (newClan > 0 && static_cast<size_t> (newClan) >= newUnitsData->getNrOfClans())
 		return;
 
 	clan = newClan;
 
-	dynamicUnitsData = unitsData.getDynamicUnitsData (clan);
+	unitsData = std::move (newUnitsData);
+	upgradedUnitsData.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -111,20 +132,76 @@ void cPlayer::setCredits (int credits_)
 //------------------------------------------------------------------------------
 cDynamicUnitData* cPlayer::getLastUnitData (const sID& id)
 {
-	const cPlayer* constMe = this;
-	return const_cast<cDynamicUnitData*> (constMe->getLastUnitData (id));
+	auto it = upgradedUnitsData.find (id);
+	if (it != upgradedUnitsData.end()) return &it->second;
+
+	const auto* originalData = getOriginalUnitData (id);
+	if (originalData == nullptr) return nullptr;
+	return &takeVersionState (upgradedUnitsData.emplace (id, *originalData).first->second, *originalData);
 }
 
 //------------------------------------------------------------------------------
 const cDynamicUnitData* cPlayer::getLastUnitData (const sID& id) const
 {
-	for (const auto& data : dynamicUnitsData)
+	auto it = upgradedUnitsData.find (id);
+	if (it != upgradedUnitsData.end()) return &it->second;
+
+	return getOriginalUnitData (id);
+}
+
+//------------------------------------------------------------------------------
+const cDynamicUnitData* cPlayer::getOriginalUnitData (const sID& id) const
+{
+	if (unitsData == nullptr) return nullptr;
+
+	for (const auto& data : unitsData->getDynamicUnitsData (clan))
 	{
 		if (data.getId() == id) return &data;
 	}
 	return nullptr;
 }
 
+//------------------------------------------------------------------------------
+template <typename F>
+void cPlayer::forEachUnitData (F f) const
+{
+	if (unitsData == nullptr)
+	{
+		// loaded, but not yet restored by postLoad()
+		for (const auto& [id, data] : upgradedUnitsData)
+		{
+			f (data);
+		}
+		return;
+	}
+	for (const auto& originalData : unitsData->getDynamicUnitsData (clan))
+	{
+		auto it = upgradedUnitsData.find (originalData.getId());
+		f (it != upgradedUnitsData.end() ? it->second : originalData);
+	}
+}
+
+//------------------------------------------------------------------------------
+std::vector<cDynamicUnitData> cPlayer::getDynamicUnitsData() const
+{
+	std::vector<cDynamicUnitData> result;
+	// no reallocation, which would drop the version states again
+	result.reserve (unitsData ? unitsData->getDynamicUnitsData (clan).size() : upgradedUnitsData.size());
+	forEachUnitData ([&] (const cDynamicUnitData& data) { takeVersionState (result.emplace_back (data), data); });
+	return result;
+}
+
+//------------------------------------------------------------------------------
+void cPlayer::setDynamicUnitsData (const std::vector<cDynamicUnitData>& dynamicUnitsData)
+{
+	unitsData = nullptr;
+	upgradedUnitsData.clear();
+	for (const auto& data : dynamicUnitsData)
+	{
+		takeVersionState (upgradedUnitsData.emplace (data.getId(), data).first->second, data);
+	}
+}
+
 //------------------------------------------------------------------------------
 /** initialize the maps */
 //------------------------------------------------------------------------------
@@ -134,6 +211,7 @@ void cPlayer::initMaps (const cPosition& mapSize)
 	const int size = mapSize.x() * mapSize.y();
 
 	resourceMap.resize (size, 0);
+	++resourceMapVersion;
 	sentriesMapAir.resize (mapSize);
 	sentriesMapGround.resize (mapSize);
 
@@ -329,6 +407,8 @@ void cPlayer::updateSentry (const cUnit& u, int newRange)
 //------------------------------------------------------------------------------
 void cPlayer::refreshSentryMaps()
 {
+	sentriesMapAir.beginBatch();
+	sentriesMapGround.beginBatch();
 	sentriesMapAir.reset();
 	sentriesMapGround.reset();
 
@@ -347,6 +427,8 @@ void cPlayer::refreshSentryMaps()
 			addToSentryMap (*unit);
 		}
 	}
+	sentriesMapAir.commitBatch();
+	sentriesMapGround.commitBatch();
 }
 
 //------------------------------------------------------------------------------
@@ -354,38 +436,48 @@ void cPlayer::refreshScanMaps()
 {
 	// simply clear the maps and re-add all units would lead to a lot of
 	// false triggered events (like unit detected, etc.).
-	// so we use a special method, that only triggers signals on fields that
-	// really changed during the refresh.
-
-	//1 save original maps
-	const auto scanMapCopy = scanMap.getMap();
-	const auto detectLandMapCopy = detectLandMap.getMap();
-	const auto detectSeaMapCopy = detectSeaMap.getMap();
-	const auto detectMinesMapCopy = detectMinesMap.getMap();
+	// so the maps are rebuilt in a batch, that only triggers signals on fields
+	// that really changed during the refresh.
+	const std::array<cRangeMap*, 4> maps = {&scanMap, &detectLandMap, &detectSeaMap, &detectMinesMap};
+	for (auto* map : maps)
+	{
+		map->beginBatch();
+		map->reset();
+	}
 
-	//2 add all units (yes they are on the scan maps twice now)
 	for (const auto& vehicle : vehicles)
 	{
-		if (vehicle->isUnitLoaded()) continue;
+		if (vehicle->isUnitLoaded() || vehicle->isDisabled()) continue;
 		addToScan (*vehicle);
 	}
 
 	for (const auto& building : buildings)
 	{
+		if (building->isDisabled()) continue;
 		addToScan (*building);
 	}
 
-	//3 subtract values from the saved maps
-	scanMap.subtract (scanMapCopy);
-	detectLandMap.subtract (detectLandMapCopy);
-	detectSeaMap.subtract (detectSeaMapCopy);
-	detectMinesMap.subtract (detectMinesMapCopy);
+	for (auto* map : maps)
+	{
+		map->commitBatch();
+	}
+}
+
+//------------------------------------------------------------------------------
+void cPlayer::exploreResource (const cPosition& pos)
+{
+	const auto offset = getOffset (pos);
+	if (resourceMap[offset] != 0) return;
+
+	resourceMap.set (offset, 1);
+	++resourceMapVersion;
 }
 
 //------------------------------------------------------------------------------
 void cPlayer::revealResource()
 {
 	resourceMap.fill (1);
+	++resourceMapVersion;
 }
 
 //------------------------------------------------------------------------------
@@ -436,6 +528,7 @@ void cPlayer::setResourceMapFromString (std::string_view str)
 	{
 		resourceMap.set (i, getByteValue (str, 2 * i));
 	}
+	++resourceMapVersion;
 }
 
 //------------------------------------------------------------------------------
@@ -533,12 +626,11 @@ int cPlayer::getScore() const
 //------------------------------------------------------------------------------
 void cPlayer::upgradeUnitTypes (const std::vector<cResearch::eResearchArea>& areasReachingNextLevel, const cUnitsData& originalUnitsData)
 {
-	for (auto& unitData : dynamicUnitsData)
+	for (const auto& originalData : originalUnitsData.getDynamicUnitsData (getClan()))
 	{
-		const cDynamicUnitData& originalData = originalUnitsData.getDynamicUnitData (unitData.getId(), getClan());
 		for (auto researchArea : areasReachingNextLevel)
 		{
-			if (unitData.getId().isABuilding() && researchArea == cResearch::eResearchArea::SpeedResearch) continue;
+			if (originalData.getId().isABuilding() && researchArea == cResearch::eResearchArea::SpeedResearch) continue;
 
 			const int newResearchLevel = researchState.getCurResearchLevel (researchArea);
 			int startValue = 0;
@@ -555,14 +647,15 @@ void cPlayer::upgradeUnitTypes (const std::vector<cResearch::eResearchArea>& are
 			}
 
 			cUpgradeCalculator::eUnitType unitType = cUpgradeCalculator::eUnitType::StandardUnit;
-			if (unitData.getId().isABuilding()) unitType = cUpgradeCalculator::eUnitType::Building;
-			if (originalUnitsData.getStaticUnitData (unitData.getId()).vehicleData.isHuman) unitType = cUpgradeCalculator::eUnitType::Infantry;
+			if (originalData.getId().isABuilding()) unitType = cUpgradeCalculator::eUnitType::Building;
+			if (originalUnitsData.getStaticUnitData (originalData.getId()).vehicleData.isHuman) unitType = cUpgradeCalculator::eUnitType::Infantry;
 
 			int oldResearchBonus = cUpgradeCalculator::instance().calcChangeByResearch (startValue, newResearchLevel - 10, researchArea == cResearch::eResearchArea::CostResearch ? std::make_optional (cUpgradeCalculator::eUpgradeType::Cost) : std::nullopt, unitType);
 			int newResearchBonus = cUpgradeCalculator::instance().calcChangeByResearch (startValue, newResearchLevel, researchArea == cResearch::eResearchArea::CostResearch ? std::make_optional (cUpgradeCalculator::eUpgradeType::Cost) : std::nullopt, unitType);
 
 			if (oldResearchBonus != newResearchBonus)
 			{
+				cDynamicUnitData& unitData = *getLastUnitData (originalData.getId());
 				switch (researchArea)
 				{
 					case cResearch::eResearchArea::AttackResearch: unitData.setDamage (unitData.getDamage() + newResearchBonus - oldResearchBonus); break;
@@ -623,51 +716,63 @@ void cPlayer::refreshBase (const cMap& map)
 //------------------------------------------------------------------------------
 sNewTurnPlayerReport cPlayer::makeTurnStart (cModel& model)
 {
-	setHasFinishedTurn (false);
+	cProfiler& profiler = model.getProfiler();
+	cProfiler::cScope scope (profiler, "makeTurnStart");
 
-	base.checkTurnEnd();
+	setHasFinishedTurn (false);
 
 	sNewTurnPlayerReport report;
-	base.makeTurnStart (report);
+	{
+		cProfiler::cScope baseScope (profiler, "makeTurnStart: base");
+		base.checkTurnEnd();
+		base.makeTurnStart (report);
+	}
 
-	// reload all buildings
-	for (auto& building : buildings)
 	{
-		if (building->isDisabled())
+		cProfiler::cScope unitsScope (profiler, "makeTurnStart: units");
+
+		// reload all buildings
+		for (auto& building : buildings)
 		{
-			building->setDisabledTurns (building->getDisabledTurns() - 1);
-			if (!building->isDisabled())
+			if (building->isDisabled())
 			{
-				addToScan (*building);
-				if (building->wasWorking)
+				building->setDisabledTurns (building->getDisabledTurns() - 1);
+				if (!building->isDisabled())
 				{
-					building->startWork();
-					building->wasWorking = false;
+					addToScan (*building);
+					if (building->wasWorking)
+					{
+						building->startWork();
+						building->wasWorking = false;
+					}
 				}
 			}
+			building->refreshData();
 		}
-		building->refreshData();
-	}
 
-	// reload all vehicles
-	for (auto& vehicle : vehicles)
-	{
-		if (vehicle->isDisabled())
+		// reload all vehicles
+		for (auto& vehicle : vehicles)
 		{
-			vehicle->setDisabledTurns (vehicle->getDisabledTurns() - 1);
-			if (!vehicle->isDisabled())
+			if (vehicle->isDisabled())
 			{
-				addToScan (*vehicle);
+				vehicle->setDisabledTurns (vehicle->getDisabledTurns() - 1);
+				if (!vehicle->isDisabled())
+				{
+					addToScan (*vehicle);
+				}
 			}
+			vehicle->refreshData();
+			vehicle->proceedBuilding (model, report);
+			vehicle->proceedClearing (model);
 		}
-		vehicle->refreshData();
-		vehicle->proceedBuilding (model, report);
-		vehicle->proceedClearing (model);
 	}
 
 	//just to prevent, that an error in scanmap updates have a permanent impact
-	refreshScanMaps();
-	refreshSentryMaps();
+	{
+		cProfiler::cScope mapsScope (profiler, "makeTurnStart: scan maps");
+		refreshScanMaps();
+		refreshSentryMaps();
+	}
 
 	// allow stealth vehicles to enter stealth mode, when they move in the new turn
 	for (auto& vehicle : vehicles)
@@ -676,25 +781,67 @@ sNewTurnPlayerReport cPlayer::makeTurnStart (cModel& model)
 	}
 
 	// do research:
-	report.finishedResearchs = doResearch (*model.getUnitsData());
+	{
+		cProfiler::cScope researchScope (profiler, "makeTurnStart: research");
+		report.finishedResearchs = doResearch (*model.getUnitsData());
+	}
 
 	// eco-spheres:
 	accumulateScore();
 
 	// Gun'em down:
-	for (auto& vehicle : vehicles)
 	{
-		vehicle->inSentryRange (model);
+		cProfiler::cScope sentryScope (profiler, "makeTurnStart: sentry attacks");
+		makeTurnStartSentryAttacks (model);
 	}
+
 	return report;
 }
 
+//------------------------------------------------------------------------------
+void cPlayer::makeTurnStartSentryAttacks (cModel& model)
+{
+	// each worker needs its own map view,
+	// because creating one connects to the signals of the map
+	const std::size_t workerCount = getParallelWorkerCount();
+	std::vector<std::unique_ptr<cMapView>> mapViews;
+	for (std::size_t i = 0; i != workerCount; ++i)
+	{
+		mapViews.push_back (std::make_unique<cMapView> (model.getMap(), nullptr));
+	}
+
+	// The vehicles are searched in windows, so that after an attack
+	// only the rest of the current window has to be searched again.
+	const std::size_t windowSize = 32 * workerCount;
+	std::vector<cVehicle::sReactionAttack> attacks (windowSize);
+	std::size_t first = 0;
+	while (first < vehicles.size())
+	{
+		const std::size_t count = std::min (windowSize, vehicles.size() - first);
+		parallelFor (count, workerCount, [&] (std::size_t worker, std::size_t i) {
+			attacks[i] = vehicles.begin()[first + i]->findReactionAttack (model, *mapViews[worker]);
+		});
+		const auto end = attacks.begin() + count;
+		const auto it = std::find_if (attacks.begin(), end, [] (const auto& attack) { return attack.aggressor != nullptr; });
+		if (it == end)
+		{
+			first += count;
+			continue;
+		}
+
+		// the attack modifies the model, so the following vehicles have to be searched again
+		const std::size_t index = first + (it - attacks.begin());
+		vehicles.begin()[index]->makeReactionAttack (model, *it);
+		first = index + 1;
+	}
+}
+
 //------------------------------------------------------------------------------
 uint32_t cPlayer::getChecksum (uint32_t crc) const
 {
 	crc = player.getCheckSum (crc);
 	crc = calcCheckSum (id, crc);
-	crc = calcCheckSum (dynamicUnitsData, crc);
+	forEachUnitData ([&] (const cDynamicUnitData& data) { crc = calcCheckSum (data, crc); });
 	crc = calcCheckSum (base, crc);
 	crc = calcCheckSum (vehicles, crc);
 	crc = calcCheckSum (buildings, crc);
@@ -720,6 +867,41 @@ uint32_t cPlayer::getChecksum (uint32_t crc) const
 	return crc;
 }
 
+//------------------------------------------------------------------------------
+std::vector<sChecksumPart> cPlayer::getChecksumParts() const
+{
+	// keep in sync with getChecksum()
+	uint32_t unitsDataCrc = 0;
+	forEachUnitData ([&] (const cDynamicUnitData& data) { unitsDataCrc = calcCheckSum (data, unitsDataCrc); });
+	const auto rangeMapPart = [] (const char* name, const cRangeMap& rangeMap) {
+		return sChecksumPart{name, calcCheckSum (rangeMap, 0), [&rangeMap]() { return desync::toJson (rangeMap.getMap()); }};
+	};
+
+	return {
+		{"settings", player.getCheckSum (0), [this]() { return desync::toJson (player); }},
+		{"id", calcCheckSum (id, 0), [this]() { return desync::toJson (id); }},
+		{"unitsData", unitsDataCrc, [this]() { return desync::toJson (getDynamicUnitsData()); }},
+		{"base", calcCheckSum (base, 0), {}},
+		{"landingPos", calcCheckSum (landingPos, 0), [this]() { return desync::toJson (landingPos); }},
+		{"mapSize", calcCheckSum (mapSize, 0), [this]() { return desync::toJson (mapSize); }},
+		rangeMapPart ("scanMap", scanMap),
+		{"resourceMap", calcCheckSum (resourceMap, 0), [this]() { return desync::toJson (resourceMapToString()); }},
+		rangeMapPart ("sentriesMapAir", sentriesMapAir),
+		rangeMapPart ("sentriesMapGround", sentriesMapGround),
+		rangeMapPart ("detectLandMap", detectLandMap),
+		rangeMapPart ("detectSeaMap", detectSeaMap),
+		rangeMapPart ("detectMinesMap", detectMinesMap),
+		{"pointsHistory", calcCheckSum (pointsHistory, 0), [this]() { return desync::toJson (pointsHistory); }},
+		{"isDefeated", calcCheckSum (isDefeated, 0), [this]() { return desync::toJson (isDefeated); }},
+		{"clan", calcCheckSum (clan, 0), [this]() { return desync::toJson (clan); }},
+		{"credits", calcCheckSum (credits, 0), [this]() { return desync::toJson (credits); }},
+		{"hasFinishedTurn", calcCheckSum (hasFinishedTurn, 0), [this]() { return desync::toJson (hasFinishedTurn); }},
+		{"researchState", calcCheckSum (researchState, 0), [this]() { return desync::toJson (researchState); }},
+		{"researchCentersWorkingOnArea", calcCheckSum (researchCentersWorkingOnArea, 0), [this]() { return desync::toJson (researchCentersWorkingOnArea); }},
+		{"researchCentersWorkingTotal", calcCheckSum (researchCentersWorkingTotal, 0), [this]() { return desync::toJson (researchCentersWorkingTotal); }},
+		{"gameOverStat", gameOverStat.getChecksum (0), [this]() { return desync::toJson (gameOverStat); }}};
+}
+
 //------------------------------------------------------------------------------
 bool cPlayer::mayHaveOffensiveUnit() const
 {
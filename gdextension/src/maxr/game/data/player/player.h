@@ -36,13 +36,17 @@
 #include "utility/signal/signal.h"
 
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
+class cFx;
 class cMapField;
 class cUnit;
 class cPosition;
+struct sChecksumPart;
 struct sTerrain;
 class cPlayerBasicData;
 
@@ -123,7 +127,7 @@ class cPlayer
 
 public:
 	cPlayer(); // used by serialization
-	cPlayer (const cPlayerBasicData&, const cUnitsData&);
+	cPlayer (const cPlayerBasicData&, std::shared_ptr<const cUnitsData>);
 	~cPlayer();
 
 	const std::string& getName() const { return player.name; }
@@ -136,7 +140,11 @@ public:
 	int getCredits() const { return credits; }
 	void setCredits (int credits);
 
-	/** Get the most modern version of a unit (including all its upgrades). */
+	/**
+	* Get the most modern version of a unit (including all its upgrades).
+	* The non const version makes a private copy of the unit type,
+	* so only use it for changing the unit data.
+	*/
 	cDynamicUnitData* getLastUnitData (const sID&);
 	const cDynamicUnitData* getLastUnitData (const sID&) const;
 
@@ -204,14 +212,16 @@ public:
 	/** count generated points at turn end and and create a new entry in the points history */
 	void accumulateScore();
 
-	void setClan (int newClan, const cUnitsData&);
+	void setClan (int newClan, std::shared_ptr<const cUnitsData>);
 	int getClan() const { return clan; }
 
 	bool getHasFinishedTurn() const { return hasFinishedTurn; }
 	void setHasFinishedTurn (bool value);
 
-	void exploreResource (const cPosition& pos) { resourceMap.set (getOffset (pos), 1); }
+	void exploreResource (const cPosition& pos);
 	bool hasResourceExplored (const cPosition& pos) const { return resourceMap[getOffset (pos)] != 0; }
+	/** changes whenever the set of explored resource fields changes */
+	unsigned int getResourceMapVersion() const { return resourceMapVersion; }
 	bool hasSentriesAir (const cPosition& pos) const { return sentriesMapAir.get (pos); }
 	bool hasSentriesGround (const cPosition& pos) const { return sentriesMapGround.get (pos); }
 	bool hasLandDetection (const cPosition& pos) const { return detectLandMap.get (pos); }
@@ -242,6 +252,11 @@ public:
 	sGameOverStat& getGameOverStat() { return gameOverStat; }
 
 	uint32_t getChecksum (uint32_t crc) const;
+	/**
+	 * The fields of getChecksum(), checksummed separately. Used to find the cause of a desync.
+	 * The vehicles and buildings are not included, the model lists them as parts of their own.
+	 */
+	std::vector<sChecksumPart> getChecksumParts() const;
 
 	mutable cSignal<void()> creditsChanged;
 	mutable cSignal<void()> hasFinishedTurnChanged;
@@ -256,6 +271,8 @@ public:
 	mutable cSignal<void (const cUnit&)> detectedStealthUnit;
 	mutable cSignal<void (const cUnit&)> stealthUnitDissappeared;
 	mutable cSignal<void (const sID&, int unitsCount, int costs)> unitsUpgraded;
+	/** Like cModel::addedEffect, but only triggered for effects at positions the player can see */
+	mutable cSignal<void (const std::shared_ptr<cFx>&)> addedEffect;
 
 	template <ArchiveIn Archive>
 	static std::unique_ptr<cPlayer> createFrom (Archive& archive)
@@ -273,6 +290,7 @@ public:
 
 		archive & NVP (player);
 		archive & NVP (id);
+		const auto dynamicUnitsData = getDynamicUnitsData();
 		archive & NVP (dynamicUnitsData);
 		// clang-format on
 
@@ -326,8 +344,9 @@ public:
 		archive & NVP (player);
 		archive & NVP (id);
 
-		dynamicUnitsData.clear();
+		std::vector<cDynamicUnitData> dynamicUnitsData;
 		archive & NVP (dynamicUnitsData);
+		setDynamicUnitsData (dynamicUnitsData);
 
 		archive & NVP (vehicles);
 		archive & NVP (buildings);
@@ -364,6 +383,15 @@ public:
 	void postLoad (cModel&);
 
 private:
+	/** returns the most modern version of all unit types */
+	std::vector<cDynamicUnitData> getDynamicUnitsData() const;
+	/** stores the unit types until postLoad() restores the shared units data */
+	void setDynamicUnitsData (const std::vector<cDynamicUnitData>&);
+	const cDynamicUnitData* getOriginalUnitData (const sID&) const;
+	/** calls f for the most modern version of all unit types in the order of the units data */
+	template <typename F>
+	void forEachUnitData (F f) const;
+
 	void upgradeUnitTypes (const std::vector<cResearch::eResearchArea>&, const cUnitsData& originalUnitsData);
 
 	std::string resourceMapToString() const;
@@ -371,8 +399,18 @@ private:
 
 	void refreshScanMaps();
 
+	/**
+	 * Lets opponents fire on all vehicles of the player by sentry and reaction fire.
+	 * The attackers are searched in parallel on the unchanged model.
+	 * The attacks are started in the order of the vehicles.
+	 * After each attack the remaining vehicles are searched again,
+	 * so the result is the same as calling inSentryRange() for each vehicle.
+	 */
+	void makeTurnStartSentryAttacks (cModel&);
+
 private:
-	std::vector<cDynamicUnitData> dynamicUnitsData; // Current version of vehicles.
+	std::shared_ptr<const cUnitsData> unitsData; // shared with the model. Contains the unit types without upgrades
+	std::map<sID, cDynamicUnitData> upgradedUnitsData; // Current version of the unit types, which differ from unitsData
 
 public:
 	bool isDefeated = false; // true if the player has been defeated
@@ -393,6 +431,7 @@ private:
 
 	// using a special array with cached checksum. This speeds up the calculation of the model checksum.
 	cArrayCrc<uint8_t> resourceMap; /** Map with explored resources. */
+	unsigned int resourceMapVersion = 0;
 	cRangeMap sentriesMapAir; /** the covered air area */
 	cRangeMap sentriesMapGround; /** the covered ground area */
 	cRangeMap scanMap; /** seen Map tiles. */
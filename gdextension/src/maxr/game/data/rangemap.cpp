@@ -20,248 +20,395 @@
 #include "rangemap.h"
 
 #include "utility/crc.h"
-#include "utility/narrow_cast.h"
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+/**
+* The covered area of an object, stored as one span of columns per row.
+* All coordinates are relative to the position of the object.
+*/
+struct cRangeMap::sFootprint
+{
+	struct sSpan
+	{
+		int firstX = 0;
+		int lastX = -1;
+	};
+
+	int firstY = 0;
+	std::vector<sSpan> rows;
+};
+
+namespace
+{
+	//--------------------------------------------------------------------------
+	int integerSqrt (int value)
+	{
+		int root = static_cast<int> (std::sqrt (static_cast<double> (value)));
+		while (root * root > value)
+			--root;
+		while ((root + 1) * (root + 1) <= value)
+			++root;
+		return root;
+	}
+
+	//--------------------------------------------------------------------------
+	int divFloor (int a, int b)
+	{
+		return a / b - (a % b != 0 && (a < 0) != (b < 0));
+	}
+
+	//--------------------------------------------------------------------------
+	int divCeil (int a, int b)
+	{
+		return -divFloor (-a, b);
+	}
+
+	//--------------------------------------------------------------------------
+	/** calls f for each of the (at most two) column spans in 'a', which are not in 'b' */
+	template <typename F>
+	void forEachDifference (int aFirst, int aLast, int bFirst, int bLast, F f)
+	{
+		if (aFirst > aLast) return;
+		if (bFirst > bLast)
+		{
+			f (aFirst, aLast);
+			return;
+		}
+		if (aFirst <= std::min (aLast, bFirst - 1)) f (aFirst, std::min (aLast, bFirst - 1));
+		if (std::max (aFirst, bLast + 1) <= aLast) f (std::max (aFirst, bLast + 1), aLast);
+	}
+} // namespace
 
 //------------------------------------------------------------------------------
-void cRangeMap::reset()
+cRangeMap::sFootprint cRangeMap::makeFootprint (int range, int unitSize, bool square)
 {
-	std::fill (map.begin(), map.end(), 0);
-	crcCache = std::nullopt;
+	// calc distance from center of unit.
+	// to prevent fractional numbers, use the double distance
+	sFootprint footprint;
+	footprint.firstY = -range;
+	for (int y = -range; y < range + unitSize; ++y)
+	{
+		const int dy2x = 2 * y - unitSize + 1;
+		sFootprint::sSpan span;
+		const int maxDx2x = square ? (std::abs (dy2x) <= 2 * range ? 2 * range : -1)
+		                           : (dy2x * dy2x <= 4 * range * range ? integerSqrt (4 * range * range - dy2x * dy2x) : -1);
+		if (maxDx2x >= 0)
+		{
+			span.firstX = divCeil (unitSize - 1 - maxDx2x, 2);
+			span.lastX = divFloor (unitSize - 1 + maxDx2x, 2);
+		}
+		footprint.rows.push_back (span);
+	}
+	return footprint;
 }
 
 //------------------------------------------------------------------------------
-void cRangeMap::resize (const cPosition& size_)
+/**
+* The footprints of all ranges up to maxTableRange of small and big units are
+* computed once and never change, so all range maps of all threads share them
+* without locking. Larger ranges are cached per thread.
+*/
+const cRangeMap::sFootprint& cRangeMap::getFootprint (int range, int unitSize, bool square)
 {
-	size = size_;
-	map.resize (size.x() * size.y());
-	reset();
+	constexpr int maxTableRange = 64;
+	const auto getIndex = [] (int range, int unitSize, bool square) {
+		return (range * 2 + (unitSize - 1)) * 2 + square;
+	};
+	static const std::vector<sFootprint> table = [&] {
+		std::vector<sFootprint> footprints ((maxTableRange + 1) * 2 * 2);
+		for (int r = 0; r <= maxTableRange; ++r)
+		{
+			for (int size = 1; size <= 2; ++size)
+			{
+				footprints[getIndex (r, size, false)] = makeFootprint (r, size, false);
+				footprints[getIndex (r, size, true)] = makeFootprint (r, size, true);
+			}
+		}
+		return footprints;
+	}();
+	if (range >= 0 && range <= maxTableRange && (unitSize == 1 || unitSize == 2))
+	{
+		return table[getIndex (range, unitSize, square)];
+	}
+
+	thread_local std::map<std::tuple<int, int, bool>, sFootprint> footprints;
+	auto it = footprints.find ({range, unitSize, square});
+	if (it == footprints.end())
+	{
+		it = footprints.emplace (std::make_tuple (range, unitSize, square), makeFootprint (range, unitSize, square)).first;
+	}
+	return it->second;
 }
 
 //------------------------------------------------------------------------------
-void cRangeMap::add (int range, const cPosition& position, int unitSize, bool square /*= false*/)
+void cRangeMap::reset()
 {
+	// all positions in range go out of range
 	std::vector<cPosition> positions;
-
-	const int minx = std::max (position.x() - range, 0);
-	const int maxx = std::min (position.x() + range, size.x() - 1);
-	const int miny = std::max (position.y() - range, 0);
-	const int maxy = std::min (position.y() + range, size.y() - 1);
-
-	for (int x = minx; x <= maxx; ++x)
+	if (batchActive)
 	{
-		for (int y = miny; y <= maxy; ++y)
+		for (int y = 0; y < size.y(); ++y)
 		{
-			if (isInRange (x, y, position, range, unitSize, square))
+			for (int word = 0; word < wordsPerRow; ++word)
 			{
-				auto& value = map[getOffset (x, y)];
-				value++;
-				if (value == 1)
+				for (uint64_t wordBits = bits[y * wordsPerRow + word]; wordBits != 0; wordBits &= wordBits - 1)
 				{
-					positions.push_back (cPosition (x, y));
+					positions.emplace_back (word * 64 + std::countr_zero (wordBits), y);
 				}
 			}
 		}
 	}
-
-	positionsInRange (positions);
+	std::fill (map.begin(), map.end(), 0);
+	std::fill (bits.begin(), bits.end(), 0);
 	crcCache = std::nullopt;
-	changed();
+
+	if (batchActive) addToBatch (positions);
 }
 
 //------------------------------------------------------------------------------
-void cRangeMap::update (int range, const cPosition& oldPosition, const cPosition& newPosition, int oldUnitSize, int newUnitSize, bool square /*= false*/)
+void cRangeMap::resize (const cPosition& size_)
 {
-	std::vector<cPosition> inPositions;
-	std::vector<cPosition> outPositions;
+	size = size_;
+	map.resize (size.x() * size.y());
+	wordsPerRow = (size.x() + 63) / 64;
+	bits.resize (wordsPerRow * size.y());
+	reset();
+}
 
-	const int minx = std::max (std::min (oldPosition.x(), newPosition.x()) - range, 0);
-	const int maxx = std::min (std::max (oldPosition.x(), newPosition.x()) + range, size.x() - 1);
-	const int miny = std::max (std::min (oldPosition.y(), newPosition.y()) - range, 0);
-	const int maxy = std::min (std::max (oldPosition.y(), newPosition.y()) + range, size.y() - 1);
+//------------------------------------------------------------------------------
+void cRangeMap::beginBatch()
+{
+	assert (!batchActive);
+	batchActive = true;
+	batchDirtyBits.assign (bits.size(), 0);
+	batchDirtyPositions.clear();
+}
 
-	for (int x = minx; x <= maxx; ++x)
+//------------------------------------------------------------------------------
+/**
+* Marks the positions as dirty, which have not been changed in the current
+* batch before. Must be called after the status of the positions was toggled.
+*/
+void cRangeMap::addToBatch (const std::vector<cPosition>& transitions)
+{
+	for (const auto& position : transitions)
 	{
-		for (int y = miny; y <= maxy; ++y)
-		{
-			bool newInRange = isInRange (x, y, newPosition, range, newUnitSize, square);
-			bool oldInRange = isInRange (x, y, oldPosition, range, oldUnitSize, square);
+		auto& dirtyWord = batchDirtyBits[position.y() * wordsPerRow + position.x() / 64];
+		const uint64_t mask = uint64_t (1) << (position.x() % 64);
+		if (dirtyWord & mask) continue;
 
-			if (newInRange && !oldInRange)
-			{
-				auto& value = map[getOffset (x, y)];
-				++value;
-				if (value == 1)
-				{
-					inPositions.push_back (cPosition (x, y));
-				}
-			}
-			else if (!newInRange && oldInRange)
-			{
-				auto& value = map[getOffset (x, y)];
-				assert (value > 0);
-				--value;
-				if (value == 0)
-				{
-					outPositions.push_back (cPosition (x, y));
-				}
-			}
-		}
+		dirtyWord |= mask;
+		batchDirtyPositions.push_back ({position, !get (position)});
 	}
-
-	positionsInRange (inPositions);
-	positionsOutOfRange (outPositions);
-	crcCache = std::nullopt;
-	changed();
 }
 
 //------------------------------------------------------------------------------
-void cRangeMap::update (int oldRange, int newRange, const cPosition& position, int unitSize, bool square /*= false*/)
+void cRangeMap::commitBatch()
 {
+	assert (batchActive);
+	batchActive = false;
+
 	std::vector<cPosition> inPositions;
 	std::vector<cPosition> outPositions;
-
-	const int maxRange = std::max (oldRange, newRange);
-	const int minx = std::max (position.x() - maxRange, 0);
-	const int maxx = std::min (position.x() + maxRange, size.x() - 1);
-	const int miny = std::max (position.y() - maxRange, 0);
-	const int maxy = std::min (position.y() + maxRange, size.y() - 1);
-
-	for (int x = minx; x <= maxx; ++x)
+	for (const auto& [position, wasInRange] : batchDirtyPositions)
 	{
-		for (int y = miny; y <= maxy; ++y)
-		{
-			bool newInRange = isInRange (x, y, position, newRange, unitSize, square);
-			bool oldInRange = isInRange (x, y, position, oldRange, unitSize, square);
+		batchDirtyBits[position.y() * wordsPerRow + position.x() / 64] = 0;
 
-			if (newInRange && !oldInRange)
-			{
-				auto& value = map[getOffset (x, y)];
-				++value;
-				if (value == 1)
-				{
-					inPositions.push_back (cPosition (x, y));
-				}
-			}
-			else if (!newInRange && oldInRange)
-			{
-				auto& value = map[getOffset (x, y)];
-				assert (value > 0);
-				--value;
-				if (value == 0)
-				{
-					outPositions.push_back (cPosition (x, y));
-				}
-			}
-		}
+		const bool inRange = get (position);
+		if (inRange && !wasInRange)
+			inPositions.push_back (position);
+		else if (!inRange && wasInRange)
+			outPositions.push_back (position);
 	}
+	batchDirtyPositions.clear();
+	notify (inPositions, outPositions, true, true);
+}
 
-	positionsInRange (inPositions);
-	positionsOutOfRange (outPositions);
+//------------------------------------------------------------------------------
+void cRangeMap::notify (const std::vector<cPosition>& inPositions, const std::vector<cPosition>& outPositions, bool notifyIn, bool notifyOut)
+{
 	crcCache = std::nullopt;
+	if (batchActive)
+	{
+		addToBatch (inPositions);
+		addToBatch (outPositions);
+		return;
+	}
+	if (notifyIn) positionsInRange (inPositions);
+	if (notifyOut) positionsOutOfRange (outPositions);
 	changed();
 }
 
 //------------------------------------------------------------------------------
-void cRangeMap::remove (int range, const cPosition& position, int unitSize, bool square /*= false*/)
+void cRangeMap::add (int range, const cPosition& position, int unitSize, bool square /*= false*/)
 {
 	std::vector<cPosition> positions;
+	std::vector<cPosition> outPositions;
 
-	const int minx = std::max (position.x() - range, 0);
-	const int maxx = std::min (position.x() + range, size.x() - 1);
-	const int miny = std::max (position.y() - range, 0);
-	const int maxy = std::min (position.y() + range, size.y() - 1);
-
-	for (int x = minx; x <= maxx; ++x)
-	{
-		for (int y = miny; y <= maxy; ++y)
-		{
-			if (isInRange (x, y, position, range, unitSize, square))
-			{
-				auto& value = map[getOffset (x, y)];
-				--value;
-				if (value == 0)
-				{
-					positions.push_back (cPosition (x, y));
-				}
-			}
-		}
-	}
+	apply (nullptr, position, &getFootprint (range, unitSize, square), position, positions, outPositions);
+	assert (outPositions.empty());
 
-	positionsOutOfRange (positions);
-	crcCache = std::nullopt;
-	changed();
+	notify (positions, outPositions, true, false);
 }
 
 //------------------------------------------------------------------------------
-bool cRangeMap::get (const cPosition& position) const
+void cRangeMap::update (int range, const cPosition& oldPosition, const cPosition& newPosition, int oldUnitSize, int newUnitSize, bool square /*= false*/)
 {
-	if (position.x() < 0 || position.x() >= size.x()) return false;
-	if (position.y() < 0 || position.y() >= size.y()) return false;
+	std::vector<cPosition> inPositions;
+	std::vector<cPosition> outPositions;
+
+	apply (&getFootprint (range, oldUnitSize, square), oldPosition, &getFootprint (range, newUnitSize, square), newPosition, inPositions, outPositions);
 
-	return map[getOffset (position.x(), position.y())] > 0;
+	notify (inPositions, outPositions, true, true);
 }
 
 //------------------------------------------------------------------------------
-uint32_t cRangeMap::getChecksum (uint32_t crc) const
+void cRangeMap::update (int oldRange, int newRange, const cPosition& position, int unitSize, bool square /*= false*/)
 {
-	if (!crcCache)
-	{
-		crcCache = calcCheckSum (map, 0);
-	}
+	std::vector<cPosition> inPositions;
+	std::vector<cPosition> outPositions;
 
-	return calcCheckSum (*crcCache, crc);
+	apply (&getFootprint (oldRange, unitSize, square), position, &getFootprint (newRange, unitSize, square), position, inPositions, outPositions);
+
+	notify (inPositions, outPositions, true, true);
 }
 
 //------------------------------------------------------------------------------
-void cRangeMap::subtract (const std::vector<uint16_t>& data)
+void cRangeMap::remove (int range, const cPosition& position, int unitSize, bool square /*= false*/)
 {
-	assert (map.size() == data.size());
-
+	std::vector<cPosition> inPositions;
 	std::vector<cPosition> positions;
 
-	for (size_t i = 0; i < data.size(); i++)
+	apply (&getFootprint (range, unitSize, square), position, nullptr, position, inPositions, positions);
+	assert (inPositions.empty());
+
+	notify (inPositions, positions, false, true);
+}
+
+//------------------------------------------------------------------------------
+/**
+* Removes the old footprint and adds the new footprint (each may be nullptr).
+* Only the positions covered by exactly one of both footprints are touched.
+*/
+void cRangeMap::apply (const sFootprint* oldFootprint, const cPosition& oldPosition, const sFootprint* newFootprint, const cPosition& newPosition, std::vector<cPosition>& inPositions, std::vector<cPosition>& outPositions)
+{
+	const auto getSpan = [this] (const sFootprint* footprint, const cPosition& position, int y) {
+		sFootprint::sSpan span;
+		if (footprint == nullptr) return span;
+		const int row = y - position.y() - footprint->firstY;
+		if (row < 0 || row >= static_cast<int> (footprint->rows.size())) return span;
+		span.firstX = std::max (footprint->rows[row].firstX + position.x(), 0);
+		span.lastX = std::min (footprint->rows[row].lastX + position.x(), size.x() - 1);
+		return span;
+	};
+
+	int minY = size.y();
+	int maxY = -1;
+	for (const auto& [footprint, position] : {std::pair (oldFootprint, oldPosition), std::pair (newFootprint, newPosition)})
 	{
-		auto oldValue = map[i];
-		map[i] = narrow_cast<std::uint16_t> (std::max (oldValue - data[i], 0));
-		if (map[i] == 0 && oldValue > 0)
-		{
-			positions.push_back (cPosition (i % size.x(), i / size.x()));
-		}
+		if (footprint == nullptr) continue;
+		minY = std::min (minY, position.y() + footprint->firstY);
+		maxY = std::max (maxY, position.y() + footprint->firstY + static_cast<int> (footprint->rows.size()) - 1);
 	}
+	minY = std::max (minY, 0);
+	maxY = std::min (maxY, size.y() - 1);
 
-	positionsOutOfRange (positions);
-	crcCache = std::nullopt;
-	changed();
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const auto oldSpan = getSpan (oldFootprint, oldPosition, y);
+		const auto newSpan = getSpan (newFootprint, newPosition, y);
+
+		forEachDifference (newSpan.firstX, newSpan.lastX, oldSpan.firstX, oldSpan.lastX, [&] (int firstX, int lastX) {
+			changeSpan (y, firstX, lastX, 1, inPositions);
+		});
+		forEachDifference (oldSpan.firstX, oldSpan.lastX, newSpan.firstX, newSpan.lastX, [&] (int firstX, int lastX) {
+			changeSpan (y, firstX, lastX, -1, outPositions);
+		});
+	}
 }
 
 //------------------------------------------------------------------------------
-bool cRangeMap::isInRange (int x, int y, const cPosition& position, int range, int unitSize, bool square) const
+void cRangeMap::changeSpan (int y, int firstX, int lastX, int delta, std::vector<cPosition>& transitions)
 {
-	// calc distance from center of unit.
-	// to prevent fractional numbers, store the double distance
-	cPosition delta2x = (cPosition (x, y) - position) * 2 - unitSize + 1;
-
-	if (square)
+	uint16_t* row = map.data() + getOffset (0, y);
+	if (delta > 0)
 	{
-		return delta2x.abs().max() <= 2 * range;
+		for (int x = firstX; x <= lastX; ++x)
+			++row[x];
 	}
 	else
 	{
-		return delta2x.l2NormSquared() <= 4 * range * range;
+		for (int x = firstX; x <= lastX; ++x)
+		{
+			assert (row[x] > 0);
+			--row[x];
+		}
 	}
+	updateBits (y, firstX, lastX, transitions);
 }
 
 //------------------------------------------------------------------------------
-int cRangeMap::getOffset (int x, int y) const
+/**
+* Recalculates the bit mask for the given span
+* and collects all positions, which bits have been changed
+*/
+void cRangeMap::updateBits (int y, int firstX, int lastX, std::vector<cPosition>& transitions)
 {
-	return x + y * size.x();
+	const uint16_t* row = map.data() + getOffset (0, y);
+	uint64_t* bitRow = bits.data() + y * wordsPerRow;
+
+	for (int x = firstX; x <= lastX;)
+	{
+		const int word = x / 64;
+		const int wordStart = word * 64;
+		const int first = x - wordStart;
+		const int last = std::min (lastX, wordStart + 63) - wordStart;
+
+		uint64_t newBits = 0;
+		for (int i = first; i <= last; ++i)
+			newBits |= uint64_t (row[wordStart + i] != 0) << i;
+
+		const uint64_t spanMask = (last == 63 ? ~uint64_t (0) : (uint64_t (1) << (last + 1)) - 1) & ~((uint64_t (1) << first) - 1);
+		uint64_t changedBits = (bitRow[word] & spanMask) ^ newBits;
+		bitRow[word] = (bitRow[word] & ~spanMask) | newBits;
+
+		while (changedBits != 0)
+		{
+			transitions.emplace_back (wordStart + std::countr_zero (changedBits), y);
+			changedBits &= changedBits - 1;
+		}
+		x = wordStart + last + 1;
+	}
 }
 
 //------------------------------------------------------------------------------
-std::vector<uint16_t> cRangeMap::getMap() const
+bool cRangeMap::get (const cPosition& position) const
 {
-	return map;
+	if (position.x() < 0 || position.x() >= size.x()) return false;
+	if (position.y() < 0 || position.y() >= size.y()) return false;
+
+	return (bits[position.y() * wordsPerRow + position.x() / 64] >> (position.x() % 64)) & 1;
+}
+
+//------------------------------------------------------------------------------
+uint32_t cRangeMap::getChecksum (uint32_t crc) const
+{
+	if (!crcCache)
+	{
+		crcCache = calcCheckSum (map, 0);
+	}
+
+	return calcCheckSum (*crcCache, crc);
+}
+
+//------------------------------------------------------------------------------
+int cRangeMap::getOffset (int x, int y) const
+{
+	return x + y * size.x();
 }
@@ -29,6 +29,9 @@
 /**
 * This class is used to track, whether a position is a specific range to any
 * object on the map.
+* For each position a counter of objects in range is stored. Additionally
+* a bit mask (one bit per position, packed in 64 bit words per row) caches,
+* which counters are non zero.
 */
 class cRangeMap
 {
@@ -37,7 +40,17 @@ public:
 
 	void reset();
 	void resize (const cPosition& size);
-	void subtract (const std::vector<uint16_t>& scanMapCopy);
+
+	/**
+	* Starts a batch update. Until commitBatch() is called, no signals are
+	* triggered. Instead the positions, that changed their status are collected.
+	*/
+	void beginBatch();
+	/**
+	* Ends the batch update and triggers the signals for all positions,
+	* which status differs from the status before beginBatch().
+	*/
+	void commitBatch();
 
 	void add (int range, const cPosition& position, int unitSize, bool square = false);
 	void update (int range, const cPosition& oldPosition, const cPosition& newPosition, int oldUnitSize, int newUnitSize, bool square = false);
@@ -48,7 +61,14 @@ public:
 	bool get (const cPosition& position) const;
 
 	/** returns access to the full map */
-	std::vector<uint16_t> getMap() const;
+	const std::vector<uint16_t>& getMap() const { return map; }
+	const cPosition& getSize() const { return size; }
+	/**
+	 * returns the in-range bit mask. Every row starts at a new 64 bit word,
+	 * column x of row y is bit (x % 64) of word y * getWordsPerRow() + x / 64
+	 */
+	const std::vector<uint64_t>& getBits() const { return bits; }
+	int getWordsPerRow() const { return wordsPerRow; }
 
 	uint32_t getChecksum (uint32_t crc) const;
 
@@ -59,11 +79,31 @@ public:
 	mutable cSignal<void()> changed;
 
 private:
-	bool isInRange (int x, int y, const cPosition&, int range, int unitSize, bool square) const;
+	struct sFootprint;
+
+	static sFootprint makeFootprint (int range, int unitSize, bool square);
+	static const sFootprint& getFootprint (int range, int unitSize, bool square);
+
+	void apply (const sFootprint* oldFootprint, const cPosition& oldPosition, const sFootprint* newFootprint, const cPosition& newPosition, std::vector<cPosition>& inPositions, std::vector<cPosition>& outPositions);
+	void changeSpan (int y, int firstX, int lastX, int delta, std::vector<cPosition>& transitions);
+	void updateBits (int y, int firstX, int lastX, std::vector<cPosition>& transitions);
+	void addToBatch (const std::vector<cPosition>& transitions);
+	void notify (const std::vector<cPosition>& inPositions, const std::vector<cPosition>& outPositions, bool notifyIn, bool notifyOut);
 	int getOffset (int x, int y) const;
 
 	cPosition size;
 	std::vector<uint16_t> map;
+	std::vector<uint64_t> bits;
+	int wordsPerRow = 0;
+
+	struct sBatchEntry
+	{
+		cPosition position;
+		bool wasInRange = false;
+	};
+	bool batchActive = false;
+	std::vector<uint64_t> batchDirtyBits;
+	std::vector<sBatchEntry> batchDirtyPositions; // all positions, which status changed at least once during the batch
 
 	mutable std::optional<uint32_t> crcCache;
 };
@@ -43,9 +43,8 @@
 namespace
 {
 	//--------------------------------------------------------------------------
-	std::optional<nlohmann::json> loadDocument (int slot)
+	std::optional<nlohmann::json> loadDocument (const std::filesystem::path& fileName)
 	{
-		const auto fileName = cSavegame::getFileName (slot);
 		std::ifstream file (fileName);
 		nlohmann::json json;
 		if (!(file >> json))
@@ -93,6 +92,16 @@ namespace
 
 } // namespace
 
+//------------------------------------------------------------------------------
+cSavegame::cSavegame() :
+	savesPath (cSettings::getInstance().getSavesPath())
+{}
+
+//------------------------------------------------------------------------------
+cSavegame::cSavegame (std::filesystem::path savesPath) :
+	savesPath (std::move (savesPath))
+{}
+
 //------------------------------------------------------------------------------
 void cSavegame::save (const cModel& model, int slot, const std::string& saveName) const
 {
@@ -106,7 +115,7 @@ void cSavegame::save (const cModel& model, int slot, const std::string& saveName
 	cJsonArchiveOut archiveCrc (json);
 	archiveCrc << serialization::makeNvp ("modelcrc", model.getChecksum());
 
-	std::filesystem::create_directories (cSettings::getInstance().getSavesPath());
+	std::filesystem::create_directories (savesPath);
 	{
 		std::ofstream file (getFileName (slot));
 		file << json.dump (2);
@@ -129,7 +138,7 @@ void cSavegame::save (const cModel& model, int slot, const std::string& saveName
 //------------------------------------------------------------------------------
 void cSavegame::saveGuiInfo (const cNetMessageGUISaveInfo& guiInfo) const
 {
-	auto json = loadDocument (guiInfo.slot);
+	auto json = loadDocument (getFileName (guiInfo.slot));
 	if (!json)
 	{
 		return;
@@ -138,7 +147,7 @@ void cSavegame::saveGuiInfo (const cNetMessageGUISaveInfo& guiInfo) const
 	archive << serialization::makeNvp ("playerNr", guiInfo.playerNr);
 	archive << serialization::makeNvp ("guiState", guiInfo.guiInfo);
 
-	std::filesystem::create_directories (cSettings::getInstance().getSavesPath());
+	std::filesystem::create_directories (savesPath);
 	int loadedSlot = guiInfo.slot;
 	std::ofstream file (getFileName (loadedSlot));
 	file << json->dump (2);
@@ -149,7 +158,7 @@ cSaveGameInfo cSavegame::loadSaveInfo (int slot) const
 {
 	cSaveGameInfo info (slot);
 
-	const auto& json = loadDocument (slot);
+	const auto& json = loadDocument (getFileName (slot));
 	if (!json)
 	{
 		info.gameName = "Load Error";
@@ -203,17 +212,17 @@ cSaveGameInfo cSavegame::loadSaveInfo (int slot) const
 }
 
 //------------------------------------------------------------------------------
-/*static*/ std::filesystem::path cSavegame::getFileName (int slot)
+std::filesystem::path cSavegame::getFileName (int slot) const
 {
 	char numberstr[4];
 	snprintf (numberstr, sizeof (numberstr), "%.3d", slot);
-	return cSettings::getInstance().getSavesPath() / (std::string ("Save") + numberstr + ".json");
+	return savesPath / (std::string ("Save") + numberstr + ".json");
 }
 
 //------------------------------------------------------------------------------
 void cSavegame::loadModel (cModel& model, int slot) const
 {
-	const auto& json = loadDocument (slot);
+	const auto& json = loadDocument (getFileName (slot));
 	if (!json)
 	{
 		throw std::runtime_error ("Could not load savegame file " + std::to_string (slot));
@@ -259,7 +268,7 @@ void cSavegame::loadModel (cModel& model, int slot) const
 //------------------------------------------------------------------------------
 void cSavegame::loadGuiInfo (const cServer* server, int slot, int playerNr) const
 {
-	const auto& json = loadDocument (slot);
+	const auto& json = loadDocument (getFileName (slot));
 	if (!json)
 	{
 		throw std::runtime_error ("Could not load savegame file " + std::to_string (slot));
@@ -281,10 +290,12 @@ void cSavegame::loadGuiInfo (const cServer* server, int slot, int playerNr) cons
 }
 
 //------------------------------------------------------------------------------
-void fillSaveGames (std::size_t minIndex, std::size_t maxIndex, std::vector<cSaveGameInfo>& saveGames)
+void cSavegame::fillSaveGames (std::size_t minIndex, std::size_t maxIndex, std::vector<cSaveGameInfo>& saveGames) const
 {
-	cSavegame savegame;
-	const auto saveFileNames = os::getFilesOfDirectory (cSettings::getInstance().getSavesPath());
+	// no save game written yet
+	if (!std::filesystem::is_directory (savesPath)) return;
+
+	const auto saveFileNames = os::getFilesOfDirectory (savesPath);
 	const std::regex savename_regex{R"(Save(\d{3})\.json)"};
 
 	for (const auto& filepath : saveFileNames)
@@ -299,7 +310,13 @@ void fillSaveGames (std::size_t minIndex, std::size_t maxIndex, std::vector<cSav
 		if (std::ranges::find_if (saveGames, [=] (const cSaveGameInfo& save) { return std::size_t (save.number) == number; }) != saveGames.end()) continue;
 
 		// read the information and add it to the saves list
-		cSaveGameInfo saveInfo = savegame.loadSaveInfo (number);
+		cSaveGameInfo saveInfo = loadSaveInfo (number);
 		saveGames.push_back (saveInfo);
 	}
 }
+
+//------------------------------------------------------------------------------
+void fillSaveGames (std::size_t minIndex, std::size_t maxIndex, std::vector<cSaveGameInfo>& saveGames)
+{
+	cSavegame().fillSaveGames (minIndex, maxIndex, saveGames);
+}
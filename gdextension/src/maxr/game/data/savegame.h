@@ -30,12 +30,18 @@ class cVersion;
 class cNetMessageGUISaveInfo;
 class cServer;
 
+/**
+ * Reads and writes the save files of one save directory.
+ */
 class cSavegame
 {
 public:
-	cSavegame() = default;
+	/** uses the save directory of the user settings */
+	cSavegame();
+	explicit cSavegame (std::filesystem::path savesPath);
 
-	static std::filesystem::path getFileName (int slot);
+	std::filesystem::path getFileName (int slot) const;
+	void fillSaveGames (std::size_t minIndex, std::size_t maxIndex, std::vector<cSaveGameInfo>&) const;
 
 	cSaveGameInfo loadSaveInfo (int slot) const;
 
@@ -44,6 +50,9 @@ public:
 
 	void loadGuiInfo (const cServer* server, int slot, int playerNr = -1) const;
 	void saveGuiInfo (const cNetMessageGUISaveInfo& guiInfo) const;
+
+private:
+	std::filesystem::path savesPath;
 };
 
 void fillSaveGames (std::size_t minIndex, std::size_t maxIndex, std::vector<cSaveGameInfo>&);
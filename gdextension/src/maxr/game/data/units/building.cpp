@@ -33,6 +33,7 @@
 #include "utility/random.h"
 
 #include <cmath>
+#include <utility>
 
 //------------------------------------------------------------------------------
 cBuildListItem::cBuildListItem (sID type_, int remainingMetal_) :
@@ -552,7 +553,7 @@ bool cBuilding::buildingCanBeStarted() const
 bool cBuilding::buildingCanBeUpgraded() const
 {
 	if (!getOwner()) return false;
-	const cDynamicUnitData& upgraded = *getOwner()->getLastUnitData (data.getId());
+	const cDynamicUnitData& upgraded = *std::as_const (*getOwner()).getLastUnitData (data.getId());
 	return data.canBeUpgradedTo (upgraded) && subBase && subBase->getResourcesStored().metal >= 2;
 }
 
@@ -23,6 +23,7 @@
 #include "game/data/map/mapview.h"
 #include "game/data/model.h"
 #include "game/data/player/player.h"
+#include "game/data/units/unitstore.h"
 #include "game/data/units/vehicle.h"
 #include "game/logic/attackjob.h"
 #include "utility/box.h"
@@ -58,12 +59,18 @@ cUnit::cUnit (const cDynamicUnitData* unitData, const cStaticUnitData* staticDat
 	manualFireChanged.connect ([this]() { statusChanged(); });
 	attackingChanged.connect ([this]() { statusChanged(); });
 	beingAttackedChanged.connect ([this]() { statusChanged(); });
+
+	data.changed.connect ([this]() {
+		if (unitStore) unitStore->updateData (unitStoreIndex, data);
+	});
 }
 
 //------------------------------------------------------------------------------
 cUnit::~cUnit()
 {
 	destroyed();
+
+	if (unitStore) unitStore->remove (*this);
 }
 
 //------------------------------------------------------------------------------
@@ -93,12 +100,15 @@ void cUnit::postLoad (cModel& model)
 		staticData = &model.getUnitsData()->getStaticUnitData (data.getId());
 	}
 	storedUnits = ranges::Transform (storedUnitIds, [&] (unsigned int id) { return model.getVehicleFromID (id); });
+
+	model.getUnitStore().add (*this);
 }
 
 //------------------------------------------------------------------------------
 void cUnit::setOwner (cPlayer* owner_)
 {
 	std::swap (owner, owner_);
+	if (unitStore) unitStore->setOwner (unitStoreIndex, owner ? owner->getId() : -1);
 	if (owner != owner_) ownerChanged();
 }
 
@@ -208,6 +218,7 @@ void cUnit::clearDetectedInThisTurnPlayerList()
 void cUnit::setPosition (cPosition position_)
 {
 	std::swap (position, position_);
+	if (unitStore) unitStore->setPosition (unitStoreIndex, position);
 	if (position != position_) positionChanged();
 }
 
@@ -422,6 +433,7 @@ void cUnit::upgradeToCurrentVersion()
 void cUnit::setDisabledTurns (int turns)
 {
 	std::swap (turnsDisabled, turns);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::Disabled, isDisabled());
 	if (turns != turnsDisabled) disabledChanged();
 }
 
@@ -429,6 +441,7 @@ void cUnit::setDisabledTurns (int turns)
 void cUnit::setSentryActive (bool value)
 {
 	std::swap (sentryActive, value);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::Sentry, sentryActive);
 	if (value != sentryActive) sentryChanged();
 }
 
@@ -436,6 +449,7 @@ void cUnit::setSentryActive (bool value)
 void cUnit::setManualFireActive (bool value)
 {
 	std::swap (manualFireActive, value);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::ManualFire, manualFireActive);
 	if (value != manualFireActive) manualFireChanged();
 }
 
@@ -443,6 +457,7 @@ void cUnit::setManualFireActive (bool value)
 void cUnit::setAttacking (bool value)
 {
 	std::swap (attacking, value);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::Attacking, attacking);
 	if (value != attacking) attackingChanged();
 }
 
@@ -450,6 +465,7 @@ void cUnit::setAttacking (bool value)
 void cUnit::setIsBeingAttacked (bool value)
 {
 	std::swap (beingAttacked, value);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::BeingAttacked, beingAttacked);
 	if (value != beingAttacked) beingAttackedChanged();
 }
 
@@ -457,6 +473,7 @@ void cUnit::setIsBeingAttacked (bool value)
 void cUnit::setHasBeenAttacked (bool value)
 {
 	std::swap (beenAttacked, value);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::BeenAttacked, beenAttacked);
 	if (value != beenAttacked) beenAttackedChanged();
 }
 
@@ -36,6 +36,7 @@ class cMapField;
 class cMapView;
 class cModel;
 class cPlayer;
+class cUnitStore;
 class cVehicle;
 
 template <typename>
@@ -59,6 +60,8 @@ enum eTerrainFlag
 //-----------------------------------------------------------------------------
 class cUnit
 {
+	friend class cUnitStore;
+
 protected:
 	cUnit (const cDynamicUnitData* unitData, const cStaticUnitData* staticData, cPlayer* owner, unsigned int ID);
 
@@ -271,6 +274,10 @@ private:
 	bool beingAttacked = false; ///< true when an attack on this unit is running
 	bool beenAttacked = false; //the unit was attacked in this turn
 	int storageResCur = 0; //amount of stored resources
+
+protected:
+	cUnitStore* unitStore = nullptr; // the store of the model, this unit belongs to
+	std::size_t unitStoreIndex = 0;
 };
 
 template <typename T>
@@ -22,8 +22,10 @@
 #include "game/data/player/clans.h"
 #include "utility/crc.h"
 #include "utility/log.h"
+#include "utility/serialization/binaryarchive.h"
 
 #include <algorithm>
+#include <mutex>
 
 cUnitsData UnitsDataGlobal;
 
@@ -420,7 +422,11 @@ int cDynamicUnitData::getBuildCost() const
 void cDynamicUnitData::setBuildCost (int value)
 {
 	std::swap (buildCosts, value);
-	if (buildCosts != value) buildCostsChanged();
+	if (buildCosts != value)
+	{
+		buildCostsChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -458,7 +464,11 @@ void cDynamicUnitData::markLastVersionUsed()
 void cDynamicUnitData::setVersion (int value)
 {
 	std::swap (version, value);
-	if (version != value) versionChanged();
+	if (version != value)
+	{
+		versionChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -472,7 +482,11 @@ int cDynamicUnitData::getSpeed() const
 void cDynamicUnitData::setSpeed (int value)
 {
 	std::swap (speedCur, value);
-	if (speedCur != value) speedChanged();
+	if (speedCur != value)
+	{
+		speedChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -486,7 +500,11 @@ int cDynamicUnitData::getSpeedMax() const
 void cDynamicUnitData::setSpeedMax (int value)
 {
 	std::swap (speedMax, value);
-	if (speedMax != value) speedMaxChanged();
+	if (speedMax != value)
+	{
+		speedMaxChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -500,7 +518,11 @@ int cDynamicUnitData::getHitpoints() const
 void cDynamicUnitData::setHitpoints (int value)
 {
 	std::swap (hitpointsCur, value);
-	if (hitpointsCur != value) hitpointsChanged();
+	if (hitpointsCur != value)
+	{
+		hitpointsChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -514,7 +536,11 @@ int cDynamicUnitData::getHitpointsMax() const
 void cDynamicUnitData::setHitpointsMax (int value)
 {
 	std::swap (hitpointsMax, value);
-	if (hitpointsMax != value) hitpointsMaxChanged();
+	if (hitpointsMax != value)
+	{
+		hitpointsMaxChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -528,7 +554,11 @@ int cDynamicUnitData::getScan() const
 void cDynamicUnitData::setScan (int value)
 {
 	std::swap (scan, value);
-	if (scan != value) scanChanged();
+	if (scan != value)
+	{
+		scanChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -542,7 +572,11 @@ int cDynamicUnitData::getRange() const
 void cDynamicUnitData::setRange (int value)
 {
 	std::swap (range, value);
-	if (range != value) rangeChanged();
+	if (range != value)
+	{
+		rangeChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -556,7 +590,11 @@ int cDynamicUnitData::getShots() const
 void cDynamicUnitData::setShots (int value)
 {
 	std::swap (shotsCur, value);
-	if (shotsCur != value) shotsChanged();
+	if (shotsCur != value)
+	{
+		shotsChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -570,7 +608,11 @@ int cDynamicUnitData::getShotsMax() const
 void cDynamicUnitData::setShotsMax (int value)
 {
 	std::swap (shotsMax, value);
-	if (shotsMax != value) shotsMaxChanged();
+	if (shotsMax != value)
+	{
+		shotsMaxChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -584,7 +626,11 @@ int cDynamicUnitData::getAmmo() const
 void cDynamicUnitData::setAmmo (int value)
 {
 	std::swap (ammoCur, value);
-	if (ammoCur != value) ammoChanged();
+	if (ammoCur != value)
+	{
+		ammoChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -598,7 +644,11 @@ int cDynamicUnitData::getAmmoMax() const
 void cDynamicUnitData::setAmmoMax (int value)
 {
 	std::swap (ammoMax, value);
-	if (ammoMax != value) ammoMaxChanged();
+	if (ammoMax != value)
+	{
+		ammoMaxChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -612,7 +662,11 @@ int cDynamicUnitData::getDamage() const
 void cDynamicUnitData::setDamage (int value)
 {
 	std::swap (damage, value);
-	if (damage != value) damageChanged();
+	if (damage != value)
+	{
+		damageChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -626,7 +680,11 @@ int cDynamicUnitData::getArmor() const
 void cDynamicUnitData::setArmor (int value)
 {
 	std::swap (armor, value);
-	if (armor != value) armorChanged();
+	if (armor != value)
+	{
+		armorChanged();
+		changed();
+	}
 	crcCache = std::nullopt;
 }
 
@@ -657,6 +715,27 @@ uint32_t cDynamicUnitData::getChecksum (uint32_t crc) const
 	return calcCheckSum (*crcCache, crc);
 }
 
+//------------------------------------------------------------------------------
+bool cDynamicUnitData::operator== (const cDynamicUnitData& other) const
+{
+	return id == other.id
+	    && buildCosts == other.buildCosts
+	    && version == other.version
+	    && dirtyVersion == other.dirtyVersion
+	    && speedCur == other.speedCur
+	    && speedMax == other.speedMax
+	    && hitpointsCur == other.hitpointsCur
+	    && hitpointsMax == other.hitpointsMax
+	    && shotsCur == other.shotsCur
+	    && shotsMax == other.shotsMax
+	    && ammoCur == other.ammoCur
+	    && ammoMax == other.ammoMax
+	    && range == other.range
+	    && scan == other.scan
+	    && damage == other.damage
+	    && armor == other.armor;
+}
+
 //------------------------------------------------------------------------------
 void cDynamicUnitData::setMaximumCurrentValues()
 {
@@ -667,3 +746,79 @@ void cDynamicUnitData::setMaximumCurrentValues()
 
 	crcCache = std::nullopt;
 }
+
+// cUnitsDataCache //////////////////////////////////////////////////
+
+namespace
+{
+	std::mutex unitsDataCacheMutex;
+	std::vector<std::pair<uint32_t, std::weak_ptr<const cUnitsData>>> unitsDataCache;
+
+	//--------------------------------------------------------------------------
+	void fillChecksumCaches (const cUnitsData& unitsData)
+	{
+		for (int clan = -1; clan != static_cast<int> (unitsData.getNrOfClans()); ++clan)
+		{
+			for (const auto& data : unitsData.getDynamicUnitsData (clan))
+			{
+				[[maybe_unused]] const auto crc = data.getChecksum (0);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	std::vector<unsigned char> toBuffer (const cUnitsData& unitsData)
+	{
+		std::vector<unsigned char> buffer;
+		cBinaryArchiveOut archive (buffer);
+		archive << unitsData;
+		return buffer;
+	}
+} // namespace
+
+//------------------------------------------------------------------------------
+std::shared_ptr<const cUnitsData> cUnitsDataCache::share (std::shared_ptr<const cUnitsData> unitsData)
+{
+	if (unitsData == nullptr) return nullptr;
+
+	// the shared data must not be written anymore, when used by several threads.
+	// So fill the lazy checksum caches now.
+	fillChecksumCaches (*unitsData);
+	const auto checksum = unitsData->getChecksum (0);
+
+	std::unique_lock<std::mutex> lock (unitsDataCacheMutex);
+	std::erase_if (unitsDataCache, [] (const auto& entry) { return entry.second.expired(); });
+
+	std::optional<std::vector<unsigned char>> buffer;
+	for (const auto& [crc, weakUnitsData] : unitsDataCache)
+	{
+		if (crc != checksum) continue;
+		auto cached = weakUnitsData.lock();
+		if (cached == nullptr) continue;
+		if (cached == unitsData) return cached;
+
+		// the checksum is no proof for equal content
+		if (!buffer) buffer = toBuffer (*unitsData);
+		if (*buffer == toBuffer (*cached))
+		{
+			return cached;
+		}
+	}
+	unitsDataCache.emplace_back (checksum, unitsData);
+	return unitsData;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<const cUnitsData> cUnitsDataCache::find (uint32_t checksum)
+{
+	std::unique_lock<std::mutex> lock (unitsDataCacheMutex);
+	for (const auto& [crc, weakUnitsData] : unitsDataCache)
+	{
+		if (crc != checksum) continue;
+		if (auto cached = weakUnitsData.lock())
+		{
+			return cached;
+		}
+	}
+	return nullptr;
+}
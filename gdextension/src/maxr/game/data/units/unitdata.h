@@ -25,6 +25,7 @@
 #include "utility/serialization/serialization.h"
 #include "utility/signal/signal.h"
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -325,6 +326,7 @@ public:
 	void setVersion (int value);
 
 	bool canBeUpgradedTo (const cDynamicUnitData&) const;
+	bool isVersionDirty() const { return dirtyVersion; }
 	void makeVersionDirty();
 	void markLastVersionUsed();
 
@@ -366,6 +368,9 @@ public:
 
 	uint32_t getChecksum (uint32_t crc) const;
 
+	/** compares the unit values. Signals are not compared */
+	bool operator== (const cDynamicUnitData&) const;
+
 	mutable cSignal<void()> buildCostsChanged;
 	mutable cSignal<void()> versionChanged;
 	mutable cSignal<void()> speedChanged;
@@ -380,6 +385,8 @@ public:
 	mutable cSignal<void()> rangeChanged;
 	mutable cSignal<void()> damageChanged;
 	mutable cSignal<void()> armorChanged;
+	/** Triggered after any of the signals above */
+	mutable cSignal<void()> changed;
 
 	template <ArchiveInOrOut Archive>
 	void serialize (Archive& archive)
@@ -585,6 +592,25 @@ private:
 	mutable std::optional<uint32_t> crcCache;
 };
 
+/**
+* Shares immutable units data between models, players and games.
+* Units data is identified by its checksum,
+* so equal units data received or loaded several times
+* is kept only once in memory.
+*/
+class cUnitsDataCache
+{
+public:
+	/**
+	* returns the already shared units data with the same content as unitsData
+	* or registers unitsData as shared data, if there is none.
+	* The shared units data must not be modified anymore.
+	*/
+	static std::shared_ptr<const cUnitsData> share (std::shared_ptr<const cUnitsData> unitsData);
+	/** returns the shared units data with the given checksum or nullptr */
+	static std::shared_ptr<const cUnitsData> find (uint32_t checksum);
+};
+
 extern cUnitsData UnitsDataGlobal;
 
 #endif // game_data_units_unitdataH
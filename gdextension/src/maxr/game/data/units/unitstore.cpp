@@ -0,0 +1,147 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/data/units/unitstore.h"
+
+#include "game/data/player/player.h"
+#include "game/data/units/unit.h"
+#include "game/data/units/unitdata.h"
+#include "game/data/units/vehicle.h"
+
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+cUnitStore::~cUnitStore()
+{
+	for (auto* unit : units)
+	{
+		unit->unitStore = nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------
+void cUnitStore::add (cUnit& unit)
+{
+	if (unit.unitStore == this)
+	{
+		update (unit.unitStoreIndex);
+		return;
+	}
+	if (unit.unitStore)
+	{
+		unit.unitStore->remove (unit);
+	}
+
+	const std::size_t index = std::upper_bound (ids.begin(), ids.end(), unit.getId()) - ids.begin();
+	insertAt (index);
+	units[index] = &unit;
+	ids[index] = unit.getId();
+	unit.unitStore = this;
+	updateIndices (index);
+	update (index);
+}
+
+//------------------------------------------------------------------------------
+void cUnitStore::remove (cUnit& unit)
+{
+	if (unit.unitStore != this) return;
+
+	const std::size_t index = unit.unitStoreIndex;
+	eraseAt (index);
+	unit.unitStore = nullptr;
+	updateIndices (index);
+}
+
+//------------------------------------------------------------------------------
+void cUnitStore::update (std::size_t index)
+{
+	const cUnit& unit = *units[index];
+
+	owners[index] = unit.getOwner() ? unit.getOwner()->getId() : -1;
+	positions[index] = unit.getPosition();
+
+	flags[index] = 0;
+	setFlag (index, Vehicle, unit.isAVehicle());
+	setFlag (index, Big, unit.getIsBig());
+	setFlag (index, CanAttack, unit.getStaticUnitData().canAttack != eTerrainFlag::None);
+	setFlag (index, Sentry, unit.isSentryActive());
+	setFlag (index, ManualFire, unit.isManualFireActive());
+	setFlag (index, Attacking, unit.isAttacking());
+	setFlag (index, BeingAttacked, unit.isBeingAttacked());
+	setFlag (index, BeenAttacked, unit.hasBeenAttacked());
+	setFlag (index, Disabled, unit.isDisabled());
+	if (unit.isAVehicle())
+	{
+		const auto& vehicle = static_cast<const cVehicle&> (unit);
+		setFlag (index, Moving, vehicle.isUnitMoving());
+		setFlag (index, Loaded, vehicle.isUnitLoaded());
+	}
+
+	updateData (index, unit.data);
+}
+
+//------------------------------------------------------------------------------
+void cUnitStore::updateData (std::size_t index, const cDynamicUnitData& data)
+{
+	hitpoints[index] = data.getHitpoints();
+	hitpointsMax[index] = data.getHitpointsMax();
+	speed[index] = data.getSpeed();
+	speedMax[index] = data.getSpeedMax();
+	shots[index] = data.getShots();
+	ammo[index] = data.getAmmo();
+	range[index] = data.getRange();
+	scan[index] = data.getScan();
+}
+
+//------------------------------------------------------------------------------
+void cUnitStore::insertAt (std::size_t index)
+{
+	units.insert (units.begin() + index, nullptr);
+	ids.insert (ids.begin() + index, 0);
+	owners.insert (owners.begin() + index, -1);
+	positions.insert (positions.begin() + index, cPosition());
+	flags.insert (flags.begin() + index, 0);
+	for (auto* values : {&hitpoints, &hitpointsMax, &speed, &speedMax, &shots, &ammo, &range, &scan})
+	{
+		values->insert (values->begin() + index, 0);
+	}
+}
+
+//------------------------------------------------------------------------------
+void cUnitStore::eraseAt (std::size_t index)
+{
+	units.erase (units.begin() + index);
+	ids.erase (ids.begin() + index);
+	owners.erase (owners.begin() + index);
+	positions.erase (positions.begin() + index);
+	flags.erase (flags.begin() + index);
+	for (auto* values : {&hitpoints, &hitpointsMax, &speed, &speedMax, &shots, &ammo, &range, &scan})
+	{
+		values->erase (values->begin() + index);
+	}
+}
+
+//------------------------------------------------------------------------------
+void cUnitStore::updateIndices (std::size_t first)
+{
+	for (std::size_t i = first; i != units.size(); ++i)
+	{
+		units[i]->unitStoreIndex = i;
+	}
+}
@@ -0,0 +1,169 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_data_units_unitstoreH
+#define game_data_units_unitstoreH
+
+#include "utility/mathtools.h"
+#include "utility/position.h"
+
+#include <cstdint>
+#include <vector>
+
+class cDynamicUnitData;
+class cUnit;
+
+/**
+ * Structure of arrays with the frequently read state of all units of a model.
+ *
+ * Passes over many units (e.g. the search for reaction fire) only need a few
+ * fields of each unit. They can filter the units on these dense arrays and only
+ * touch the unit objects of the remaining candidates.
+ *
+ * The unit objects stay authoritative. Every attached unit writes each change
+ * of a stored field through to its entry. The entries are ordered by unit id,
+ * so filtering the store visits the units of a player in the same order as
+ * cPlayer::getVehicles() and cPlayer::getBuildings().
+ */
+class cUnitStore
+{
+	friend class cUnit;
+	friend class cVehicle;
+
+public:
+	enum eFlag : std::uint16_t
+	{
+		Vehicle = 1 << 0,
+		Big = 1 << 1,
+		CanAttack = 1 << 2, ///< the unit has a weapon
+		Sentry = 1 << 3,
+		ManualFire = 1 << 4,
+		Attacking = 1 << 5,
+		BeingAttacked = 1 << 6,
+		BeenAttacked = 1 << 7,
+		Disabled = 1 << 8,
+		Moving = 1 << 9,
+		Loaded = 1 << 10
+	};
+
+	cUnitStore() = default;
+	cUnitStore (const cUnitStore&) = delete;
+	cUnitStore& operator= (const cUnitStore&) = delete;
+	~cUnitStore();
+
+	/** Adds the unit or refreshes its entry, when it is already attached to this store */
+	void add (cUnit&);
+	void remove (cUnit&);
+
+	std::size_t size() const { return units.size(); }
+	cUnit& getUnit (std::size_t index) const { return *units[index]; }
+
+	const std::vector<unsigned int>& getIds() const { return ids; }
+	/** player ids. -1 for neutral units */
+	const std::vector<int>& getOwners() const { return owners; }
+	const std::vector<cPosition>& getPositions() const { return positions; }
+	const std::vector<std::uint16_t>& getFlags() const { return flags; }
+	const std::vector<int>& getHitpoints() const { return hitpoints; }
+	const std::vector<int>& getHitpointsMax() const { return hitpointsMax; }
+	const std::vector<int>& getSpeed() const { return speed; }
+	const std::vector<int>& getSpeedMax() const { return speedMax; }
+	const std::vector<int>& getShots() const { return shots; }
+	const std::vector<int>& getAmmo() const { return ammo; }
+	const std::vector<int>& getRange() const { return range; }
+	const std::vector<int>& getScan() const { return scan; }
+
+	/**
+	 * Returns the first unit of the player, that may be able to fire at the target position
+	 * and for which predicate returns true.
+	 * Only units, whose flags masked by flagMask equal flagValues, are considered.
+	 * The store checks, that the unit has a weapon, shots and ammo left,
+	 * is not attacking, being attacked, moving or loaded and that the target is in range.
+	 */
+	template <typename Predicate>
+	cUnit* findArmedUnit (int playerId, std::uint16_t flagMask, std::uint16_t flagValues, const cPosition& target, Predicate&& predicate) const;
+
+	/**
+	 * Returns the first unit of the player within radius around center,
+	 * for which predicate returns true.
+	 */
+	template <typename Predicate>
+	cUnit* findUnitInRange (int playerId, const cPosition& center, int radius, Predicate&& predicate) const;
+
+private:
+	void update (std::size_t index);
+	void updateData (std::size_t index, const cDynamicUnitData&);
+	void setOwner (std::size_t index, int playerId) { owners[index] = playerId; }
+	void setPosition (std::size_t index, const cPosition& position) { positions[index] = position; }
+	void setFlag (std::size_t index, eFlag flag, bool value)
+	{
+		flags[index] = value ? (flags[index] | flag) : (flags[index] & ~flag);
+	}
+
+	void insertAt (std::size_t index);
+	void eraseAt (std::size_t index);
+	void updateIndices (std::size_t first);
+
+private:
+	std::vector<cUnit*> units;
+	std::vector<unsigned int> ids;
+	std::vector<int> owners;
+	std::vector<cPosition> positions;
+	std::vector<std::uint16_t> flags;
+	std::vector<int> hitpoints;
+	std::vector<int> hitpointsMax;
+	std::vector<int> speed;
+	std::vector<int> speedMax;
+	std::vector<int> shots;
+	std::vector<int> ammo;
+	std::vector<int> range;
+	std::vector<int> scan;
+};
+
+//------------------------------------------------------------------------------
+template <typename Predicate>
+cUnit* cUnitStore::findArmedUnit (int playerId, std::uint16_t flagMask, std::uint16_t flagValues, const cPosition& target, Predicate&& predicate) const
+{
+	const std::uint16_t busy = Attacking | BeingAttacked | Moving | Loaded;
+	flagMask |= CanAttack | busy;
+	flagValues = (flagValues & ~busy) | CanAttack;
+
+	for (std::size_t i = 0; i != units.size(); ++i)
+	{
+		if (owners[i] != playerId || (flags[i] & flagMask) != flagValues) continue;
+		if (shots[i] <= 0 || ammo[i] <= 0) continue;
+		if ((target - positions[i]).l2NormSquared() > Square (range[i])) continue;
+		if (predicate (*units[i])) return units[i];
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template <typename Predicate>
+cUnit* cUnitStore::findUnitInRange (int playerId, const cPosition& center, int radius, Predicate&& predicate) const
+{
+	for (std::size_t i = 0; i != units.size(); ++i)
+	{
+		if (owners[i] != playerId) continue;
+		if ((positions[i] - center).l2NormSquared() > Square (radius)) continue;
+		if (predicate (*units[i])) return units[i];
+	}
+	return nullptr;
+}
+
+#endif // game_data_units_unitstoreH
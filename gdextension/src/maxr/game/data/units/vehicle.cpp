@@ -26,6 +26,7 @@
 #include "game/data/model.h"
 #include "game/data/player/player.h"
 #include "game/data/units/building.h"
+#include "game/data/units/unitstore.h"
 #include "game/logic/attackjob.h"
 #include "game/logic/jobs/planetakeoffjob.h"
 #include "game/logic/jobs/startbuildjob.h"
@@ -416,33 +417,27 @@ bool cVehicle::canTransferTo (const cUnit& unit) const
 }
 
 //------------------------------------------------------------------------------
-bool cVehicle::makeAttackOnThis (cModel& model, cUnit* opponentUnit, const std::string& reasonForLog) const
+bool cVehicle::isTargetOf (const cUnit& opponentUnit, const cMapView& mapView) const
 {
-	cMapView mapView (model.getMap(), nullptr);
-	const cUnit* target = cAttackJob::selectTarget (getPosition(), opponentUnit->getStaticUnitData().canAttack, mapView, getOwner());
-	if (target != this) return false;
-
-	NetLog.debug (" cVehicle: " + reasonForLog + ": attacking " + toString (getPosition()) + ", Aggressor ID: " + std::to_string (opponentUnit->iID) + ", Target ID: " + std::to_string (target->getId()));
-
-	model.addAttackJob (*opponentUnit, getPosition());
-
-	return true;
+	const cUnit* target = cAttackJob::selectTarget (getPosition(), opponentUnit.getStaticUnitData().canAttack, mapView, getOwner());
+	return target == this;
 }
 
 //------------------------------------------------------------------------------
-bool cVehicle::makeSentryAttack (cModel& model, cUnit* sentryUnit) const
+bool cVehicle::canSentryAttackThis (const cUnit& sentryUnit, const cMapView& mapView) const
 {
-	cMapView mapView (model.getMap(), nullptr);
-	if (sentryUnit != 0 && sentryUnit->isSentryActive() && sentryUnit->canAttackObjectAt (getPosition(), mapView, true))
-	{
-		if (makeAttackOnThis (model, sentryUnit, "sentry reaction"))
-			return true;
-	}
-	return false;
+	return sentryUnit.isSentryActive() && sentryUnit.canAttackObjectAt (getPosition(), mapView, true) && isTargetOf (sentryUnit, mapView);
 }
 
 //------------------------------------------------------------------------------
 bool cVehicle::inSentryRange (cModel& model)
+{
+	const cMapView mapView (model.getMap(), nullptr);
+	return makeReactionAttack (model, findReactionAttack (model, mapView));
+}
+
+//------------------------------------------------------------------------------
+cVehicle::sReactionAttack cVehicle::findReactionAttack (const cModel& model, const cMapView& mapView) const
 {
 	for (const auto& player : model.getPlayerList())
 	{
@@ -456,30 +451,38 @@ bool cVehicle::inSentryRange (cModel& model)
 		// Check sentry type
 		if (staticData->factorAir == 0 && player->hasSentriesGround (getPosition()) == 0) continue;
 
-		for (const auto& vehicle : player->getVehicles())
-		{
-			if (makeSentryAttack (model, vehicle.get()))
-				return true;
-		}
-		for (const auto& building : player->getBuildings())
-		{
-			if (makeSentryAttack (model, building.get()))
-				return true;
-		}
+		const auto& unitStore = model.getUnitStore();
+		const auto canSentryAttack = [&] (const cUnit& sentryUnit) { return canSentryAttackThis (sentryUnit, mapView); };
+		const std::uint16_t mask = cUnitStore::Vehicle | cUnitStore::Sentry;
+		if (cUnit* vehicle = unitStore.findArmedUnit (player->getId(), mask, cUnitStore::Vehicle | cUnitStore::Sentry, getPosition(), canSentryAttack))
+			return {vehicle, "sentry reaction"};
+		if (cUnit* building = unitStore.findArmedUnit (player->getId(), mask, cUnitStore::Sentry, getPosition(), canSentryAttack))
+			return {building, "sentry reaction"};
 	}
 
-	return provokeReactionFire (model);
+	return findProvokedReactionFire (model, mapView);
+}
+
+//------------------------------------------------------------------------------
+bool cVehicle::makeReactionAttack (cModel& model, const sReactionAttack& attack) const
+{
+	if (attack.aggressor == nullptr) return false;
+
+	NetLog.debug (" cVehicle: " + std::string (attack.reasonForLog) + ": attacking " + toString (getPosition()) + ", Aggressor ID: " + std::to_string (attack.aggressor->iID) + ", Target ID: " + std::to_string (getId()));
+
+	model.addAttackJob (*attack.aggressor, getPosition());
+
+	return true;
 }
 
 //------------------------------------------------------------------------------
-bool cVehicle::isOtherUnitOffendedByThis (const cModel& model, const cUnit& otherUnit) const
+bool cVehicle::isOtherUnitOffendedByThis (const cModel& model, const cMapView& mapView, const cUnit& otherUnit) const
 {
 	// don't treat the cheap buildings
 	// (connectors, roads, beton blocks) as offendable
 	if (otherUnit.isABuilding() && model.getUnitsData()->getDynamicUnitData (otherUnit.data.getId()).getBuildCost() <= 2)
 		return false;
 
-	cMapView mapView (model.getMap(), nullptr);
 	if (isInRange (otherUnit.getPosition()) && canAttackObjectAt (otherUnit.getPosition(), mapView, true, false))
 	{
 		// test, if this vehicle can really attack the opponentVehicle
@@ -491,7 +494,7 @@ bool cVehicle::isOtherUnitOffendedByThis (const cModel& model, const cUnit& othe
 }
 
 //------------------------------------------------------------------------------
-bool cVehicle::doesPlayerWantToFireOnThisVehicleAsReactionFire (const cModel& model, const cPlayer* player) const
+bool cVehicle::doesPlayerWantToFireOnThisVehicleAsReactionFire (const cModel& model, const cMapView& mapView, const cPlayer* player) const
 {
 	if (model.getGameSettings()->gameType == eGameSettingsGameType::Turns)
 	{
@@ -503,65 +506,45 @@ bool cVehicle::doesPlayerWantToFireOnThisVehicleAsReactionFire (const cModel& mo
 	else
 	{
 		// check if there is a vehicle or building of player, that is offended
-		for (const auto& opponentVehicle : player->getVehicles())
-		{
-			if (isOtherUnitOffendedByThis (model, *opponentVehicle))
-				return true;
-		}
-		for (const auto& opponentBuilding : player->getBuildings())
-		{
-			if (isOtherUnitOffendedByThis (model, *opponentBuilding))
-				return true;
-		}
+		const auto isOffended = [&] (const cUnit& opponentUnit) { return isOtherUnitOffendedByThis (model, mapView, opponentUnit); };
+		return model.getUnitStore().findUnitInRange (player->getId(), getPosition(), data.getRange(), isOffended) != nullptr;
 	}
-	return false;
 }
 
 //------------------------------------------------------------------------------
-bool cVehicle::doReactionFireForUnit (cModel& model, cUnit* opponentUnit) const
+bool cVehicle::canReactionFireOnThis (const cUnit& opponentUnit, const cMapView& mapView) const
 {
-	cMapView mapView (model.getMap(), nullptr);
-	if (opponentUnit->isSentryActive() == false && opponentUnit->isManualFireActive() == false
-	    && opponentUnit->canAttackObjectAt (getPosition(), mapView, true)
+	return opponentUnit.isSentryActive() == false && opponentUnit.isManualFireActive() == false
+	    && opponentUnit.canAttackObjectAt (getPosition(), mapView, true)
 	    // Possible TODO: better handling of stealth units.
 	    // e.g. do reaction fire, if already detected ?
-	    && (opponentUnit->isAVehicle() == false || opponentUnit->getStaticUnitData().isStealthOn == eTerrainFlag::None))
-	{
-		if (makeAttackOnThis (model, opponentUnit, "reaction fire"))
-			return true;
-	}
-	return false;
+	    && (opponentUnit.isAVehicle() == false || opponentUnit.getStaticUnitData().isStealthOn == eTerrainFlag::None)
+	    && isTargetOf (opponentUnit, mapView);
 }
 
 //------------------------------------------------------------------------------
-bool cVehicle::doReactionFire (cModel& model, cPlayer* player) const
+cUnit* cVehicle::findReactionFire (const cUnitStore& unitStore, const cMapView& mapView, const cPlayer& player) const
 {
 	// search a unit of the opponent, that could fire on this vehicle
 	// first look for a building
-	for (const auto& opponentBuilding : player->getBuildings())
-	{
-		if (doReactionFireForUnit (model, opponentBuilding.get()))
-			return true;
-	}
-	for (const auto& opponentVehicle : player->getVehicles())
-	{
-		if (doReactionFireForUnit (model, opponentVehicle.get()))
-			return true;
-	}
-	return false;
+	const auto canReactionFire = [&] (const cUnit& opponentUnit) { return canReactionFireOnThis (opponentUnit, mapView); };
+	const std::uint16_t mask = cUnitStore::Vehicle | cUnitStore::Sentry | cUnitStore::ManualFire;
+	if (cUnit* building = unitStore.findArmedUnit (player.getId(), mask, 0, getPosition(), canReactionFire))
+		return building;
+	return unitStore.findArmedUnit (player.getId(), mask, cUnitStore::Vehicle, getPosition(), canReactionFire);
 }
 
 //------------------------------------------------------------------------------
-bool cVehicle::provokeReactionFire (cModel& model)
+cVehicle::sReactionAttack cVehicle::findProvokedReactionFire (const cModel& model, const cMapView& mapView) const
 {
 	// unit can't fire, so it can't provoke a reaction fire
 	if (staticData->canAttack == false || data.getShots() <= 0 || data.getAmmo() <= 0)
-		return false;
+		return {};
 
 	const auto& playerList = model.getPlayerList();
 	for (size_t i = 0; i != playerList.size(); ++i)
 	{
-		cPlayer& player = *playerList[i];
+		const cPlayer& player = *playerList[i];
 		if (&player == getOwner())
 			continue;
 
@@ -570,13 +553,13 @@ bool cVehicle::provokeReactionFire (cModel& model)
 		if (!player.canSeeUnit (*this, *model.getMap()))
 			continue;
 
-		if (!doesPlayerWantToFireOnThisVehicleAsReactionFire (model, &player))
+		if (!doesPlayerWantToFireOnThisVehicleAsReactionFire (model, mapView, &player))
 			continue;
 
-		if (doReactionFire (model, &player))
-			return true;
+		if (cUnit* aggressor = findReactionFire (model.getUnitStore(), mapView, player))
+			return {aggressor, "reaction fire"};
 	}
-	return false;
+	return {};
 }
 
 //------------------------------------------------------------------------------
@@ -812,6 +795,7 @@ bool cVehicle::canLand (const cMap& map) const
 void cVehicle::setMoving (bool value)
 {
 	std::swap (moving, value);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::Moving, moving);
 	if (value != moving) movingChanged();
 }
 
@@ -819,6 +803,7 @@ void cVehicle::setMoving (bool value)
 void cVehicle::setLoaded (bool value)
 {
 	std::swap (loaded, value);
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::Loaded, loaded);
 	if (value != loaded)
 	{
 		if (loaded)
@@ -828,6 +813,13 @@ void cVehicle::setLoaded (bool value)
 	}
 }
 
+//------------------------------------------------------------------------------
+void cVehicle::setBuildBigSavedPosition (std::optional<cPosition> position)
+{
+	buildBigSavedPosition = position;
+	if (unitStore) unitStore->setFlag (unitStoreIndex, cUnitStore::Big, getIsBig());
+}
+
 //------------------------------------------------------------------------------
 void cVehicle::setClearing (bool value)
 {
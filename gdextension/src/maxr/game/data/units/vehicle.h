@@ -34,6 +34,7 @@ class cMoveJob;
 class cModel;
 class cPlayer;
 class cStaticMap;
+class cUnitStore;
 
 struct sNewTurnPlayerReport;
 
@@ -78,7 +79,28 @@ public:
 	bool doSurvey (const cMap& map);
 	bool canTransferTo (const cPosition& position, const cMapView& map) const override;
 	bool canTransferTo (const cUnit& position) const override;
+	/**
+	 * Lets opponent units fire on this vehicle by sentry or reaction fire.
+	 * @return true, when an attack job has been started
+	 */
 	bool inSentryRange (cModel& model);
+
+	struct sReactionAttack
+	{
+		cUnit* aggressor = nullptr;
+		const char* reasonForLog = "";
+	};
+	/**
+	 * Searches the opponent unit, that would attack this vehicle in inSentryRange().
+	 * The model is not modified, so this can be called concurrently
+	 * for several vehicles, as long as every thread uses its own map view.
+	 */
+	sReactionAttack findReactionAttack (const cModel&, const cMapView&) const;
+	/**
+	 * Starts the attack found by findReactionAttack().
+	 * @return true, when an attack job has been started
+	 */
+	bool makeReactionAttack (cModel&, const sReactionAttack&) const;
 	bool canExitTo (const cPosition& position, const cMap& map, const cStaticUnitData& unitData) const override;
 	bool canExitTo (const cPosition& position, const cMapView& map, const cStaticUnitData& unitData) const override;
 	bool canLoad (const cPosition& position, const cMapView& map, bool checkPosition = true) const;
@@ -119,6 +141,7 @@ public:
 
 	void setMoving (bool value);
 	void setLoaded (bool value);
+	void setBuildBigSavedPosition (std::optional<cPosition>);
 	void setClearing (bool value);
 	void setBuildingABuilding (bool value);
 	void setLayMines (bool value);
@@ -224,13 +247,13 @@ private:
 	 * (i.e. it could attack a unit/building of the opponent).
 	 * @author: pagra
 	 */
-	bool provokeReactionFire (cModel& model);
-	bool doesPlayerWantToFireOnThisVehicleAsReactionFire (const cModel& model, const cPlayer* player) const;
-	bool makeAttackOnThis (cModel& model, cUnit* opponentUnit, const std::string& reasonForLog) const;
-	bool makeSentryAttack (cModel& model, cUnit* unit) const;
-	bool isOtherUnitOffendedByThis (const cModel& model, const cUnit& otherUnit) const;
-	bool doReactionFire (cModel& model, cPlayer* player) const;
-	bool doReactionFireForUnit (cModel& model, cUnit* opponentUnit) const;
+	sReactionAttack findProvokedReactionFire (const cModel&, const cMapView&) const;
+	bool doesPlayerWantToFireOnThisVehicleAsReactionFire (const cModel&, const cMapView&, const cPlayer* player) const;
+	bool isTargetOf (const cUnit& opponentUnit, const cMapView&) const;
+	bool canSentryAttackThis (const cUnit& sentryUnit, const cMapView&) const;
+	bool isOtherUnitOffendedByThis (const cModel&, const cMapView&, const cUnit& otherUnit) const;
+	cUnit* findReactionFire (const cUnitStore&, const cMapView&, const cPlayer& player) const;
+	bool canReactionFireOnThis (const cUnit& opponentUnit, const cMapView&) const;
 
 public:
 	mutable cPosition dither;
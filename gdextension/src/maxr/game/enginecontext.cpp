@@ -0,0 +1,39 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/enginecontext.h"
+
+#include "game/data/player/clans.h"
+#include "game/data/units/unitdata.h"
+#include "settings.h"
+
+//------------------------------------------------------------------------------
+/*static*/ std::shared_ptr<const sEngineContext> sEngineContext::fromSettings()
+{
+	auto context = std::make_shared<sEngineContext>();
+	context->unitsData = cUnitsDataCache::share (std::make_shared<const cUnitsData> (UnitsDataGlobal));
+	context->clanData = std::make_shared<const cClanData> (ClanDataGlobal);
+	context->savesPath = cSettings::getInstance().getSavesPath();
+	context->replaysPath = cSettings::getInstance().getReplaysPath();
+	if (cSettings::getInstance().shouldAutosave())
+		context->autosaveSlot = 10;
+	// a local host runs only one game, so the clients can diagnose their desyncs
+	context->modelHistoryBudget = 16 * 1024 * 1024;
+	return context;
+}
@@ -0,0 +1,64 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_enginecontextH
+#define game_enginecontextH
+
+#include "game/logic/modelhistory.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+class cClanData;
+class cServerPool;
+class cUnitsData;
+
+/**
+ * The state a game takes from its environment, instead of the process wide
+ * settings and data singletons. Servers with different contexts can run in
+ * the same process.
+ * A context is not changed after its creation. So one context can be shared by any
+ * number of games, e.g. to load the units data only once for all games.
+ */
+struct sEngineContext
+{
+	/** Context with the global units/clan data and the user settings */
+	static std::shared_ptr<const sEngineContext> fromSettings();
+
+	std::shared_ptr<const cUnitsData> unitsData;
+	std::shared_ptr<const cClanData> clanData;
+	std::filesystem::path savesPath;
+	/** save slot, the server writes at each turn start. No autosave if empty */
+	std::optional<int> autosaveSlot;
+	/** directory, the server records a replay of the game to. No replay if empty */
+	std::filesystem::path replaysPath;
+	/** if set, the servers run on the threads of the pool instead of an own thread each */
+	std::shared_ptr<cServerPool> serverPool;
+	/**
+	 * memory budget of the in-memory model history of each server,
+	 * which is needed to diagnose desyncs of the clients. No history if 0
+	 */
+	std::size_t modelHistoryBudget = 0;
+	/** game time between two snapshots of the model history */
+	unsigned int modelHistoryInterval = cModelHistory::defaultInterval;
+};
+
+#endif // game_enginecontextH
@@ -156,7 +156,7 @@ void cActionFinishBuild::finishAVehicle (cModel& model, cBuilding& building) con
 		{
 			std::array<int, 3> turboBuildRounds;
 			std::array<int, 3> turboBuildCosts;
-			building.calcTurboBuild (turboBuildRounds, turboBuildCosts, player->getLastUnitData (nextBuildingListItem.getType())->getBuildCost());
+			building.calcTurboBuild (turboBuildRounds, turboBuildCosts, std::as_const (*player).getLastUnitData (nextBuildingListItem.getType())->getBuildCost());
 			nextBuildingListItem.setRemainingMetal (turboBuildCosts[building.getBuildSpeed()]);
 		}
 		building.startWork();
@@ -320,11 +320,11 @@ void cActionInitNewGame::execute (cModel& model) const
 			NetLog.error (" Landing failed. Invalid clan number.");
 			return;
 		}
-		player.setClan (initPlayerData.clan, unitsdata);
+		player.setClan (initPlayerData.clan, unitsdataPtr);
 	}
 	else
 	{
-		player.setClan (-1, unitsdata);
+		player.setClan (-1, unitsdataPtr);
 	}
 
 	// init landing position
@@ -363,7 +363,7 @@ void cActionInitNewGame::execute (cModel& model) const
 			NetLog.error (" Apply upgrades failed. Unknown sID: " + unitId.getText());
 			return;
 		}
-		int costs = upgradeValues.calcTotalCosts (unitsdata.getDynamicUnitData (unitId, player.getClan()), *player.getLastUnitData (unitId), player.getResearchState());
+		int costs = upgradeValues.calcTotalCosts (unitsdata.getDynamicUnitData (unitId, player.getClan()), *std::as_const (player).getLastUnitData (unitId), player.getResearchState());
 		if (costs <= 0)
 		{
 			NetLog.error (" Apply upgrades failed. Couldn't calculate costs.");
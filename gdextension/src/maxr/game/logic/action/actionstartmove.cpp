@@ -23,7 +23,7 @@
 #include "game/data/units/vehicle.h"
 
 //------------------------------------------------------------------------------
-cActionStartMove::cActionStartMove (const cVehicle& vehicle, const std::forward_list<cPosition>& path, eStart start, eStopOn stopOn, cEndMoveAction emat) :
+cActionStartMove::cActionStartMove (const cVehicle& vehicle, const cPath& path, eStart start, eStopOn stopOn, cEndMoveAction emat) :
 	path (path),
 	unitId (vehicle.getId()),
 	endMoveAction (emat),
@@ -22,8 +22,7 @@
 
 #include "action.h"
 #include "game/logic/endmoveaction.h"
-
-#include <forward_list>
+#include "utility/path.h"
 
 enum class eStopOn;
 
@@ -36,7 +35,7 @@ enum class eStart
 class cActionStartMove : public cActionT<cAction::eActiontype::StartMove>
 {
 public:
-	cActionStartMove (const cVehicle&, const std::forward_list<cPosition>& path, eStart, eStopOn, cEndMoveAction);
+	cActionStartMove (const cVehicle&, const cPath& path, eStart, eStopOn, cEndMoveAction);
 	cActionStartMove (cBinaryArchiveIn& archive);
 
 	void serialize (cBinaryArchiveOut& archive) override
@@ -66,7 +65,7 @@ private:
 		// clang-format on
 	}
 
-	std::forward_list<cPosition> path;
+	cPath path;
 	unsigned int unitId;
 	cEndMoveAction endMoveAction;
 	eStart start;
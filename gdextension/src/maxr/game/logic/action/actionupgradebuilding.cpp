@@ -48,7 +48,7 @@ void cActionUpgradeBuilding::execute (cModel& model) const
 	cSubBase& subbase = *building->subBase;
 	int availableMetal = subbase.getResourcesStored().metal;
 	cDynamicUnitData& upgradedData = *building->getOwner()->getLastUnitData (building->data.getId());
-	cUpgradeCalculator& uc = cUpgradeCalculator::instance();
+	const cUpgradeCalculator& uc = cUpgradeCalculator::instance();
 	const int upgradeCost = uc.getMaterialCostForUpgrading (upgradedData.getBuildCost());
 
 	// first update the selected building
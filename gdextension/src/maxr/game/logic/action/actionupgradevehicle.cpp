@@ -53,7 +53,7 @@ void cActionUpgradeVehicle::execute (cModel& model) const
 			if (!vehicle->data.canBeUpgradedTo (upgradedData)) continue; // already up to date
 
 			// check upgrade costs
-			cUpgradeCalculator& uc = cUpgradeCalculator::instance();
+			const cUpgradeCalculator& uc = cUpgradeCalculator::instance();
 			const int upgradeCost = uc.getMaterialCostForUpgrading (upgradedData.getBuildCost());
 			if (upgradeCost > containingBuilding->subBase->getResourcesStored().metal) continue;
 
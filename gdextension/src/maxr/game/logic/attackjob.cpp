@@ -195,7 +195,7 @@ void cAttackJob::fire (cModel& model)
 	if (aggressor->isAVehicle() && aggressor->getStaticUnitData().vehicleData.canDriveAndFire == false)
 		aggressor->data.setSpeed (aggressor->data.getSpeed() - (int) (((float) aggressor->data.getSpeedMax()) / aggressor->data.getShotsMax()));
 
-	auto muzzle = createMuzzleFx (*aggressor);
+	auto muzzle = createMuzzleFx (model.getObjectPool(), *aggressor);
 	if (muzzle)
 	{
 		//set timer for next state
@@ -212,17 +212,17 @@ void cAttackJob::fire (cModel& model)
 		const cMap& map = *model.getMap();
 		if (map.isWaterOrCoast (aggressor->getPosition()))
 		{
-			model.addFx (std::make_unique<cFxExploWater> (aggressor->getPosition() * 64 + cPosition (32, 32)));
+			model.addFx (model.getObjectPool().makeShared<cFxExploWater> (aggressor->getPosition() * 64 + cPosition (32, 32)));
 		}
 		else
 		{
-			model.addFx (std::make_unique<cFxExploSmall> (aggressor->getPosition() * 64 + cPosition (32, 32)));
+			model.addFx (model.getObjectPool().makeShared<cFxExploSmall> (aggressor->getPosition() * 64 + cPosition (32, 32)));
 		}
 	}
 }
 
 //------------------------------------------------------------------------------
-std::unique_ptr<cFx> cAttackJob::createMuzzleFx (const cUnit& aggressor)
+std::shared_ptr<cFx> cAttackJob::createMuzzleFx (cObjectPool& pool, const cUnit& aggressor)
 {
 	//TODO: this shouldn't be in the attackjob class.
 
@@ -264,14 +264,14 @@ std::unique_ptr<cFx> cAttackJob::createMuzzleFx (const cUnit& aggressor)
 					offset.y() = -32;
 					break;
 			}
-			return std::make_unique<cFxMuzzleBig> (aggressorPosition * 64 + offset, fireDir, id);
+			return pool.makeShared<cFxMuzzleBig> (aggressorPosition * 64 + offset, fireDir, id);
 
 		case eMuzzleType::Small:
-			return std::make_unique<cFxMuzzleSmall> (aggressorPosition * 64, fireDir, id);
+			return pool.makeShared<cFxMuzzleSmall> (aggressorPosition * 64, fireDir, id);
 
 		case eMuzzleType::Rocket:
 		case eMuzzleType::RocketCluster:
-			return std::make_unique<cFxRocket> (aggressorPosition * 64 + cPosition (32, 32), targetPosition * 64 + cPosition (32, 32), fireDir, false, id);
+			return pool.makeShared<cFxRocket> (aggressorPosition * 64 + cPosition (32, 32), targetPosition * 64 + cPosition (32, 32), fireDir, false, id);
 
 		case eMuzzleType::Med:
 		case eMuzzleType::MedLong:
@@ -307,12 +307,12 @@ std::unique_ptr<cFx> cAttackJob::createMuzzleFx (const cUnit& aggressor)
 					break;
 			}
 			if (aggressor.getStaticUnitData().muzzleType == eMuzzleType::Med)
-				return std::make_unique<cFxMuzzleMed> (aggressorPosition * 64 + offset, fireDir, id);
+				return pool.makeShared<cFxMuzzleMed> (aggressorPosition * 64 + offset, fireDir, id);
 			else
-				return std::make_unique<cFxMuzzleMedLong> (aggressorPosition * 64 + offset, fireDir, id);
+				return pool.makeShared<cFxMuzzleMedLong> (aggressorPosition * 64 + offset, fireDir, id);
 
 		case eMuzzleType::Torpedo:
-			return std::make_unique<cFxRocket> (aggressorPosition * 64 + cPosition (32, 32), targetPosition * 64 + cPosition (32, 32), fireDir, true, id);
+			return pool.makeShared<cFxRocket> (aggressorPosition * 64 + cPosition (32, 32), targetPosition * 64 + cPosition (32, 32), fireDir, true, id);
 		case eMuzzleType::Sniper:
 		//TODO: sniper has no animation?!?
 		default:
@@ -428,7 +428,7 @@ void cAttackJob::impactSingle (const cPosition& position, int attackPoints, cMod
 			bigTarget = target->getIsBig();
 			offset = target->getMovementOffset();
 		}
-		model.addFx (std::make_unique<cFxHit> (position * 64 + offset + cPosition (32, 32), targetHit, bigTarget));
+		model.addFx (model.getObjectPool().makeShared<cFxHit> (position * 64 + offset + cPosition (32, 32), targetHit, bigTarget));
 	}
 
 	aggressor->setAttacking (false);
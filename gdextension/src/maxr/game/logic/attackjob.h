@@ -31,6 +31,7 @@
 
 class cMap;
 class cPlayer;
+class cObjectPool;
 class cFx;
 class cUnit;
 class cModel;
@@ -79,7 +80,7 @@ private:
 	void lockTarget (const cMap& map, const cUnit& aggressor);
 	void releaseTargets (const cModel& model);
 	void fire (cModel& model);
-	std::unique_ptr<cFx> createMuzzleFx (const cUnit& aggressor);
+	std::shared_ptr<cFx> createMuzzleFx (cObjectPool&, const cUnit& aggressor);
 	void impact (cModel& model);
 	void impactCluster (cModel& model);
 	void impactSingle (const cPosition& position, int attackPoints, cModel& model, std::vector<cUnit*>* avoidTargets = nullptr);
@@ -53,13 +53,17 @@
 #include "game/logic/action/actiontransfer.h"
 #include "game/logic/action/actionupgradebuilding.h"
 #include "game/logic/action/actionupgradevehicle.h"
+#include "game/logic/desyncdiagnosis.h"
 #include "game/logic/gametimer.h"
 #include "game/logic/surveyorai.h"
+#include "game/logic/turntimeclock.h"
 #include "game/protocol/netmessage.h"
 #include "game/startup/lobbypreparationdata.h"
 #include "utility/log.h"
 #include "utility/serialization/jsonarchive.h"
 
+#include <fstream>
+
 //------------------------------------------------------------------------------
 cClient::cClient (std::shared_ptr<cConnectionManager> connectionManager) :
 	connectionManager (connectionManager),
@@ -84,7 +88,7 @@ void cClient::setMap (std::shared_ptr<cStaticMap> staticMap)
 //------------------------------------------------------------------------------
 void cClient::setPreparationData (const sLobbyPreparationData& preparationData)
 {
-	model.setUnitsData (std::make_shared<cUnitsData> (*preparationData.unitsData));
+	model.setUnitsData (preparationData.unitsData);
 	model.setGameSettings (*preparationData.gameSettings);
 	model.setMap (preparationData.staticMap);
 }
@@ -115,7 +119,7 @@ void cClient::sendNetMessage (cNetMessage&& message) const
 {
 	message.playerNr = activePlayer->getId();
 
-	if (message.getType() != eNetMessageType::GAMETIME_SYNC_CLIENT)
+	if (message.getType() != eNetMessageType::GAMETIME_SYNC_CLIENT && message.getType() != eNetMessageType::DESYNC_CHECKSUMS)
 	{
 		nlohmann::json json;
 		cJsonArchiveOut jsonarchive (json);
@@ -161,7 +165,7 @@ void cClient::handleNetMessages()
 //------------------------------------------------------------------------------
 bool cClient::handleNetMessage (cNetMessage& message)
 {
-	if (message.getType() != eNetMessageType::GAMETIME_SYNC_SERVER && message.getType() != eNetMessageType::RESYNC_MODEL)
+	if (message.getType() != eNetMessageType::GAMETIME_SYNC_SERVER && message.getType() != eNetMessageType::RESYNC_MODEL && message.getType() != eNetMessageType::DESYNC_REPORT)
 	{
 		nlohmann::json json;
 		cJsonArchiveOut jsonarchive (json);
@@ -219,6 +223,7 @@ bool cClient::handleNetMessage (cNetMessage& message)
 			try
 			{
 				msg.apply (model);
+				desyncGameTime = std::nullopt;
 				recreateSurveyorMoveJobs();
 				gameTimer->sendSyncMessage (*this, model.getGameTime(), 0, 0);
 			}
@@ -264,6 +269,11 @@ bool cClient::handleNetMessage (cNetMessage& message)
 			connectionToServerLost();
 			return false;
 		}
+		case eNetMessageType::DESYNC_REPORT:
+		{
+			writeDesyncReport (static_cast<const cNetMessageDesyncReport&> (message));
+			return false;
+		}
 		default:
 		{
 			NetLog.warn (" Client: received unknown net message type");
@@ -272,6 +282,81 @@ bool cClient::handleNetMessage (cNetMessage& message)
 	}
 }
 
+//------------------------------------------------------------------------------
+void cClient::setDesyncDiagnosisPath (const std::filesystem::path& path)
+{
+	desyncDiagnosisPath = path;
+}
+
+//------------------------------------------------------------------------------
+void cClient::handleOutOfSync()
+{
+	if (desyncDiagnosisPath.empty() || desyncGameTime) return;
+
+	// keep the state, to compare it with the server, when the answer arrives
+	desyncGameTime = model.getGameTime();
+	desyncModelState.clear();
+	cBinaryArchiveOut archive (desyncModelState);
+	model.save (archive, false);
+
+	NetLog.warn (" Client: Sending checksums for desync diagnosis @" + std::to_string (*desyncGameTime));
+	sendNetMessage (cNetMessageDesyncChecksums (*desyncGameTime, desync::toChecksumList (model.getChecksumParts())));
+}
+
+//------------------------------------------------------------------------------
+void cClient::writeDesyncReport (const cNetMessageDesyncReport& message)
+{
+	if (desyncModelState.empty() || desyncGameTime != message.gameTime) return;
+	const auto modelState = std::exchange (desyncModelState, {});
+
+	if (!message.diagnosed)
+	{
+		NetLog.warn (" Client: The server could not diagnose the desync @" + std::to_string (message.gameTime));
+		return;
+	}
+
+	cModel modelAtGameTime;
+	modelAtGameTime.setUnitsData (model.getUnitsData());
+	cBinaryArchiveIn archive (modelState.data(), modelState.size());
+	modelAtGameTime.load (archive, false);
+
+	const auto localParts = modelAtGameTime.getChecksumParts();
+	const auto serverState = nlohmann::json::parse (message.serverState, nullptr, false);
+
+	nlohmann::json report;
+	report["gameId"] = model.getGameId();
+	report["gameTime"] = message.gameTime;
+	report["player"] = activePlayer->getId();
+	auto& parts = report["parts"] = nlohmann::json::object();
+	for (const auto& name : message.divergingParts)
+	{
+		auto& entry = parts[name];
+		const auto localPart = std::ranges::find (localParts, name, &sChecksumPart::name);
+		entry["client"] = (localPart != localParts.end() && localPart->dump) ? localPart->dump() : nlohmann::json();
+		entry["server"] = (serverState.is_object() && serverState.contains (name)) ? serverState[name] : nlohmann::json();
+
+		const auto differences = desync::diff (entry["client"], entry["server"]);
+		entry["differences"] = differences;
+		NetLog.error (" Client: Out of sync: " + name + (differences.empty() ? "" : " " + differences.front()));
+	}
+
+	try
+	{
+		std::filesystem::create_directories (desyncDiagnosisPath);
+		const auto path = desyncDiagnosisPath / ("desync_" + std::to_string (model.getGameId()) + "_" + std::to_string (message.gameTime) + "_player" + std::to_string (activePlayer->getId()) + ".json");
+		std::ofstream file (path);
+		file << report.dump (1, '\t');
+		if (!file) throw std::runtime_error ("Can't write " + path.string());
+
+		NetLog.warn (" Client: Desync report written to " + path.string());
+		desyncReportWritten (path);
+	}
+	catch (const std::exception& e)
+	{
+		NetLog.error (std::string (" Client: Can't write desync report: ") + e.what());
+	}
+}
+
 //------------------------------------------------------------------------------
 void cClient::handleSurveyorMoveJobs()
 {
@@ -525,7 +610,7 @@ void cClient::startBuildPath (const cVehicle& vehicle, sID buildingTypeID, int b
 }
 
 //------------------------------------------------------------------------------
-void cClient::startMove (const cVehicle& vehicle, const std::forward_list<cPosition>& path, eStart start, eStopOn stopOn, cEndMoveAction emat)
+void cClient::startMove (const cVehicle& vehicle, const cPath& path, eStart start, eStopOn stopOn, cEndMoveAction emat)
 {
 	sendNetMessage (cActionStartMove (vehicle, path, start, stopOn, emat));
 }
@@ -29,7 +29,9 @@
 #include "utility/signal/signalconnectionmanager.h"
 #include "utility/thread/concurrentqueue.h"
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 
 class cAttackJob;
 class cBuilding;
@@ -105,7 +107,7 @@ public:
 	void setAutoMove (const cVehicle&, bool);
 	void startBuild (const cVehicle&, sID buildingTypeID, int buildSpeed, const cPosition& buildPosition);
 	void startBuildPath (const cVehicle&, sID buildingTypeID, int buildSpeed, const cPosition& buildPosition, const cPosition& pathEndPosition);
-	void startMove (const cVehicle&, const std::forward_list<cPosition>& path, eStart, eStopOn, cEndMoveAction);
+	void startMove (const cVehicle&, const cPath& path, eStart, eStopOn, cEndMoveAction);
 	void startTurn();
 	void startWork (const cBuilding&);
 	void disable (const cVehicle& infiltrator, const cUnit& target);
@@ -129,6 +131,19 @@ public:
 
 	void loadModel (int saveGameNumber, int playerNr);
 
+	/**
+	* Enables the desync diagnosis: when the model gets out of sync,
+	* the checksums of its parts are sent to the server and the state of the diverging parts
+	* on client and server is written to a JSON file in the given directory.
+	* An empty path disables the diagnosis (default).
+	*/
+	void setDesyncDiagnosisPath (const std::filesystem::path&);
+	/**
+	* Called by the game timer, when the model checksum differs from the server.
+	* Starts the desync diagnosis once, until the model is resynchronized.
+	*/
+	void handleOutOfSync();
+
 	cSignal<void (int fromPlayerNr, std::unique_ptr<cSavedReport>&, int toPlayerNr)> reportMessageReceived;
 	cSignal<void (int slot, int savingID)> guiSaveInfoRequested;
 	cSignal<void (const cNetMessageGUISaveInfo&)> guiSaveInfoReceived;
@@ -136,6 +151,7 @@ public:
 	cSignal<void()> resynced;
 	cSignal<void()> connectionToServerLost;
 	cSignal<void (const cVehicle&)> surveyorAiConfused;
+	cSignal<void (const std::filesystem::path&)> desyncReportWritten;
 
 	void run();
 
@@ -147,6 +163,7 @@ private:
 	void sendNetMessage (cNetMessage&&) const;
 
 	void handleSurveyorMoveJobs();
+	void writeDesyncReport (const cNetMessageDesyncReport&);
 
 private:
 	cModel model;
@@ -158,6 +175,10 @@ private:
 	cFreezeModes freezeModes;
 	std::map<int, ePlayerConnectionState> playerConnectionStates;
 	std::vector<std::unique_ptr<cSurveyorAi>> surveyorAiJobs;
+
+	std::filesystem::path desyncDiagnosisPath;
+	std::optional<unsigned int> desyncGameTime; // first game time out of sync since the last resync
+	std::vector<unsigned char> desyncModelState; // the model at desyncGameTime, until the report of the server arrives
 };
 
 #endif // game_logic_clientH
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/logic/desyncdiagnosis.h"
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+	//--------------------------------------------------------------------------
+	void diffRecursive (const nlohmann::json& local, const nlohmann::json& remote, const std::string& path, std::size_t maxDifferences, std::vector<std::string>& result)
+	{
+		if (result.size() >= maxDifferences || local == remote) return;
+
+		if (local.is_object() && remote.is_object())
+		{
+			for (const auto& [key, value] : local.items())
+			{
+				diffRecursive (value, remote.contains (key) ? remote[key] : nlohmann::json(), path + "/" + key, maxDifferences, result);
+			}
+			for (const auto& [key, value] : remote.items())
+			{
+				if (!local.contains (key)) diffRecursive (nlohmann::json(), value, path + "/" + key, maxDifferences, result);
+			}
+			return;
+		}
+		if (local.is_array() && remote.is_array())
+		{
+			const auto size = std::max (local.size(), remote.size());
+			for (std::size_t i = 0; i != size; ++i)
+			{
+				diffRecursive (i < local.size() ? local[i] : nlohmann::json(), i < remote.size() ? remote[i] : nlohmann::json(), path + "/" + std::to_string (i), maxDifferences, result);
+			}
+			return;
+		}
+		result.push_back ((path.empty() ? std::string ("/") : path) + ": " + local.dump() + " / " + remote.dump());
+	}
+} // namespace
+
+//------------------------------------------------------------------------------
+tChecksumList desync::toChecksumList (const std::vector<sChecksumPart>& parts)
+{
+	tChecksumList result;
+	result.reserve (parts.size());
+	for (const auto& part : parts)
+	{
+		result.emplace_back (part.name, part.checksum);
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+std::vector<std::string> desync::findDivergingParts (const tChecksumList& local, const tChecksumList& remote)
+{
+	const std::map<std::string, uint32_t> remoteChecksums (remote.begin(), remote.end());
+	std::vector<std::string> result;
+	for (const auto& [name, checksum] : local)
+	{
+		const auto it = remoteChecksums.find (name);
+		if (it == remoteChecksums.end() || it->second != checksum) result.push_back (name);
+	}
+	const std::map<std::string, uint32_t> localChecksums (local.begin(), local.end());
+	for (const auto& [name, checksum] : remote)
+	{
+		if (!localChecksums.contains (name)) result.push_back (name);
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+std::vector<std::string> desync::diff (const nlohmann::json& local, const nlohmann::json& remote, std::size_t maxDifferences)
+{
+	std::vector<std::string> result;
+	diffRecursive (local, remote, "", maxDifferences, result);
+	return result;
+}
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_logic_desyncdiagnosisH
+#define game_logic_desyncdiagnosisH
+
+#include "utility/serialization/jsonarchive.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A part of the model checksum (e.g. the random generator, a player field or a unit).
+ * When the models of server and client are out of sync,
+ * comparing the checksums of the parts finds the diverging units and fields.
+ */
+struct sChecksumPart
+{
+	std::string name;
+	uint32_t checksum = 0;
+	std::function<nlohmann::json()> dump; // the state of the part as JSON. Empty, if the part is not serializable
+};
+
+/** Names and checksums of the parts, as exchanged between client and server */
+using tChecksumList = std::vector<std::pair<std::string, uint32_t>>;
+
+namespace desync
+{
+	template <typename T>
+	nlohmann::json toJson (const T& value)
+	{
+		nlohmann::json json;
+		cJsonArchiveOut (json) << value;
+		return json;
+	}
+
+	tChecksumList toChecksumList (const std::vector<sChecksumPart>&);
+
+	/** Names of the parts, which checksums differ or which exist on one side only */
+	std::vector<std::string> findDivergingParts (const tChecksumList& local, const tChecksumList& remote);
+
+	/**
+	 * Compares two JSON dumps of a part field by field.
+	 * Returns the differences as "path: local value / remote value".
+	 */
+	std::vector<std::string> diff (const nlohmann::json& local, const nlohmann::json& remote, std::size_t maxDifferences = 50);
+} // namespace desync
+
+#endif // game_logic_desyncdiagnosisH
@@ -0,0 +1,175 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/logic/effectchannel.h"
+
+#include "game/data/model.h"
+#include "game/data/player/player.h"
+#include "game/logic/fxeffects.h"
+
+#include <algorithm>
+
+namespace
+{
+	//--------------------------------------------------------------------------
+	class cEntryWriter : public IFxVisitor
+	{
+	public:
+		explicit cEntryWriter (cEffectChannel::sEntry& entry) :
+			entry (entry)
+		{}
+
+		void visit (const cFxMuzzleBig& fx) override { setMuzzle (cEffectChannel::eType::MuzzleBig, fx); }
+		void visit (const cFxMuzzleMed& fx) override { setMuzzle (cEffectChannel::eType::MuzzleMed, fx); }
+		void visit (const cFxMuzzleMedLong& fx) override { setMuzzle (cEffectChannel::eType::MuzzleMedLong, fx); }
+		void visit (const cFxMuzzleSmall& fx) override { setMuzzle (cEffectChannel::eType::MuzzleSmall, fx); }
+		void visit (const cFxExploAir&) override { entry.type = cEffectChannel::eType::ExploAir; }
+		void visit (const cFxExploBig& fx) override
+		{
+			entry.type = cEffectChannel::eType::ExploBig;
+			entry.flags |= cEffectChannel::Big | (fx.isOnWater() ? cEffectChannel::OnWater : 0);
+		}
+		void visit (const cFxExploSmall&) override { entry.type = cEffectChannel::eType::ExploSmall; }
+		void visit (const cFxExploWater&) override
+		{
+			entry.type = cEffectChannel::eType::ExploWater;
+			entry.flags |= cEffectChannel::OnWater;
+		}
+		void visit (const cFxAbsorb&) override { entry.type = cEffectChannel::eType::Absorb; }
+		void visit (const cFxRocket& fx) override
+		{
+			entry.type = cEffectChannel::eType::Rocket;
+			entry.pixelPosition = fx.getStartPosition();
+			entry.targetPixelPosition = fx.getEndPosition();
+			entry.direction = static_cast<int> (fx.getDir());
+		}
+		void visit (const cFxSmoke&) override { entry.type = cEffectChannel::eType::Smoke; }
+		void visit (const cFxCorpse&) override { entry.type = cEffectChannel::eType::Corpse; }
+		void visit (const cFxDarkSmoke&) override { entry.type = cEffectChannel::eType::DarkSmoke; }
+		void visit (const cFxHit& fx) override
+		{
+			entry.type = cEffectChannel::eType::Hit;
+			entry.flags |= (fx.isBig() ? cEffectChannel::Big : 0) | (fx.isTargetHit() ? cEffectChannel::TargetHit : 0);
+		}
+		void visit (const cFxTracks& fx) override
+		{
+			entry.type = cEffectChannel::eType::Tracks;
+			entry.direction = static_cast<int> (fx.dir);
+		}
+
+	private:
+		void setMuzzle (cEffectChannel::eType type, const cFxMuzzle& fx)
+		{
+			entry.type = type;
+			entry.direction = static_cast<int> (fx.getDir());
+		}
+
+	private:
+		cEffectChannel::sEntry& entry;
+	};
+} // namespace
+
+//------------------------------------------------------------------------------
+void cEffectChannel::attach (const cModel& model)
+{
+	detach();
+
+	const auto& players = model.getPlayerList();
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		rings.resize (players.size());
+	}
+	for (std::size_t i = 0; i != players.size(); ++i)
+	{
+		connectionManager.connect (players[i]->addedEffect, [this, i] (const std::shared_ptr<cFx>& fx) { record (i, *fx); });
+	}
+}
+
+//------------------------------------------------------------------------------
+void cEffectChannel::detach()
+{
+	connectionManager.disconnectAll();
+
+	std::lock_guard<std::mutex> lock (mutex);
+	rings.clear();
+}
+
+//------------------------------------------------------------------------------
+std::vector<cEffectChannel::sEntry> cEffectChannel::drain (std::size_t playerIndex)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	if (playerIndex >= rings.size()) return {};
+
+	auto& ring = rings[playerIndex];
+	std::vector<sEntry> result;
+	result.swap (ring.entries);
+	std::rotate (result.begin(), result.begin() + ring.next, result.end());
+	ring.next = 0;
+	return result;
+}
+
+//------------------------------------------------------------------------------
+void cEffectChannel::record (std::size_t playerIndex, const cFx& fx)
+{
+	sEntry entry;
+	entry.pixelPosition = fx.getPixelPosition();
+	entry.targetPixelPosition = fx.getPixelPosition();
+	entry.length = fx.getLength();
+	entry.flags = fx.bottom ? Bottom : 0;
+	cEntryWriter writer (entry);
+	fx.accept (writer);
+
+	std::lock_guard<std::mutex> lock (mutex);
+	if (playerIndex >= rings.size()) return;
+
+	auto& ring = rings[playerIndex];
+	if (ring.entries.size() < capacity)
+	{
+		ring.entries.push_back (entry);
+	}
+	else
+	{
+		ring.entries[ring.next] = entry;
+		ring.next = (ring.next + 1) % capacity;
+	}
+}
+
+//------------------------------------------------------------------------------
+const char* cEffectChannel::getTypeName (eType type)
+{
+	switch (type)
+	{
+		case eType::MuzzleBig: return "muzzle_big";
+		case eType::MuzzleMed: return "muzzle_med";
+		case eType::MuzzleMedLong: return "muzzle_med_long";
+		case eType::MuzzleSmall: return "muzzle_small";
+		case eType::ExploAir: return "explo_air";
+		case eType::ExploBig: return "explo_big";
+		case eType::ExploSmall: return "explo_small";
+		case eType::ExploWater: return "explo_water";
+		case eType::Absorb: return "absorb";
+		case eType::Rocket: return "rocket";
+		case eType::Smoke: return "smoke";
+		case eType::Corpse: return "corpse";
+		case eType::DarkSmoke: return "dark_smoke";
+		case eType::Hit: return "hit";
+		case eType::Tracks: return "tracks";
+	}
+	return "";
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_logic_effectchannelH
+#define game_logic_effectchannelH
+
+#include "utility/position.h"
+#include "utility/signal/signalconnectionmanager.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class cFx;
+class cModel;
+
+/**
+ * Collects the effects each player can see, so that a presentation layer
+ * can play them without listening to the model.
+ *
+ * Effects are cosmetic: the channel is not part of the game state and does
+ * not take part in the lockstep simulation. Each player has a ring buffer of
+ * fixed capacity. When a presentation does not drain it for a while,
+ * the oldest effects are dropped.
+ * Recording is thread safe: the model may run on another thread than the
+ * one draining the channel. attach() and detach() are not, the model must not
+ * run meanwhile.
+ */
+class cEffectChannel
+{
+public:
+	enum class eType
+	{
+		MuzzleBig,
+		MuzzleMed,
+		MuzzleMedLong,
+		MuzzleSmall,
+		ExploAir,
+		ExploBig,
+		ExploSmall,
+		ExploWater,
+		Absorb,
+		Rocket,
+		Smoke,
+		Corpse,
+		DarkSmoke,
+		Hit,
+		Tracks
+	};
+
+	enum eFlag
+	{
+		Big = 1 << 0,
+		TargetHit = 1 << 1,
+		OnWater = 1 << 2,
+		Bottom = 1 << 3
+	};
+
+	struct sEntry
+	{
+		eType type = eType::ExploSmall;
+		cPosition pixelPosition;
+		cPosition targetPixelPosition; // end position of rockets, otherwise pixelPosition
+		int direction = -1; // EDirection of muzzles, rockets and tracks, otherwise -1
+		int length = 0; // in ticks
+		int flags = 0; // combination of eFlag
+	};
+
+	static constexpr std::size_t capacity = 256;
+
+	cEffectChannel() = default;
+	cEffectChannel (const cEffectChannel&) = delete;
+	cEffectChannel& operator= (const cEffectChannel&) = delete;
+
+	/** Starts recording the visible effects of every player of the given model */
+	void attach (const cModel&);
+	void detach();
+
+	/** returns the effects recorded for the player with the given index, oldest first, and clears them */
+	std::vector<sEntry> drain (std::size_t playerIndex);
+
+	static const char* getTypeName (eType);
+
+private:
+	struct sRing
+	{
+		std::vector<sEntry> entries; // grows up to capacity
+		std::size_t next = 0; // index of the oldest entry, when full
+	};
+
+	void record (std::size_t playerIndex, const cFx&);
+
+private:
+	cSignalConnectionManager connectionManager;
+
+	std::mutex mutex;
+	std::vector<sRing> rings;
+};
+
+#endif // game_logic_effectchannelH
@@ -22,6 +22,8 @@
 #include "settings.h"
 #include "utility/random.h"
 
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 cFx::cFx (bool bottom_, const cPosition& position_) :
@@ -45,29 +47,38 @@ void cFx::run()
 //------------------------------------------------------------------------------
 void cFxContainer::push_back (std::shared_ptr<cFx> fx)
 {
-	fxs.push_back (std::move (fx));
+	++count;
+	schedule (std::move (fx));
 }
 
 //------------------------------------------------------------------------------
-void cFxContainer::push_front (std::shared_ptr<cFx> fx)
+void cFxContainer::run()
 {
-	fxs.insert (fxs.begin(), std::move (fx));
-}
+	for (auto& slot : slots)
+	{
+		for (auto& fx : slot)
+		{
+			fx->run();
+		}
+	}
+	++currentTick;
 
-//------------------------------------------------------------------------------
-size_t cFxContainer::size() const
-{
-	return fxs.size();
+	expiring.swap (slots[currentTick % slotCount]);
+	for (auto& fx : expiring)
+	{
+		if (fx->isFinished())
+			--count;
+		else
+			schedule (std::move (fx));
+	}
+	expiring.clear();
 }
 
 //------------------------------------------------------------------------------
-void cFxContainer::run()
+void cFxContainer::schedule (std::shared_ptr<cFx> fx)
 {
-	for (auto& fx : fxs)
-	{
-		fx->run();
-	}
-	std::erase_if (fxs, [] (const auto& fx) { return fx->isFinished(); });
+	const int remainingTicks = std::clamp (fx->getLength() - fx->getTick(), 1, static_cast<int> (slotCount) - 1);
+	slots[(currentTick + remainingTicks) % slotCount].push_back (std::move (fx));
 }
 
 //------------------------------------------------------------------------------
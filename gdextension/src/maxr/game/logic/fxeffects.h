@@ -24,6 +24,7 @@
 #include "utility/direction.h"
 #include "utility/position.h"
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -91,16 +92,32 @@ public:
 	const bool bottom;
 };
 
+/**
+ * Runs the effects until they are finished.
+ *
+ * The effects are kept in a ring of slots indexed by the tick at which they
+ * are expected to finish. Each run only checks the effects of the current slot,
+ * so expiring an effect does not depend on the number of running effects.
+ * Effects, which are not finished at that tick (e.g. rockets with smoke trails,
+ * or effects longer than the ring) are moved to a later slot.
+ */
 class cFxContainer
 {
 public:
 	void push_back (std::shared_ptr<cFx> fx);
-	void push_front (std::shared_ptr<cFx> fx);
-	size_t size() const;
+	size_t size() const { return count; }
 	void run();
 
 private:
-	std::vector<std::shared_ptr<cFx>> fxs;
+	void schedule (std::shared_ptr<cFx> fx);
+
+private:
+	static constexpr std::size_t slotCount = 128;
+
+	std::array<std::vector<std::shared_ptr<cFx>>, slotCount> slots;
+	std::vector<std::shared_ptr<cFx>> expiring; // kept to reuse its capacity
+	std::size_t currentTick = 0;
+	std::size_t count = 0;
 };
 
 class cFxMuzzle : public cFx
@@ -270,6 +287,8 @@ public:
 	bool isFinished() const override;
 	const sID getId() const { return id; }
 	EDirection getDir() const { return dir; }
+	const cPosition& getStartPosition() const { return startPosition; }
+	const cPosition& getEndPosition() const { return endPosition; }
 	const std::vector<std::unique_ptr<cFx>>& getSubEffects() const { return subEffects; }
 };
 
@@ -269,6 +269,7 @@ void cGameTimerClient::run (cClient& client, cModel& model)
 			if (localChecksum != remoteChecksum)
 			{
 				NetLog.error ("OUT OF SYNC @" + std::to_string (model.getGameTime()));
+				client.handleOutOfSync();
 			}
 
 			syncMessageReceived = false;
@@ -76,6 +76,7 @@ uint32_t cDestroyJob::getChecksum (uint32_t crc) const
 void cDestroyJob::createDestroyFx (cModel& model)
 {
 	const cMap& map = *model.getMap();
+	auto& pool = model.getObjectPool();
 	auto* unit = model.getUnitFromID (unitId);
 
 	std::shared_ptr<cFx> fx;
@@ -83,19 +84,19 @@ void cDestroyJob::createDestroyFx (cModel& model)
 	{
 		if (vehicle->getIsBig())
 		{
-			fx = std::make_shared<cFxExploBig> (vehicle->getPosition() * 64 + 64, map.isWaterOrCoast (vehicle->getPosition()));
+			fx = pool.makeShared<cFxExploBig> (vehicle->getPosition() * 64 + 64, map.isWaterOrCoast (vehicle->getPosition()));
 		}
 		else if (vehicle->getStaticUnitData().factorAir > 0 && vehicle->getFlightHeight() != 0)
 		{
-			fx = std::make_shared<cFxExploAir> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32);
+			fx = pool.makeShared<cFxExploAir> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32);
 		}
 		else if (map.isWaterOrCoast (vehicle->getPosition()))
 		{
-			fx = std::make_shared<cFxExploWater> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32);
+			fx = pool.makeShared<cFxExploWater> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32);
 		}
 		else
 		{
-			fx = std::make_shared<cFxExploSmall> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32);
+			fx = pool.makeShared<cFxExploSmall> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32);
 		}
 		counter = fx->getLength() / 2;
 		model.addFx (fx);
@@ -103,7 +104,7 @@ void cDestroyJob::createDestroyFx (cModel& model)
 		if (vehicle->getStaticData().hasCorpse)
 		{
 			// add corpse
-			model.addFx (std::make_shared<cFxCorpse> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32));
+			model.addFx (pool.makeShared<cFxCorpse> (vehicle->getPosition() * 64 + vehicle->getMovementOffset() + 32));
 		}
 	}
 	else if (auto* building = dynamic_cast<cBuilding*> (unit))
@@ -111,11 +112,11 @@ void cDestroyJob::createDestroyFx (cModel& model)
 		const cBuilding* topBuilding = map.getField (building->getPosition()).getBuilding();
 		if (topBuilding && topBuilding->getIsBig())
 		{
-			fx = std::make_shared<cFxExploBig> (topBuilding->getPosition() * 64 + 64, map.isWaterOrCoast (topBuilding->getPosition()));
+			fx = pool.makeShared<cFxExploBig> (topBuilding->getPosition() * 64 + 64, map.isWaterOrCoast (topBuilding->getPosition()));
 		}
 		else
 		{
-			fx = std::make_shared<cFxExploSmall> (building->getPosition() * 64 + 32);
+			fx = pool.makeShared<cFxExploSmall> (building->getPosition() * 64 + 32);
 		}
 
 		counter = fx->getLength() / 2;
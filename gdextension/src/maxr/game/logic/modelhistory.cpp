@@ -0,0 +1,244 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/logic/modelhistory.h"
+
+#include "game/data/gamesettings.h"
+#include "game/data/model.h"
+#include "game/logic/action/action.h"
+#include "game/logic/turncounter.h"
+#include "game/logic/turntimeclock.h"
+#include "game/protocol/netmessage.h"
+#include "utility/serialization/binaryarchive.h"
+
+#include <algorithm>
+#include <cassert>
+
+//------------------------------------------------------------------------------
+cModelHistory::cModelHistory (unsigned int interval_, std::size_t memoryBudget_) :
+	interval (std::max (interval_, 1u)),
+	memoryBudget (memoryBudget_)
+{}
+
+//------------------------------------------------------------------------------
+cModelHistory::~cModelHistory() = default;
+
+//------------------------------------------------------------------------------
+void cModelHistory::clear()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	snapshots.clear();
+	actions.clear();
+	unitsData = nullptr;
+	memoryUsage = 0;
+	knownGameTime = 0;
+}
+
+//------------------------------------------------------------------------------
+void cModelHistory::take (const cModel& model)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	add (model);
+}
+
+//------------------------------------------------------------------------------
+void cModelHistory::update (const cModel& model)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	knownGameTime = std::max (knownGameTime, model.getGameTime());
+	if (!snapshots.empty())
+	{
+		const auto& latest = snapshots.back();
+		if (model.getGameTime() < latest.gameTime + interval && model.getTurnCounter()->getTurn() == latest.turn) return;
+	}
+	add (model);
+}
+
+//------------------------------------------------------------------------------
+void cModelHistory::recordAction (unsigned int gameTime, const cAction& action)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	if (snapshots.empty()) return; // can't be replayed anyway
+
+	sRecordedAction recorded;
+	recorded.gameTime = gameTime;
+	cBinaryArchiveOut archive (recorded.data);
+	archive << action;
+	memoryUsage += recorded.data.size();
+	actions.push_back (std::move (recorded));
+	knownGameTime = std::max (knownGameTime, gameTime);
+	shrinkToBudget();
+}
+
+//------------------------------------------------------------------------------
+std::optional<unsigned int> cModelHistory::restoreNearest (cModel& model, unsigned int gameTime) const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	const auto* snapshot = findNearest (gameTime);
+	if (snapshot == nullptr) return std::nullopt;
+
+	load (model, *snapshot);
+	return snapshot->gameTime;
+}
+
+//------------------------------------------------------------------------------
+std::optional<unsigned int> cModelHistory::getNearestGameTime (unsigned int gameTime) const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	const auto* snapshot = findNearest (gameTime);
+	if (snapshot == nullptr) return std::nullopt;
+	return snapshot->gameTime;
+}
+
+//------------------------------------------------------------------------------
+bool cModelHistory::seek (cModel& model, unsigned int gameTime) const
+{
+	std::vector<std::unique_ptr<cAction>> pendingActions;
+	std::vector<unsigned int> actionGameTimes;
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		if (gameTime > knownGameTime) return false;
+		const auto* snapshot = findNearest (gameTime);
+		if (snapshot == nullptr) return false;
+
+		load (model, *snapshot);
+
+		// the model is restored to the end of the tick, the actions of that game time follow
+		auto it = std::lower_bound (actions.begin(), actions.end(), snapshot->gameTime, [] (const sRecordedAction& action, unsigned int time) { return action.gameTime < time; });
+		for (; it != actions.end() && it->gameTime < gameTime; ++it)
+		{
+			auto message = cNetMessage::createFromBuffer (it->data.data(), static_cast<int> (it->data.size()));
+			assert (message->getType() == eNetMessageType::ACTION);
+			pendingActions.emplace_back (static_cast<cAction*> (message.release()));
+			actionGameTimes.push_back (it->gameTime);
+		}
+	}
+
+	// re-simulate outside of the lock, this takes the longest
+	std::size_t next = 0;
+	while (model.getGameTime() < gameTime)
+	{
+		for (; next < pendingActions.size() && actionGameTimes[next] <= model.getGameTime(); ++next)
+		{
+			if (model.getPlayer (pendingActions[next]->playerNr) == nullptr) continue;
+			pendingActions[next]->execute (model);
+		}
+		model.advanceGameTime();
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+std::optional<unsigned int> cModelHistory::getOldestGameTime() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	if (snapshots.empty()) return std::nullopt;
+	return snapshots.front().gameTime;
+}
+
+//------------------------------------------------------------------------------
+std::optional<unsigned int> cModelHistory::getLatestGameTime() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	if (snapshots.empty()) return std::nullopt;
+	return snapshots.back().gameTime;
+}
+
+//------------------------------------------------------------------------------
+std::size_t cModelHistory::size() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	return snapshots.size();
+}
+
+//------------------------------------------------------------------------------
+std::size_t cModelHistory::getMemoryUsage() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	return memoryUsage;
+}
+
+//------------------------------------------------------------------------------
+void cModelHistory::setMemoryBudget (std::size_t budget)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	memoryBudget = budget;
+	shrinkToBudget();
+}
+
+//------------------------------------------------------------------------------
+void cModelHistory::add (const cModel& model)
+{
+	if (!snapshots.empty() && snapshots.back().gameTime == model.getGameTime()) return;
+	if (unitsData != model.getUnitsData())
+	{
+		// different units data: the old snapshots can't be loaded anymore
+		snapshots.clear();
+		actions.clear();
+		memoryUsage = 0;
+		unitsData = model.getUnitsData();
+	}
+
+	sSnapshot snapshot;
+	snapshot.gameTime = model.getGameTime();
+	snapshot.turn = model.getTurnCounter()->getTurn();
+	cBinaryArchiveOut archive (snapshot.data);
+	model.save (archive, false);
+	snapshot.data.shrink_to_fit();
+
+	memoryUsage += snapshot.data.size();
+	snapshots.push_back (std::move (snapshot));
+	knownGameTime = std::max (knownGameTime, model.getGameTime());
+	shrinkToBudget();
+}
+
+//------------------------------------------------------------------------------
+void cModelHistory::shrinkToBudget()
+{
+	while (memoryUsage > memoryBudget && snapshots.size() > 1)
+	{
+		memoryUsage -= snapshots.front().data.size();
+		snapshots.pop_front();
+
+		// actions before the oldest snapshot are not needed anymore
+		const auto oldestGameTime = snapshots.front().gameTime;
+		while (!actions.empty() && actions.front().gameTime < oldestGameTime)
+		{
+			memoryUsage -= actions.front().data.size();
+			actions.pop_front();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+const cModelHistory::sSnapshot* cModelHistory::findNearest (unsigned int gameTime) const
+{
+	auto it = std::upper_bound (snapshots.begin(), snapshots.end(), gameTime, [] (unsigned int time, const sSnapshot& snapshot) { return time < snapshot.gameTime; });
+	if (it == snapshots.begin()) return nullptr;
+	return &*std::prev (it);
+}
+
+//------------------------------------------------------------------------------
+void cModelHistory::load (cModel& model, const sSnapshot& snapshot) const
+{
+	if (model.getUnitsData() != unitsData) model.setUnitsData (unitsData);
+
+	cBinaryArchiveIn archive (snapshot.data.data(), snapshot.data.size());
+	model.load (archive, false);
+}
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_logic_modelhistoryH
+#define game_logic_modelhistoryH
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+class cAction;
+class cModel;
+class cUnitsData;
+
+/**
+ * Keeps binary copies of a model at regular game times in memory,
+ * so that the model can be brought to an earlier game time quickly:
+ * the nearest snapshot before that time is loaded
+ * and the actions recorded since then are executed again.
+ *
+ * A snapshot is taken at the start of each turn
+ * and when the snapshot interval has passed since the last one.
+ * The snapshots and the recorded actions share a memory budget.
+ * When it is exceeded, the oldest snapshots are dropped
+ * together with the actions, that are only needed to replay from them.
+ * The latest snapshot is always kept.
+ *
+ * Snapshots don't contain the units data.
+ * It is shared between all snapshots and set on the model, they are loaded into.
+ *
+ * All methods are thread safe, so that the owner of the model can take snapshots,
+ * while another thread seeks a copy of the model.
+ */
+class cModelHistory
+{
+public:
+	static constexpr unsigned int defaultInterval = 500;
+	static constexpr std::size_t defaultMemoryBudget = 64 * 1024 * 1024;
+
+	explicit cModelHistory (unsigned int interval = defaultInterval, std::size_t memoryBudget = defaultMemoryBudget);
+	~cModelHistory();
+
+	/** Removes all snapshots and actions. Has to be called, when a different game is loaded into the model */
+	void clear();
+
+	/** Takes a snapshot of the model */
+	void take (const cModel&);
+	/**
+	 * Takes a snapshot, if a new turn has started or the interval has passed.
+	 * Called after each tick of the model.
+	 */
+	void update (const cModel&);
+
+	/**
+	 * Records an action, which is executed on the model at the current game time.
+	 * Actions are only needed by seek(), users with an own action log
+	 * (e.g. a replay) just call restoreNearest().
+	 */
+	void recordAction (unsigned int gameTime, const cAction&);
+
+	/**
+	 * Loads the latest snapshot, that is not newer than the given game time.
+	 * Returns the game time of the loaded snapshot or nothing,
+	 * when there is no such snapshot.
+	 */
+	std::optional<unsigned int> restoreNearest (cModel&, unsigned int gameTime) const;
+	/** Game time of the snapshot, restoreNearest() would load */
+	std::optional<unsigned int> getNearestGameTime (unsigned int gameTime) const;
+
+	/**
+	 * Brings the model to the given game time:
+	 * loads the nearest snapshot and runs the model with the recorded actions to the game time.
+	 * The model is in the state at the end of the tick to the game time,
+	 * before the actions of that game time are executed.
+	 * Returns false, if the game time is not covered by the snapshots and recorded actions.
+	 */
+	bool seek (cModel&, unsigned int gameTime) const;
+
+	std::optional<unsigned int> getOldestGameTime() const;
+	std::optional<unsigned int> getLatestGameTime() const;
+	std::size_t size() const;
+	std::size_t getMemoryUsage() const;
+
+	void setMemoryBudget (std::size_t);
+
+private:
+	struct sSnapshot
+	{
+		unsigned int gameTime = 0;
+		int turn = 0;
+		std::vector<unsigned char> data;
+	};
+	struct sRecordedAction
+	{
+		unsigned int gameTime = 0;
+		std::vector<unsigned char> data;
+	};
+
+	void add (const cModel&);
+	void shrinkToBudget();
+	const sSnapshot* findNearest (unsigned int gameTime) const;
+	void load (cModel&, const sSnapshot&) const;
+
+private:
+	mutable std::mutex mutex;
+	const unsigned int interval;
+	std::size_t memoryBudget;
+	std::size_t memoryUsage = 0;
+	std::shared_ptr<const cUnitsData> unitsData; // keeps the units data of the snapshots available
+	std::deque<sSnapshot> snapshots;
+	std::deque<sRecordedAction> actions;
+	unsigned int knownGameTime = 0; // latest game time, up to which the model can be restored
+};
+
+#endif // game_logic_modelhistoryH
@@ -0,0 +1,186 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/logic/modelsnapshot.h"
+
+#include "game/data/model.h"
+#include "game/data/player/player.h"
+#include "game/data/units/building.h"
+#include "game/data/units/vehicle.h"
+#include "game/logic/turncounter.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+	//--------------------------------------------------------------------------
+	sModelSnapshot::sUnit makeUnitSnapshot (const cUnit& unit, int playerId)
+	{
+		sModelSnapshot::sUnit result;
+		result.id = unit.getId();
+		result.playerId = playerId;
+		result.typeId = unit.data.getId();
+		result.position = unit.getPosition();
+		result.hitpoints = unit.data.getHitpoints();
+		result.hitpointsMax = unit.data.getHitpointsMax();
+		result.ammo = unit.data.getAmmo();
+		result.speed = unit.data.getSpeed();
+		result.storedUnits = static_cast<int> (unit.storedUnits.size());
+
+		result.flags = sModelSnapshot::getUnitFlags (unit);
+		result.buildProgress = sModelSnapshot::getBuildProgress (unit);
+		if (const auto* vehicle = dynamic_cast<const cVehicle*> (&unit))
+		{
+			result.flightHeight = vehicle->getFlightHeight();
+		}
+		return result;
+	}
+} // namespace
+
+//------------------------------------------------------------------------------
+/*static*/ int sModelSnapshot::getUnitFlags (const cUnit& unit)
+{
+	int flags = 0;
+	if (unit.getIsBig()) flags |= Big;
+	if (unit.isSentryActive()) flags |= SentryActive;
+	if (unit.isManualFireActive()) flags |= ManualFireActive;
+	if (unit.isDisabled()) flags |= Disabled;
+
+	const auto& staticData = unit.getStaticUnitData();
+	if (staticData.factorAir > 0) flags |= Plane;
+	if (staticData.isStealthOn != 0) flags |= Stealth;
+	if (staticData.buildingData.connectsToBase) flags |= ConnectsToBase;
+	if (staticData.surfacePosition == eSurfacePosition::AboveBase || staticData.surfacePosition == eSurfacePosition::BeneathSea) flags |= Mine;
+	if (staticData.canAttack != 0) flags |= Armed;
+	if (const auto* building = dynamic_cast<const cBuilding*> (&unit))
+	{
+		flags |= Building;
+		if (building->isUnitWorking()) flags |= Working;
+		if (building->isRubble()) flags |= Rubble;
+	}
+	else if (const auto* vehicle = dynamic_cast<const cVehicle*> (&unit))
+	{
+		if (vehicle->isUnitBuildingABuilding()) flags |= BuildingABuilding | Working;
+	}
+	return flags;
+}
+
+//------------------------------------------------------------------------------
+/*static*/ int sModelSnapshot::getBuildProgress (const cUnit& unit)
+{
+	int total = 0;
+	int remaining = 0;
+	if (const auto* vehicle = dynamic_cast<const cVehicle*> (&unit))
+	{
+		if (!vehicle->isUnitBuildingABuilding()) return 0;
+		total = vehicle->getBuildCostsStart();
+		remaining = vehicle->getBuildCosts();
+	}
+	else if (const auto* building = dynamic_cast<const cBuilding*> (&unit))
+	{
+		if (!building->isUnitWorking() || building->isBuildListEmpty() || !building->getOwner()) return 0;
+		const auto& item = building->getBuildListItem (0);
+		const auto* data = std::as_const (*building->getOwner()).getLastUnitData (item.getType());
+		total = data ? data->getBuildCost() : 0;
+		remaining = item.getRemainingMetal();
+	}
+	if (total <= 0) return 0;
+	return std::clamp ((total - remaining) * 100 / total, 0, 100);
+}
+
+//------------------------------------------------------------------------------
+void cModelSnapshotPublisher::attach (const cModel& model)
+{
+	// after detach() the previous model does not publish anymore,
+	// because tickFinished is locked while its slots are called
+	detach();
+	buffer.discard();
+	hasSnapshot = false;
+	connectionManager.connect (model.tickFinished, [this, &model]() { publish (model); });
+}
+
+//------------------------------------------------------------------------------
+void cModelSnapshotPublisher::detach()
+{
+	connectionManager.disconnectAll();
+}
+
+//------------------------------------------------------------------------------
+const sModelSnapshot* cModelSnapshotPublisher::acquire()
+{
+	if (buffer.acquire()) hasSnapshot = true;
+	return hasSnapshot ? &buffer.getReadBuffer() : nullptr;
+}
+
+//------------------------------------------------------------------------------
+void cModelSnapshotPublisher::publish (const cModel& model)
+{
+	auto& snapshot = buffer.getWriteBuffer();
+	capture (model, snapshot);
+	snapshot.version = nextVersion++;
+	buffer.publish();
+}
+
+//------------------------------------------------------------------------------
+/*static*/ void cModelSnapshotPublisher::capture (const cModel& model, sModelSnapshot& snapshot)
+{
+	snapshot.gameTime = model.getGameTime();
+	snapshot.turn = model.getTurnCounter()->getTurn();
+	snapshot.turnActive = false;
+
+	const auto& players = model.getPlayerList();
+	snapshot.players.resize (players.size());
+	snapshot.units.clear();
+
+	// the visibility depends on the detection state of the units,
+	// so the reader can not derive it from the scan bits
+	const auto& map = *model.getMap();
+	const auto addUnit = [&] (const cUnit& unit, int playerId) {
+		auto& unitSnapshot = snapshot.units.emplace_back (makeUnitSnapshot (unit, playerId));
+		for (size_t i = 0; i != std::min<size_t> (players.size(), 32); ++i)
+		{
+			if (players[i]->canSeeUnit (unit, map)) unitSnapshot.visibleToPlayers |= uint32_t (1) << i;
+		}
+	};
+
+	for (size_t i = 0; i != players.size(); ++i)
+	{
+		const auto& player = *players[i];
+		auto& playerSnapshot = snapshot.players[i];
+		playerSnapshot.id = player.getId();
+		playerSnapshot.name = player.getName();
+		playerSnapshot.credits = player.getCredits();
+		playerSnapshot.hasFinishedTurn = player.getHasFinishedTurn();
+		playerSnapshot.isDefeated = player.isDefeated;
+		playerSnapshot.scanBits = player.getScanMap().getBits();
+		playerSnapshot.scanWordsPerRow = player.getScanMap().getWordsPerRow();
+		if (!player.isDefeated && !player.getHasFinishedTurn()) snapshot.turnActive = true;
+
+		for (const auto& building : player.getBuildings())
+		{
+			addUnit (*building, player.getId());
+		}
+		for (const auto& vehicle : player.getVehicles())
+		{
+			if (vehicle->isUnitLoaded()) continue;
+			addUnit (*vehicle, player.getId());
+		}
+	}
+}
@@ -0,0 +1,142 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_logic_modelsnapshotH
+#define game_logic_modelsnapshotH
+
+#include "game/data/units/id.h"
+#include "utility/position.h"
+#include "utility/signal/signalconnectionmanager.h"
+#include "utility/thread/triplebuffer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class cModel;
+class cUnit;
+
+/**
+ * Copy of the model state, that a presentation layer needs every frame:
+ * units, players with their visibility and the turn state.
+ */
+struct sModelSnapshot
+{
+	enum eUnitFlag
+	{
+		Building = 1 << 0,
+		Big = 1 << 1,
+		Working = 1 << 2,
+		BuildingABuilding = 1 << 3,
+		SentryActive = 1 << 4,
+		ManualFireActive = 1 << 5,
+		Disabled = 1 << 6,
+		Rubble = 1 << 7,
+		Plane = 1 << 8,
+		Stealth = 1 << 9,
+		ConnectsToBase = 1 << 10,
+		Mine = 1 << 11,
+		Armed = 1 << 12
+	};
+
+	/** returns the combination of eUnitFlag, that describes the unit */
+	static int getUnitFlags (const cUnit&);
+	/** returns the progress of the building or vehicle, the unit is constructing, in percent */
+	static int getBuildProgress (const cUnit&);
+
+	struct sUnit
+	{
+		unsigned int id = 0;
+		int playerId = -1; // -1 for neutral units
+		sID typeId;
+		cPosition position;
+		int flags = 0; // combination of eUnitFlag
+		int hitpoints = 0;
+		int hitpointsMax = 0;
+		int ammo = 0;
+		int speed = 0;
+		int storedUnits = 0;
+		int flightHeight = 0;
+		int buildProgress = 0; // 0..100, see getBuildProgress()
+		uint32_t visibleToPlayers = 0; // bit i is set, when players[i] can see the unit
+	};
+
+	struct sPlayer
+	{
+		int id = -1;
+		std::string name;
+		int credits = 0;
+		bool hasFinishedTurn = false;
+		bool isDefeated = false;
+		/** scan map bits, see cRangeMap::getBits() */
+		std::vector<uint64_t> scanBits;
+		int scanWordsPerRow = 0;
+	};
+
+	/** number of the tick, after which the snapshot was taken. Starts at 1 */
+	uint64_t version = 0;
+	unsigned int gameTime = 0;
+	int turn = 0;
+	bool turnActive = false; // at least one player can still give orders
+	std::vector<sPlayer> players;
+	std::vector<sUnit> units; // buildings and vehicles of all players, except loaded vehicles
+};
+
+/**
+ * Takes a snapshot of the model at the end of every tick, on the thread
+ * running the model, and hands it to one reader thread (the Godot main
+ * thread) via a triple buffer. The reader gets consistent state without
+ * locking, and the model thread never waits for the reader.
+ */
+class cModelSnapshotPublisher
+{
+public:
+	cModelSnapshotPublisher() = default;
+	cModelSnapshotPublisher (const cModelSnapshotPublisher&) = delete;
+	cModelSnapshotPublisher& operator= (const cModelSnapshotPublisher&) = delete;
+
+	/**
+	 * Starts taking snapshots of the given model after each tick.
+	 * Snapshots of a previously attached model are dropped.
+	 * Called by the reader thread, the model thread may already run.
+	 */
+	void attach (const cModel&);
+	void detach();
+
+	/**
+	 * reader side: returns the latest snapshot, or nullptr when no tick ran
+	 * since the last attach(). The returned snapshot stays valid and unchanged
+	 * until the next call of this function or of attach().
+	 */
+	const sModelSnapshot* acquire();
+
+	/** Copies the state of the model into the snapshot. Version is not changed. */
+	static void capture (const cModel&, sModelSnapshot&);
+
+private:
+	void publish (const cModel&);
+
+private:
+	cSignalConnectionManager connectionManager;
+	cTripleBuffer<sModelSnapshot> buffer;
+	uint64_t nextVersion = 1; // owned by the model thread
+	bool hasSnapshot = false; // owned by the reader thread
+};
+
+#endif // game_logic_modelsnapshotH
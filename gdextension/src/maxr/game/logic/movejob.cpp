@@ -62,7 +62,7 @@ cMoveJob::cMoveJob() :
 {}
 
 //------------------------------------------------------------------------------
-cMoveJob::cMoveJob (const std::forward_list<cPosition>& path, cVehicle& vehicle) :
+cMoveJob::cMoveJob (const cPath& path, cVehicle& vehicle) :
 	vehicleId (vehicle.getId()),
 	path (path),
 	state (eMoveJobState::Waiting),
@@ -265,11 +265,7 @@ bool cMoveJob::recalculatePath (cModel& model, cVehicle& vehicle)
 	auto iter = std::ranges::find_if (playerList, [&] (const std::shared_ptr<cPlayer>& player) { return player->getId() == vehicle.getOwner()->getId(); });
 	const cMapView mapView (model.getMap(), *iter);
 
-	cPosition dest;
-	for (const auto& pos : path)
-		dest = pos;
-
-	cPathCalculator pc (vehicle, mapView, dest, false);
+	cPathCalculator pc (vehicle, mapView, path.back(), false);
 	auto newPath = pc.calcPath(); //TODO: don't execute path calculation on each model
 	if (!newPath.empty())
 	{
@@ -307,7 +303,7 @@ void cMoveJob::moveVehicle (cModel& model, cVehicle& vehicle)
 
 	int x = abs (vehicle.getMovementOffset().x());
 	int y = abs (vehicle.getMovementOffset().y());
-	if (vehicle.getStaticData().makeTracks && ((x > 32 && x - pixelToMove / 100 <= 32) || (y > 32 && y - pixelToMove / 100 <= 32) || (x == 64 && pixelToMove / 100 >= 1) || (y == 64 && pixelToMove / 100 >= 1)))
+	if (model.getAnimationSignalsEnabled() && vehicle.getStaticData().makeTracks && ((x > 32 && x - pixelToMove / 100 <= 32) || (y > 32 && y - pixelToMove / 100 <= 32) || (x == 64 && pixelToMove / 100 >= 1) || (y == 64 && pixelToMove / 100 >= 1)))
 	{
 		// this is a bit crude, but I don't know another simple way of notifying the
 		// gui, that is might wants to add a track effect.
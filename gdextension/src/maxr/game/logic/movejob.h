@@ -22,10 +22,10 @@
 
 #include "game/logic/endmoveaction.h"
 #include "utility/direction.h"
+#include "utility/path.h"
 #include "utility/position.h"
 #include "utility/serialization/serialization.h"
 
-#include <forward_list>
 #include <memory>
 #include <optional>
 
@@ -44,12 +44,12 @@ class cMoveJob
 {
 public:
 	cMoveJob();
-	cMoveJob (const std::forward_list<cPosition>& path, cVehicle&);
+	cMoveJob (const cPath& path, cVehicle&);
 	/**
 	* gets the list of position that make up the path. First element is the position,
 	* the unit will drive to when starting the next movement step.
 	*/
-	const std::forward_list<cPosition>& getPath() const { return path; }
+	const cPath& getPath() const { return path; }
 	/**
 	* return the moved vehicle
 	*/
@@ -168,7 +168,7 @@ private:
 	/** the vehicle to move */
 	std::optional<int> vehicleId;
 	/** list of positions. First element is the next field, that the unit will drive to after the current one. */
-	std::forward_list<cPosition> path;
+	cPath path;
 	eMoveJobState state = eMoveJobState::Active;
 
 	/** movement points, that are taken to the next turn, to prevent that the player looses movement points due to rounding issues */
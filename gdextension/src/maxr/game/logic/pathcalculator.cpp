@@ -29,7 +29,6 @@
 #include "utility/ranges.h"
 
 #include <cassert>
-#include <forward_list>
 
 /* Size of a memory block while pathfinding */
 #define MEM_BLOCK_SIZE 10
@@ -118,9 +117,9 @@ cPathCalculator::~cPathCalculator()
 }
 
 //------------------------------------------------------------------------------
-std::forward_list<cPosition> cPathCalculator::calcPath()
+cPath cPathCalculator::calcPath()
 {
-	std::forward_list<cPosition> path;
+	cPath path;
 
 	// generate open and closed list
 	nodesHeap.resize (Map->getSize().x() * Map->getSize().y() + 1, nullptr);
@@ -153,14 +152,14 @@ std::forward_list<cPosition> cPathCalculator::calcPath()
 		{
 			sPathNode* pathNode = CurrentNode;
 
-			cPosition waypoint;
+			// collect the waypoints from the destination back to the start
 			while (pathNode->prev != nullptr)
 			{
-				waypoint = pathNode->position;
-				path.push_front (waypoint);
+				path.push_back (pathNode->position);
 
 				pathNode = pathNode->prev;
 			}
+			path.reverse();
 
 			return path;
 		}
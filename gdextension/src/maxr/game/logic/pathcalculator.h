@@ -23,10 +23,9 @@
 #include "game/data/map/map.h"
 #include "game/data/units/building.h"
 #include "game/data/units/vehicle.h"
+#include "utility/path.h"
 #include "utility/position.h"
 
-#include <forward_list>
-
 class cVehicle;
 class cUnit;
 class cMapView;
@@ -81,7 +80,7 @@ public:
 	* calculates the best path in costs and length
 	*@author alzi alias DoctorDeath
 	*/
-	std::forward_list<cPosition> calcPath();
+	cPath calcPath();
 
 	/**
 	* calculates the costs for moving from the source- to the destinationfield
@@ -0,0 +1,296 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/logic/replay.h"
+
+#include "game/data/gamesettings.h"
+#include "game/data/model.h"
+#include "game/logic/action/action.h"
+#include "game/logic/turntimeclock.h"
+#include "game/protocol/netmessage.h"
+#include "utility/log.h"
+#include "utility/serialization/binaryarchive.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+	constexpr std::size_t headerSizeVersion1 = 3 * sizeof (std::uint32_t);
+	constexpr std::size_t headerSize = 4 * sizeof (std::uint32_t);
+	constexpr std::size_t recordHeaderSize = 1 + 2 * sizeof (std::uint32_t);
+} // namespace
+
+//------------------------------------------------------------------------------
+cReplayRecorder::cReplayRecorder (const std::filesystem::path& path_, const cModel& model_, unsigned int keyframeInterval_) :
+	model (model_),
+	path (path_),
+	file (path_, std::ios::out | std::ios::binary | std::ios::trunc),
+	keyframeInterval (std::max (keyframeInterval_, 1u))
+{
+	if (!file) throw std::runtime_error ("Can't write replay file " + path.string());
+
+	std::vector<unsigned char> header;
+	cBinaryArchiveOut archive (header);
+	archive << replay::magic;
+	archive << replay::version;
+	archive << static_cast<std::uint32_t> (keyframeInterval);
+	archive << static_cast<std::uint32_t> (getCheckSumAlgorithm());
+	file.write (reinterpret_cast<const char*> (header.data()), header.size());
+
+	buffer.clear();
+	cBinaryArchiveOut modelArchive (buffer);
+	model.save (modelArchive);
+	writeRecord (replay::eRecordType::Model, buffer);
+
+	signalConnectionManager.connect (model.tickFinished, [this]() {
+		if (model.getGameTime() % keyframeInterval != 0) return;
+
+		buffer.clear();
+		cBinaryArchiveOut archive (buffer);
+		archive << model.getChecksum();
+		writeRecord (replay::eRecordType::Keyframe, buffer);
+		file.flush();
+	});
+}
+
+//------------------------------------------------------------------------------
+cReplayRecorder::~cReplayRecorder()
+{
+	signalConnectionManager.disconnectAll();
+	writeRecord (replay::eRecordType::End, {});
+}
+
+//------------------------------------------------------------------------------
+void cReplayRecorder::recordAction (const cAction& action)
+{
+	buffer.clear();
+	cBinaryArchiveOut archive (buffer);
+	archive << action;
+	writeRecord (replay::eRecordType::Action, buffer);
+}
+
+//------------------------------------------------------------------------------
+void cReplayRecorder::writeRecord (replay::eRecordType type, const std::vector<unsigned char>& payload)
+{
+	std::vector<unsigned char> header;
+	cBinaryArchiveOut archive (header);
+	archive << static_cast<unsigned char> (type);
+	archive << static_cast<std::uint32_t> (model.getGameTime());
+	archive << static_cast<std::uint32_t> (payload.size());
+	file.write (reinterpret_cast<const char*> (header.data()), header.size());
+	file.write (reinterpret_cast<const char*> (payload.data()), payload.size());
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+cReplay::cReplay (const std::filesystem::path& path)
+{
+	std::ifstream file (path, std::ios::in | std::ios::binary);
+	if (!file) throw std::runtime_error ("Can't open replay file " + path.string());
+	const std::vector<unsigned char> data{std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char>()};
+
+	if (data.size() < headerSizeVersion1) throw std::runtime_error ("Not a replay file: " + path.string());
+	cBinaryArchiveIn header (data.data(), headerSizeVersion1);
+	std::uint32_t fileMagic = 0;
+	std::uint32_t fileVersion = 0;
+	std::uint32_t interval = 0;
+	header >> fileMagic >> fileVersion >> interval;
+	if (fileMagic != replay::magic) throw std::runtime_error ("Not a replay file: " + path.string());
+	keyframeInterval = interval;
+
+	std::size_t offset = headerSizeVersion1;
+	if (fileVersion == 1)
+	{
+		// recorded before the checksum algorithm was selectable
+		recordedCheckSumAlgorithm = eCheckSumAlgorithm::Legacy;
+	}
+	else if (fileVersion == replay::version && data.size() >= headerSize)
+	{
+		cBinaryArchiveIn algorithmArchive (data.data() + offset, sizeof (std::uint32_t));
+		std::uint32_t algorithm = 0;
+		algorithmArchive >> algorithm;
+		recordedCheckSumAlgorithm = static_cast<eCheckSumAlgorithm> (algorithm);
+		offset = headerSize;
+	}
+	else
+	{
+		throw std::runtime_error ("Unsupported replay version " + std::to_string (fileVersion));
+	}
+	if (recordedCheckSumAlgorithm != getCheckSumAlgorithm())
+	{
+		Log.warn ("Replay was recorded with a different checksum algorithm. Divergences can't be detected.");
+	}
+
+	std::optional<unsigned int> recordedEndGameTime;
+	while (offset + recordHeaderSize <= data.size() && !recordedEndGameTime)
+	{
+		cBinaryArchiveIn recordHeader (data.data() + offset, recordHeaderSize);
+		unsigned char type = 0;
+		std::uint32_t gameTime = 0;
+		std::uint32_t size = 0;
+		recordHeader >> type >> gameTime >> size;
+		offset += recordHeaderSize;
+		if (data.size() - offset < size) break; // truncated
+
+		const unsigned char* payload = data.data() + offset;
+		offset += size;
+
+		switch (static_cast<replay::eRecordType> (type))
+		{
+			case replay::eRecordType::Model:
+				if (!initialModel.empty()) throw std::runtime_error ("Replay file contains more than one model");
+				initialModel.assign (payload, payload + size);
+				startGameTime = gameTime;
+				break;
+			case replay::eRecordType::Action:
+			{
+				auto message = cNetMessage::createFromBuffer (payload, static_cast<int> (size));
+				if (message->getType() != eNetMessageType::ACTION) throw std::runtime_error ("Invalid action in replay file");
+				actions.push_back ({gameTime, std::unique_ptr<cAction> (static_cast<cAction*> (message.release()))});
+				break;
+			}
+			case replay::eRecordType::Keyframe:
+			{
+				cBinaryArchiveIn archive (payload, size);
+				sKeyframe keyframe;
+				keyframe.gameTime = gameTime;
+				archive >> keyframe.checksum;
+				keyframes.push_back (keyframe);
+				break;
+			}
+			case replay::eRecordType::End:
+				recordedEndGameTime = gameTime;
+				break;
+			default:
+				throw std::runtime_error ("Invalid record type in replay file: " + std::to_string (type));
+		}
+	}
+	if (initialModel.empty()) throw std::runtime_error ("Replay file contains no model");
+
+	if (recordedEndGameTime)
+	{
+		endGameTime = *recordedEndGameTime;
+	}
+	else
+	{
+		// incomplete recording: play until the last record
+		endGameTime = startGameTime;
+		if (!actions.empty()) endGameTime = std::max (endGameTime, actions.back().gameTime);
+		if (!keyframes.empty()) endGameTime = std::max (endGameTime, keyframes.back().gameTime);
+	}
+}
+
+//------------------------------------------------------------------------------
+cReplay::~cReplay() = default;
+
+//------------------------------------------------------------------------------
+void cReplay::restore (cModel& model)
+{
+	cBinaryArchiveIn archive (initialModel.data(), initialModel.size());
+	model.load (archive);
+
+	nextAction = 0;
+	nextKeyframe = 0;
+	divergenceGameTime = std::nullopt;
+}
+
+//------------------------------------------------------------------------------
+unsigned int cReplay::advance (cModel& model, unsigned int ticks)
+{
+	unsigned int ticksRun = 0;
+	for (; ticksRun < ticks && !isFinished (model); ++ticksRun)
+	{
+		executeActions (model);
+		model.advanceGameTime();
+		checkKeyframe (model);
+		if (!divergenceGameTime) history.update (model);
+	}
+	if (isFinished (model)) executeActions (model);
+	return ticksRun;
+}
+
+//------------------------------------------------------------------------------
+unsigned int cReplay::seek (cModel& model, unsigned int gameTime)
+{
+	gameTime = std::clamp (gameTime, startGameTime, endGameTime);
+
+	// going forward from the current state is cheaper than loading an older snapshot
+	const auto snapshotGameTime = history.getNearestGameTime (gameTime);
+	const auto currentGameTime = model.getGameTime();
+	if (gameTime < currentGameTime || (snapshotGameTime && *snapshotGameTime > currentGameTime))
+	{
+		if (snapshotGameTime)
+		{
+			history.restoreNearest (model, gameTime);
+			setPosition (*snapshotGameTime);
+		}
+		else
+		{
+			restore (model);
+		}
+	}
+	advance (model, gameTime - model.getGameTime());
+	return model.getGameTime();
+}
+
+//------------------------------------------------------------------------------
+bool cReplay::isFinished (const cModel& model) const
+{
+	return model.getGameTime() >= endGameTime;
+}
+
+//------------------------------------------------------------------------------
+void cReplay::executeActions (cModel& model)
+{
+	const auto gameTime = model.getGameTime();
+	for (; nextAction < actions.size() && actions[nextAction].gameTime <= gameTime; ++nextAction)
+	{
+		const auto& recorded = actions[nextAction];
+		if (recorded.gameTime < gameTime) continue; // before the restored state
+		if (model.getPlayer (recorded.action->playerNr) == nullptr) continue;
+
+		recorded.action->execute (model);
+	}
+}
+
+//------------------------------------------------------------------------------
+void cReplay::setPosition (unsigned int gameTime)
+{
+	// a snapshot is the state after the tick to its game time: the actions of that game time are still pending
+	nextAction = std::distance (actions.begin(), std::ranges::lower_bound (actions, gameTime, {}, &sRecordedAction::gameTime));
+	nextKeyframe = std::distance (keyframes.begin(), std::ranges::upper_bound (keyframes, gameTime, {}, &sKeyframe::gameTime));
+	if (divergenceGameTime && *divergenceGameTime > gameTime) divergenceGameTime = std::nullopt;
+}
+
+//------------------------------------------------------------------------------
+void cReplay::checkKeyframe (const cModel& model)
+{
+	const auto gameTime = model.getGameTime();
+	for (; nextKeyframe < keyframes.size() && keyframes[nextKeyframe].gameTime <= gameTime; ++nextKeyframe)
+	{
+		const auto& keyframe = keyframes[nextKeyframe];
+		if (keyframe.gameTime < gameTime) continue;
+		if (divergenceGameTime || recordedCheckSumAlgorithm != getCheckSumAlgorithm() || keyframe.checksum == model.getChecksum()) continue;
+
+		divergenceGameTime = gameTime;
+		Log.warn ("Replay diverged from the recording @" + std::to_string (gameTime));
+	}
+}
@@ -0,0 +1,179 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_logic_replayH
+#define game_logic_replayH
+
+#include "game/logic/modelhistory.h"
+#include "utility/crc.h"
+#include "utility/signal/signalconnectionmanager.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class cAction;
+class cModel;
+
+/**
+ * A replay file records a game as the model at the start of the recording,
+ * followed by the actions the server executed, each with the game time of its execution.
+ * As the model is deterministic, executing the actions on the initial model
+ * at the same game times reproduces the game.
+ * Keyframes store the checksum of the recorded model in regular intervals,
+ * so that a replay can detect, when it diverges from the recording
+ * (e.g. because the game logic has changed since).
+ *
+ * The file starts with a header (magic, version, keyframe interval, checksum algorithm), followed by records.
+ * Each record has a type, the game time and the size of its payload:
+ * - Model: the serialized model (the first record)
+ * - Action: the serialized action, executed before the tick at the game time
+ * - Keyframe: the checksum of the model after the tick to the game time
+ * - End: the game time at which the recording stopped
+ * A file, that was truncated (e.g. by a crash), can be replayed up to its last complete record.
+ */
+namespace replay
+{
+	enum class eRecordType : unsigned char
+	{
+		Model,
+		Action,
+		Keyframe,
+		End
+	};
+
+	constexpr std::uint32_t magic = 0x5052584D; // "MXRP"
+	constexpr std::uint32_t version = 2; // version 1 had no checksum algorithm in the header
+	constexpr unsigned int defaultKeyframeInterval = 100;
+} // namespace replay
+
+/**
+ * Writes a replay file of a game, while it is running.
+ * Used by the server. The model has to outlive the recorder.
+ */
+class cReplayRecorder
+{
+public:
+	/**
+	 * Creates the file and records the current state of the model.
+	 * Throws std::runtime_error, if the file can not be written.
+	 */
+	cReplayRecorder (const std::filesystem::path&, const cModel&, unsigned int keyframeInterval = replay::defaultKeyframeInterval);
+	~cReplayRecorder();
+
+	cReplayRecorder (const cReplayRecorder&) = delete;
+	cReplayRecorder& operator= (const cReplayRecorder&) = delete;
+
+	/** Records an action, which is executed on the model at the current game time */
+	void recordAction (const cAction&);
+
+	const std::filesystem::path& getPath() const { return path; }
+
+private:
+	void writeRecord (replay::eRecordType, const std::vector<unsigned char>& payload);
+
+private:
+	const cModel& model;
+	const std::filesystem::path path;
+	std::ofstream file;
+	unsigned int keyframeInterval;
+	cSignalConnectionManager signalConnectionManager;
+	std::vector<unsigned char> buffer;
+};
+
+/**
+ * Plays a replay file back on a model.
+ * The playback position belongs to the model, that was restored last.
+ */
+class cReplay
+{
+public:
+	struct sKeyframe
+	{
+		unsigned int gameTime = 0;
+		std::uint32_t checksum = 0;
+	};
+
+	/** Reads the file. Throws std::runtime_error, if it is no valid replay file */
+	explicit cReplay (const std::filesystem::path&);
+	~cReplay();
+
+	cReplay (const cReplay&) = delete;
+	cReplay& operator= (const cReplay&) = delete;
+
+	/** Sets the model to the start of the recording */
+	void restore (cModel&);
+
+	/**
+	 * Runs the model for the given number of ticks and executes the recorded actions on the way.
+	 * Stops at the end of the recording. Returns the number of ticks run.
+	 */
+	unsigned int advance (cModel&, unsigned int ticks);
+
+	/**
+	 * Brings the model to the given game time of the recording.
+	 * Starts from the nearest snapshot taken during earlier playback (or the start of the recording),
+	 * so that seeking back and forth does not run the whole recording again.
+	 * Returns the game time of the model.
+	 */
+	unsigned int seek (cModel&, unsigned int gameTime);
+
+	bool isFinished (const cModel&) const;
+
+	unsigned int getStartGameTime() const { return startGameTime; }
+	unsigned int getEndGameTime() const { return endGameTime; }
+	unsigned int getKeyframeInterval() const { return keyframeInterval; }
+	std::size_t getActionCount() const { return actions.size(); }
+	const std::vector<sKeyframe>& getKeyframes() const { return keyframes; }
+	const cModelHistory& getHistory() const { return history; }
+
+	/** Game time of the first keyframe, at which the model differed from the recording */
+	std::optional<unsigned int> getDivergenceGameTime() const { return divergenceGameTime; }
+
+private:
+	void executeActions (cModel&);
+	void checkKeyframe (const cModel&);
+	void setPosition (unsigned int gameTime);
+
+private:
+	struct sRecordedAction
+	{
+		unsigned int gameTime = 0;
+		std::unique_ptr<cAction> action;
+	};
+
+	std::vector<unsigned char> initialModel;
+	std::vector<sRecordedAction> actions;
+	std::vector<sKeyframe> keyframes;
+	unsigned int keyframeInterval = replay::defaultKeyframeInterval;
+	eCheckSumAlgorithm recordedCheckSumAlgorithm = eCheckSumAlgorithm::Legacy;
+	unsigned int startGameTime = 0;
+	unsigned int endGameTime = 0;
+
+	std::size_t nextAction = 0;
+	std::size_t nextKeyframe = 0;
+	std::optional<unsigned int> divergenceGameTime;
+
+	cModelHistory history; // in-memory snapshots of the played back model for seeking
+};
+
+#endif // game_logic_replayH
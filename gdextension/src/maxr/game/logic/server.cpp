@@ -25,10 +25,11 @@
 #include "game/data/report/special/savedreportlostconnection.h"
 #include "game/data/savegame.h"
 #include "game/logic/action/action.h"
+#include "game/logic/desyncdiagnosis.h"
+#include "game/logic/serverpool.h"
 #include "game/logic/turntimeclock.h"
 #include "game/protocol/netmessage.h"
 #include "game/startup/lobbypreparationdata.h"
-#include "settings.h"
 #include "utility/language.h"
 #include "utility/log.h"
 #include "utility/random.h"
@@ -38,19 +39,27 @@
 #include <cassert>
 
 //------------------------------------------------------------------------------
-cServer::cServer (std::shared_ptr<cConnectionManager> connectionManager) :
+cServer::cServer (std::shared_ptr<cConnectionManager> connectionManager, std::shared_ptr<const sEngineContext> context) :
+	context (std::move (context)),
 	connectionManager (connectionManager)
 {
+	if (this->context->modelHistoryBudget > 0)
+	{
+		history = std::make_unique<cModelHistory> (this->context->modelHistoryInterval, this->context->modelHistoryBudget);
+	}
 	model.turnEnded.connect ([this]() {
 		enableFreezeMode (eFreezeMode::WaitForTurnend);
 	});
 	model.newTurnStarted.connect ([this] (const sNewTurnReport&) {
-		if (cSettings::getInstance().shouldAutosave())
+		if (this->context->autosaveSlot)
 		{
-			saveGameState (10, lngPack.i18n ("Comp~Turn_5") + " " + std::to_string (model.getTurnCounter()->getTurn()) + " - " + lngPack.i18n ("Settings~Autosave"));
+			saveGameState (*this->context->autosaveSlot, lngPack.i18n ("Comp~Turn_5") + " " + std::to_string (model.getTurnCounter()->getTurn()) + " - " + lngPack.i18n ("Settings~Autosave"));
 		}
 		disableFreezeMode (eFreezeMode::WaitForTurnend);
 	});
+	model.tickFinished.connect ([this]() {
+		if (history) history->update (model);
+	});
 }
 
 //------------------------------------------------------------------------------
@@ -83,7 +92,7 @@ std::string cServer::getGameState() const
 //------------------------------------------------------------------------------
 void cServer::setPreparationData (const sLobbyPreparationData& preparationData)
 {
-	model.setUnitsData (std::make_shared<cUnitsData> (*preparationData.unitsData));
+	model.setUnitsData (preparationData.unitsData);
 	model.setGameSettings (*preparationData.gameSettings);
 	model.setMap (preparationData.staticMap);
 }
@@ -93,6 +102,12 @@ void cServer::setPlayers (const std::vector<cPlayerBasicData>& splayers)
 {
 	model.setPlayerList (splayers);
 	gameTimer.setPlayerNumbers (model.getPlayerList());
+
+	// the lobby has sent the units data with the game preparations
+	for (const auto& player : splayers)
+	{
+		playersWithUnitsData.insert (player.getNr());
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -104,33 +119,31 @@ const cModel& cServer::getModel() const
 //------------------------------------------------------------------------------
 void cServer::saveGameState (int saveGameNumber, const std::string& saveName) const
 {
-	if (SDL_ThreadID() != SDL_GetThreadID (serverThread))
+	if (!isServerThread())
 	{
 		//allow save writing of the server model from the main thread
-		exit = true;
-		SDL_WaitThread (serverThread, nullptr);
-		serverThread = nullptr;
+		stopServerThread();
 	}
 
 	NetLog.debug (" Server: writing gamestate to save file " + std::to_string (saveGameNumber) + ", Modelcrc: " + std::to_string (model.getChecksum()));
 
-	cSavegame savegame;
+	cSavegame savegame (context->savesPath);
 	savegame.save (model, saveGameNumber, saveName);
 	cNetMessageRequestGUISaveInfo message (saveGameNumber, ++savingID);
 	sendMessageToClients (message);
 
-	if (!serverThread)
+	if (!isServerThreadRunning())
 	{
-		exit = false;
-		serverThread = SDL_CreateThread (serverThreadCallback, "server", const_cast<cServer*> (this));
+		startServerThread();
 	}
 }
 //------------------------------------------------------------------------------
 void cServer::loadGameState (int saveGameNumber)
 {
 	NetLog.debug (" Server: loading game state from save file " + std::to_string (saveGameNumber));
-	cSavegame savegame;
+	cSavegame savegame (context->savesPath);
 	savegame.loadModel (model, saveGameNumber);
+	playersWithUnitsData.clear();
 
 	gameTimer.setPlayerNumbers (model.getPlayerList());
 }
@@ -140,7 +153,7 @@ void cServer::sendGuiInfoToClients (int saveGameNumber, [[maybe_unused]] int pla
 	// TODO: handle playerNr
 	try
 	{
-		cSavegame savegame;
+		cSavegame savegame (context->savesPath);
 		savegame.loadGuiInfo (this, saveGameNumber);
 	}
 	catch (std::runtime_error& e)
@@ -152,11 +165,27 @@ void cServer::sendGuiInfoToClients (int saveGameNumber, [[maybe_unused]] int pla
 //------------------------------------------------------------------------------
 void cServer::resyncClientModel (int playerNr /*= -1*/) const
 {
-	assert (serverThread == nullptr || SDL_ThreadID() == SDL_GetThreadID (serverThread));
+	assert (!isServerThreadRunning() || isServerThread());
+
+	std::vector<int> receivers;
+	for (const auto& player : model.getPlayerList())
+	{
+		if ((playerNr == -1 || player->getId() == playerNr) && connectionManager->isPlayerConnected (player->getId()))
+		{
+			receivers.push_back (player->getId());
+		}
+	}
+	// the units data is big, so it is only sent to clients, which do not know it already
+	const bool includeUnitsData = !std::ranges::all_of (receivers, [this] (int nr) { return playersWithUnitsData.contains (nr); });
 
-	NetLog.debug (" Server: Resynchronize client model " + std::to_string (playerNr));
-	cNetMessageResyncModel msg (model);
+	NetLog.debug (" Server: Resynchronize client model " + std::to_string (playerNr) + (includeUnitsData ? " with units data" : ""));
+	cNetMessageResyncModel msg (model, includeUnitsData);
 	sendMessageToClients (msg, playerNr);
+	playersWithUnitsData.insert (receivers.begin(), receivers.end());
+	for (int nr : receivers)
+	{
+		playersWithDiagnosedDesync.erase (nr);
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -168,7 +197,7 @@ void cServer::pushMessage (std::unique_ptr<cNetMessage> message)
 //------------------------------------------------------------------------------
 void cServer::sendMessageToClients (const cNetMessage& message, int playerNr /* = -1 */) const
 {
-	if (message.getType() != eNetMessageType::GAMETIME_SYNC_SERVER && message.getType() != eNetMessageType::RESYNC_MODEL)
+	if (message.getType() != eNetMessageType::GAMETIME_SYNC_SERVER && message.getType() != eNetMessageType::RESYNC_MODEL && message.getType() != eNetMessageType::DESYNC_REPORT)
 	{
 		nlohmann::json json;
 		cJsonArchiveOut jsonarchive (json);
@@ -189,9 +218,15 @@ void cServer::sendMessageToClients (const cNetMessage& message, int playerNr /*
 //------------------------------------------------------------------------------
 void cServer::start (std::optional<int> saveGameNumber)
 {
-	if (serverThread) return;
+	if (isServerThreadRunning()) return;
 
 	initRandomGenerator();
+	if (history)
+	{
+		history->clear();
+		history->take (model);
+	}
+	startReplayRecording();
 	initPlayerConnectionState();
 	updateWaitForClientFlag();
 
@@ -200,7 +235,7 @@ void cServer::start (std::optional<int> saveGameNumber)
 		resyncClientModel();
 		sendGuiInfoToClients (*saveGameNumber, -1);
 	}
-	serverThread = SDL_CreateThread (serverThreadCallback, "server", this);
+	startServerThread();
 	gameTimer.maxEventQueueSize = MAX_SERVER_EVENT_COUNTER;
 	gameTimer.start();
 }
@@ -208,37 +243,83 @@ void cServer::start (std::optional<int> saveGameNumber)
 //------------------------------------------------------------------------------
 void cServer::stop()
 {
-	exit = true;
 	gameTimer.stop();
+	stopServerThread();
+}
 
-	if (serverThread)
+//------------------------------------------------------------------------------
+void cServer::run()
+{
+	while (!exit)
 	{
-		SDL_WaitThread (serverThread, nullptr);
-		serverThread = nullptr;
+		runOnce();
+
+		SDL_Delay (10);
 	}
 }
 
 //------------------------------------------------------------------------------
-void cServer::run()
+void cServer::runOnce()
 {
-	while (!exit)
+	std::unique_lock<std::recursive_mutex> lock (modelMutex);
+
+	while (const auto message = eventQueue.try_pop())
 	{
-		while (const auto message = eventQueue.try_pop())
-		{
-			run (**message);
-		}
+		run (**message);
+	}
 
-		//TODO: gameinit: start timer, when all clients are ready
-		gameTimer.run (model, *this);
+	//TODO: gameinit: start timer, when all clients are ready
+	gameTimer.run (model, *this);
+}
 
-		SDL_Delay (10);
+//------------------------------------------------------------------------------
+bool cServer::isServerThread() const
+{
+	if (runningInPool) return cServerPool::isRunningOnCurrentThread (*this);
+	return SDL_ThreadID() == SDL_GetThreadID (serverThread);
+}
+
+//------------------------------------------------------------------------------
+bool cServer::isServerThreadRunning() const
+{
+	return serverThread != nullptr || runningInPool;
+}
+
+//------------------------------------------------------------------------------
+void cServer::startServerThread() const
+{
+	if (context->serverPool)
+	{
+		runningInPool = true;
+		context->serverPool->add (const_cast<cServer&> (*this));
+	}
+	else
+	{
+		exit = false;
+		serverThread = SDL_CreateThread (serverThreadCallback, "server", const_cast<cServer*> (this));
+	}
+}
+
+//------------------------------------------------------------------------------
+void cServer::stopServerThread() const
+{
+	if (runningInPool)
+	{
+		context->serverPool->remove (const_cast<cServer&> (*this));
+		runningInPool = false;
+	}
+	exit = true;
+	if (serverThread)
+	{
+		SDL_WaitThread (serverThread, nullptr);
+		serverThread = nullptr;
 	}
 }
 
 //------------------------------------------------------------------------------
 void cServer::run (const cNetMessage& message)
 {
-	if (message.getType() != eNetMessageType::GAMETIME_SYNC_CLIENT)
+	if (message.getType() != eNetMessageType::GAMETIME_SYNC_CLIENT && message.getType() != eNetMessageType::DESYNC_CHECKSUMS)
 	{
 		nlohmann::json json = nlohmann::json::object();
 		cJsonArchiveOut jsonarchive (json);
@@ -269,6 +350,8 @@ void cServer::run (const cNetMessage& message)
 				}
 			}
 
+			if (replayRecorder) replayRecorder->recordAction (action);
+			if (history) history->recordAction (model.getGameTime(), action);
 			action.execute (model);
 
 			sendMessageToClients (message);
@@ -295,7 +378,7 @@ void cServer::run (const cNetMessage& message)
 			}
 			else
 			{
-				cSavegame savegame;
+				cSavegame savegame (context->savesPath);
 				savegame.saveGuiInfo (saveInfo);
 			}
 			break;
@@ -361,12 +444,61 @@ void cServer::run (const cNetMessage& message)
 #endif
 			break;
 		}
+		case eNetMessageType::DESYNC_CHECKSUMS:
+			diagnoseDesync (static_cast<const cNetMessageDesyncChecksums&> (message));
+			break;
 		default:
 			NetLog.error (" Server: Can not handle net message!");
 			break;
 	}
 }
 
+//------------------------------------------------------------------------------
+void cServer::diagnoseDesync (const cNetMessageDesyncChecksums& message) const
+{
+	// the re-simulation stalls the game of all players, so each player gets one diagnosis until its next resync
+	if (playersWithDiagnosedDesync.contains (message.playerNr))
+	{
+		NetLog.warn (" Server: Ignoring the checksums of player " + std::to_string (message.playerNr) + ", the desync was diagnosed already");
+		return;
+	}
+	playersWithDiagnosedDesync.insert (message.playerNr);
+
+	NetLog.warn (" Server: Player " + std::to_string (message.playerNr) + " is out of sync @" + std::to_string (message.gameTime));
+
+	const auto oldestGameTime = history ? history->getOldestGameTime() : std::nullopt;
+	if (!oldestGameTime || message.gameTime < *oldestGameTime || message.gameTime > model.getGameTime())
+	{
+		NetLog.warn (" Server: Can't diagnose the desync, the game time is not in the model history");
+		sendMessageToClients (cNetMessageDesyncReport (message.gameTime, false, {}, {}), message.playerNr);
+		return;
+	}
+	cModel modelAtGameTime;
+	if (!history->seek (modelAtGameTime, message.gameTime))
+	{
+		NetLog.warn (" Server: Can't diagnose the desync, the game time is not in the model history anymore");
+		sendMessageToClients (cNetMessageDesyncReport (message.gameTime, false, {}, {}), message.playerNr);
+		return;
+	}
+
+	const auto parts = modelAtGameTime.getChecksumParts();
+	auto divergingParts = desync::findDivergingParts (desync::toChecksumList (parts), message.checksums);
+	NetLog.warn (" Server: " + std::to_string (divergingParts.size()) + " diverging parts");
+
+	// the state of all units would be too much, when everything diverged
+	const std::size_t maxDumpedParts = 100;
+	nlohmann::json serverState = nlohmann::json::object();
+	for (const auto& part : parts)
+	{
+		if (serverState.size() == maxDumpedParts) break;
+		if (!part.dump || std::ranges::find (divergingParts, part.name) == divergingParts.end()) continue;
+
+		NetLog.warn (" Server: diverging part " + part.name);
+		serverState[part.name] = part.dump();
+	}
+	sendMessageToClients (cNetMessageDesyncReport (message.gameTime, true, std::move (divergingParts), serverState.dump()), message.playerNr);
+}
+
 //------------------------------------------------------------------------------
 void cServer::initRandomGenerator()
 {
@@ -376,6 +508,24 @@ void cServer::initRandomGenerator()
 	sendMessageToClients (msg);
 }
 
+//------------------------------------------------------------------------------
+void cServer::startReplayRecording()
+{
+	if (context->replaysPath.empty() || replayRecorder) return;
+
+	try
+	{
+		std::filesystem::create_directories (context->replaysPath);
+		const auto path = context->replaysPath / ("replay_" + std::to_string (model.getGameId()) + "_" + std::to_string (model.getGameTime()) + ".mrp");
+		replayRecorder = std::make_unique<cReplayRecorder> (path, model);
+		NetLog.debug (" Server: recording replay to " + path.string());
+	}
+	catch (const std::exception& e)
+	{
+		NetLog.error (std::string (" Server: can't record replay: ") + e.what());
+	}
+}
+
 //------------------------------------------------------------------------------
 void cServer::enableFreezeMode (eFreezeMode mode)
 {
@@ -427,6 +577,8 @@ void cServer::playerDisconnected (int playerId)
 		//TODO: set to INACTIVE when running in dedicated mode
 		playerConnectionStates[playerId] = ePlayerConnectionState::Disconnected;
 	}
+	// a reconnecting client starts with an empty model
+	playersWithUnitsData.erase (playerId);
 	NetLog.debug (" Server: Player " + std::to_string (playerId) + " disconnected");
 	updateWaitForClientFlag();
 }
@@ -463,7 +615,7 @@ void cServer::updateGameTimerstate()
 	{
 		gameTimer.stop();
 	}
-	else if (serverThread != nullptr)
+	else if (isServerThreadRunning())
 	{
 		gameTimer.start();
 	}
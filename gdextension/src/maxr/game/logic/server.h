@@ -22,25 +22,32 @@
 
 #include "game/connectionmanager.h"
 #include "game/data/model.h"
+#include "game/enginecontext.h"
 #include "game/logic/gametimer.h"
+#include "game/logic/modelhistory.h"
+#include "game/logic/replay.h"
 #include "game/protocol/netmessage.h"
 #include "utility/thread/concurrentqueue.h"
 
 #include <SDL_thread.h>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 
 class cConnectionManager;
 class cPlayerBasicData;
+class cServerPool;
 
 struct sLobbyPreparationData;
 
 class cServer : public INetMessageReceiver
 {
 	friend class cDebugOutputWidget;
+	friend class cServerPool;
 
 public:
-	explicit cServer (std::shared_ptr<cConnectionManager>);
+	cServer (std::shared_ptr<cConnectionManager>, std::shared_ptr<const sEngineContext>);
 	~cServer();
 
 	void pushMessage (std::unique_ptr<cNetMessage>);
@@ -59,6 +66,17 @@ public:
 	void setPlayers (const std::vector<cPlayerBasicData>& splayers);
 
 	const cModel& getModel() const;
+	/**
+	* Held by the server thread while it processes messages and runs the model.
+	* Other threads lock it to read the model between two runs.
+	*/
+	std::recursive_mutex& getModelMutex() const { return modelMutex; }
+	/**
+	* In-memory snapshots of the model and the actions since then.
+	* Can be used from any thread to bring a copy of the model to an earlier game time.
+	* nullptr, if the engine context has no budget for it.
+	*/
+	const cModelHistory* getHistory() const { return history.get(); }
 	void saveGameState (int saveGameNumber, const std::string& saveName) const;
 	void loadGameState (int saveGameNumber);
 	void sendGuiInfoToClients (int saveGameNumber, int playerNr = -1);
@@ -81,6 +99,12 @@ public:
 
 private:
 	void initRandomGenerator();
+	void startReplayRecording();
+	/**
+	* Compares the checksums of a client, that is out of sync, with the model at the same game time
+	* and sends the diverging parts back. Once per player until its next resync.
+	*/
+	void diagnoseDesync (const cNetMessageDesyncChecksums&) const;
 	/**
 	* Update the player connection state and halt game if necessary.
 	*/
@@ -109,13 +133,24 @@ private:
 	// manage the server thread
 	static int serverThreadCallback (void* arg);
 	void run();
+	void runOnce();
+	bool isServerThread() const;
+	bool isServerThreadRunning() const;
+	void startServerThread() const;
+	void stopServerThread() const;
 
 	void run (const cNetMessage&);
 
 private:
 	cModel model;
+	mutable std::recursive_mutex modelMutex;
+	std::shared_ptr<const sEngineContext> context;
+	std::unique_ptr<cReplayRecorder> replayRecorder; // declared after the model, so that it is destroyed before
+	std::unique_ptr<cModelHistory> history;
 
 	std::map<int, ePlayerConnectionState> playerConnectionStates;
+	mutable std::set<int> playersWithUnitsData; // players, which client model knows the units data already
+	mutable std::set<int> playersWithDiagnosedDesync; // players, whose desync was diagnosed since their last resync
 	cFreezeModes freezeModes;
 	cGameTimerServer gameTimer;
 
@@ -125,6 +160,7 @@ private:
 	mutable int savingID = -1; //identifier number, to make sure the gui info from clients are written to the correct save file
 
 	mutable SDL_Thread* serverThread = nullptr;
+	mutable bool runningInPool = false;
 	mutable bool exit = false;
 };
 
@@ -0,0 +1,143 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/logic/serverpool.h"
+
+#include "game/logic/server.h"
+#include "utility/log.h"
+#include "utility/thread/parallelfor.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	constexpr std::chrono::milliseconds runInterval{10};
+
+	thread_local const cServer* currentServer = nullptr;
+} // namespace
+
+//------------------------------------------------------------------------------
+cServerPool::cServerPool (std::size_t threadCount)
+{
+	threads.reserve (std::max<std::size_t> (threadCount, 1));
+	for (std::size_t i = 0; i != std::max<std::size_t> (threadCount, 1); ++i)
+	{
+		threads.emplace_back ([this]() { work(); });
+	}
+}
+
+//------------------------------------------------------------------------------
+cServerPool::~cServerPool()
+{
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		assert (entries.empty());
+		exit = true;
+	}
+	changed.notify_all();
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+//------------------------------------------------------------------------------
+void cServerPool::add (cServer& server)
+{
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		assert (std::ranges::none_of (entries, [&] (const sEntry& entry) { return entry.server == &server; }));
+		entries.push_back ({&server, tClock::now(), false});
+	}
+	changed.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void cServerPool::remove (cServer& server)
+{
+	assert (!isRunningOnCurrentThread (server));
+
+	std::unique_lock<std::mutex> lock (mutex);
+	auto isServer = [&] (const sEntry& entry) { return entry.server == &server; };
+	changed.wait (lock, [&]() {
+		auto it = std::ranges::find_if (entries, isServer);
+		return it == entries.end() || !it->running;
+	});
+	std::erase_if (entries, isServer);
+}
+
+//------------------------------------------------------------------------------
+/*static*/ bool cServerPool::isRunningOnCurrentThread (const cServer& server)
+{
+	return currentServer == &server;
+}
+
+//------------------------------------------------------------------------------
+void cServerPool::work()
+{
+	// the servers already share the worker threads,
+	// so they must not start additional threads for parallelFor()
+	cSerialParallelForScope serialParallelFor;
+
+	std::unique_lock<std::mutex> lock (mutex);
+	while (!exit)
+	{
+		// the entry, which waits the longest
+		sEntry* next = nullptr;
+		for (auto& entry : entries)
+		{
+			if (!entry.running && (next == nullptr || entry.nextRun < next->nextRun))
+				next = &entry;
+		}
+		if (next == nullptr)
+		{
+			changed.wait (lock);
+			continue;
+		}
+		if (next->nextRun > tClock::now())
+		{
+			changed.wait_until (lock, next->nextRun);
+			continue;
+		}
+
+		cServer* server = next->server;
+		next->running = true;
+		next->nextRun = tClock::now() + runInterval;
+		lock.unlock();
+
+		currentServer = server;
+		try
+		{
+			server->runOnce();
+		}
+		catch (const std::exception& ex)
+		{
+			Log.error (std::string ("Exception in server pool: ") + ex.what());
+		}
+		currentServer = nullptr;
+
+		lock.lock();
+		// entries may have been reallocated in the meantime
+		auto it = std::ranges::find_if (entries, [&] (const sEntry& entry) { return entry.server == server; });
+		if (it != entries.end())
+			it->running = false;
+		changed.notify_all();
+	}
+}
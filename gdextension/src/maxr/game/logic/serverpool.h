@@ -0,0 +1,80 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_logic_serverpoolH
+#define game_logic_serverpoolH
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class cServer;
+
+/**
+ * Runs any number of servers on a fixed number of worker threads,
+ * instead of one thread per server.
+ * Every server is run by at most one worker at a time,
+ * and at most once per run interval.
+ */
+class cServerPool
+{
+public:
+	explicit cServerPool (std::size_t threadCount);
+	~cServerPool();
+
+	cServerPool (const cServerPool&) = delete;
+	cServerPool& operator= (const cServerPool&) = delete;
+
+	void add (cServer&);
+	/**
+	 * Removes the server from the pool.
+	 * Returns, after no worker runs the server anymore.
+	 * So it must not be called from the worker, that runs this server.
+	 */
+	void remove (cServer&);
+
+	/** Returns true, if the current thread is the worker, that runs the server */
+	static bool isRunningOnCurrentThread (const cServer&);
+
+	std::size_t getThreadCount() const { return threads.size(); }
+
+private:
+	using tClock = std::chrono::steady_clock;
+
+	struct sEntry
+	{
+		cServer* server = nullptr;
+		tClock::time_point nextRun;
+		bool running = false;
+	};
+
+	void work();
+
+private:
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::vector<sEntry> entries;
+	bool exit = false;
+	std::vector<std::thread> threads;
+};
+
+#endif // game_logic_serverpoolH
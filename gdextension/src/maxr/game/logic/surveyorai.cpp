@@ -28,7 +28,7 @@
 
 #include <algorithm>
 #include <cmath>
-#include <forward_list>
+#include <functional>
 
 static const float FIELD_BLOCKED = -10000.f;
 static const int ACTION_TIMEOUT = 50;
@@ -80,9 +80,9 @@ void cSurveyorAi::run (cClient& client, const std::vector<std::unique_ptr<cSurve
 	if (vehicle.getMoveJob() == nullptr)
 	{
 		changeOP();
-		std::forward_list<cPosition> path;
+		cPath path;
 		//push the starting point for planing
-		path.push_front (vehicle.getPosition());
+		path.push_back (vehicle.getPosition());
 
 		int movePoints = vehicle.data.getSpeed();
 		if (movePoints < vehicle.data.getSpeedMax())
@@ -91,8 +91,6 @@ void cSurveyorAi::run (cClient& client, const std::vector<std::unique_ptr<cSurve
 		}
 		planMove (path, movePoints, jobs, map);
 
-		// planMove gives the path with the last way point at the front. So reverse it.
-		path.reverse();
 		//remove the starting point of the path, as this position is not required in a movejob path
 		path.pop_front();
 
@@ -122,9 +120,9 @@ void cSurveyorAi::run (cClient& client, const std::vector<std::unique_ptr<cSurve
 }
 
 //------------------------------------------------------------------------------
-void cSurveyorAi::planMove (std::forward_list<cPosition>& path, int remainingMovePoints, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap& map) const
+void cSurveyorAi::planMove (cPath& path, int remainingMovePoints, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap& map) const
 {
-	cPosition position = path.front();
+	cPosition position = path.back();
 
 	cPosition bestNextPosition;
 	float bestNextFactor = FIELD_BLOCKED;
@@ -147,7 +145,7 @@ void cSurveyorAi::planMove (std::forward_list<cPosition>& path, int remainingMov
 
 	if (bestNextFactor > FIELD_BLOCKED)
 	{
-		path.push_front (bestNextPosition);
+		path.push_back (bestNextPosition);
 		planMove (path, remainingMovePoints - bestNextMoveCosts, jobs, map);
 	}
 }
@@ -170,7 +168,7 @@ float cSurveyorAi::calcScoreDistToOtherSurveyor (const std::vector<std::unique_p
 
 //------------------------------------------------------------------------------
 // calculates an "importance-factor" for a given field
-float cSurveyorAi::calcFactor (const cPosition& position, const std::forward_list<cPosition>& path, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap& map) const
+float cSurveyorAi::calcFactor (const cPosition& position, const cPath& path, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap& map) const
 {
 	if (!map.possiblePlace (vehicle, position, true)) return FIELD_BLOCKED;
 
@@ -227,67 +225,186 @@ void cSurveyorAi::planLongMove (const std::vector<std::unique_ptr<cSurveyorAi>>&
 	const cMap& map = *model.getMap();
 	const cPlayer& player = *vehicle.getOwner();
 
-	cPosition bestPosition;
-	float minValue = 0;
+	//use owners mapview to calc path
+	const auto& playerList = model.getPlayerList();
+	auto iter = std::ranges::find_if (playerList, [&] (const std::shared_ptr<cPlayer>& p) {
+		return p->getId() == player.getId();
+	});
+	const cMapView mapView (model.getMap(), *iter);
 
-	for (int x = 0; x < map.getSize().x(); ++x)
+	if (!distanceField.valid || distanceField.origin != vehicle.getPosition() || distanceField.resourceMapVersion != player.getResourceMapVersion() || distanceField.mapWidth != map.getSize().x())
 	{
-		for (int y = 0; y < map.getSize().y(); ++y)
+		resetDistanceField (map, player);
+	}
+
+	int bestOffset = -1;
+	float minValue = 0;
+	const auto evaluate = [&] (int offset) {
+		const cPosition currentPosition (offset % distanceField.mapWidth, offset / distanceField.mapWidth);
+
+		// if field is not passable/walkable or
+		// if it's already has been explored, ignore it
+		if (player.hasResourceExplored (currentPosition)) return;
+		if (!map.possiblePlace (vehicle, currentPosition, false)) return;
+
+		// calculate the distance to other surveyors
+		const float distancesSurv = calcScoreDistToOtherSurveyor (jobs, currentPosition, EXP2);
+		const float distanceOP = static_cast<float> ((currentPosition - operationPoint).l2Norm());
+		// path length in fields of plain terrain
+		const float distanceSurv = distanceField.costs[offset] / 4.f;
+		const float factor = D * distanceOP + E * distanceSurv + F * distancesSurv;
+
+		if (bestOffset < 0 || factor < minValue)
 		{
-			const cPosition currentPosition (x, y);
-
-			// if field is not passable/walkable or
-			// if it's already has been explored, continue
-			if (!map.possiblePlace (vehicle, currentPosition, false)) continue;
-			if (player.hasResourceExplored (currentPosition)) continue;
-
-			// calculate the distance to other surveyors
-			const float distancesSurv = calcScoreDistToOtherSurveyor (jobs, currentPosition, EXP2);
-			const float distanceOP = static_cast<float> ((currentPosition - operationPoint).l2Norm());
-			const float distanceSurv = static_cast<float> ((currentPosition - vehicle.getPosition()).l2Norm());
-			// TODO: take into account the length of the path to
-			// the coordinates too
-			// (I seen a case, when a surveyor took 7 additional senseless steps
-			//  just to avoid or by-pass an impassable rocky terrain)
-			const float factor = D * distanceOP + E * distanceSurv + F * distancesSurv;
-
-			if ((factor < minValue) || (minValue == 0))
-			{
-				minValue = factor;
-				bestPosition = currentPosition;
-			}
-			// TODO: check, if a path can be found to the coordinates
+			minValue = factor;
+			bestOffset = offset;
 		}
+	};
+
+	// the other surveyors have moved since the last call, so rate the known fields again
+	for (const int offset : distanceField.settled)
+	{
+		evaluate (offset);
 	}
-	if (minValue == 0)
+	// all terms of the factor are positive,
+	// so no field further away than E * path length can be better
+	while (!distanceField.open.empty())
+	{
+		if (bestOffset >= 0 && E * distanceField.open.front().first / 4.f >= minValue) break;
+
+		const int offset = settleNextField (mapView);
+		if (offset >= 0) evaluate (offset);
+	}
+
+	if (bestOffset < 0)
 	{
 		client.surveyorAiConfused (vehicle);
 		client.setAutoMove (vehicle, false);
 		finished = true;
+		return;
+	}
+
+	const auto path = getPathFromDistanceField (bestOffset);
+	if (!path.empty())
+	{
+		client.startMove (vehicle, path, eStart::Immediate, eStopOn::DetectResource, cEndMoveAction::None());
+		counter = ACTION_TIMEOUT;
 	}
 	else
 	{
-		//use owners mapview to calc path
-		const auto& playerList = model.getPlayerList();
-		auto iter = std::ranges::find_if (playerList, [&] (const std::shared_ptr<cPlayer>& p) {
-			return p->getId() == player.getId();
+		client.surveyorAiConfused (vehicle);
+		client.setAutoMove (vehicle, false);
+		finished = true;
+	}
+}
+
+//------------------------------------------------------------------------------
+void cSurveyorAi::resetDistanceField (const cMap& map, const cPlayer& player)
+{
+	const auto size = map.getSize();
+	const int origin = map.getOffset (vehicle.getPosition());
+
+	distanceField.valid = true;
+	distanceField.origin = vehicle.getPosition();
+	distanceField.mapWidth = size.x();
+	distanceField.resourceMapVersion = player.getResourceMapVersion();
+	distanceField.costs.assign (size.x() * size.y(), -1);
+	distanceField.previous.assign (size.x() * size.y(), -1);
+	distanceField.closed.assign (size.x() * size.y(), false);
+	distanceField.passable.assign (size.x() * size.y(), -1);
+	distanceField.open.clear();
+	distanceField.settled.clear();
+
+	distanceField.costs[origin] = 0;
+	distanceField.open.emplace_back (0, origin);
+
+	if (observedMap != &map)
+	{
+		observedMap = &map;
+		mapConnectionManager.disconnectAll();
+		mapConnectionManager.connect (map.addedUnit, [this] (const cUnit& unit) { invalidateDistanceField (unit, unit.getPosition()); });
+		mapConnectionManager.connect (map.removedUnit, [this] (const cUnit& unit) { invalidateDistanceField (unit, unit.getPosition()); });
+		mapConnectionManager.connect (map.movedVehicle, [this] (const cVehicle& vehicle, const cPosition& oldPosition) {
+			invalidateDistanceField (vehicle, oldPosition);
+			invalidateDistanceField (vehicle, vehicle.getPosition());
 		});
-		const cMapView mapView (model.getMap(), *iter);
+	}
+}
 
-		cPathCalculator pc (vehicle, mapView, bestPosition, false);
-		const auto path = pc.calcPath();
-		if (!path.empty())
+//------------------------------------------------------------------------------
+// the settled costs depend on the passability of the checked fields,
+// so the search has to start again, when one of them may have changed
+void cSurveyorAi::invalidateDistanceField (const cUnit& unit, const cPosition& position)
+{
+	if (!distanceField.valid) return;
+
+	const int unitSize = unit.getIsBig() ? 2 : 1;
+	const int mapHeight = static_cast<int> (distanceField.passable.size()) / distanceField.mapWidth;
+	for (int y = position.y(); y < std::min (position.y() + unitSize, mapHeight); ++y)
+	{
+		for (int x = position.x(); x < std::min (position.x() + unitSize, distanceField.mapWidth); ++x)
 		{
-			client.startMove (vehicle, path, eStart::Immediate, eStopOn::DetectResource, cEndMoveAction::None());
-			counter = ACTION_TIMEOUT;
+			if (distanceField.passable[y * distanceField.mapWidth + x] >= 0)
+			{
+				distanceField.valid = false;
+				return;
+			}
 		}
-		else
+	}
+}
+
+//------------------------------------------------------------------------------
+// closes the cheapest open field and returns its offset.
+// Returns -1, when the popped heap entry was outdated.
+int cSurveyorAi::settleNextField (const cMapView& mapView)
+{
+	const auto greater = std::greater<std::pair<int, int>>();
+	auto& open = distanceField.open;
+
+	std::ranges::pop_heap (open, greater);
+	const auto [costs, offset] = open.back();
+	open.pop_back();
+	if (distanceField.closed[offset] || costs != distanceField.costs[offset]) return -1;
+
+	distanceField.closed[offset] = true;
+	distanceField.settled.push_back (offset);
+
+	const cPosition position (offset % distanceField.mapWidth, offset / distanceField.mapWidth);
+	const cPosition size = mapView.getSize();
+	for (int y = std::max (position.y() - 1, 0); y <= std::min (position.y() + 1, size.y() - 1); ++y)
+	{
+		for (int x = std::max (position.x() - 1, 0); x <= std::min (position.x() + 1, size.x() - 1); ++x)
 		{
-			client.surveyorAiConfused (vehicle);
-			client.setAutoMove (vehicle, false);
-			finished = true;
+			const cPosition nextPosition (x, y);
+			const int nextOffset = mapView.getOffset (nextPosition);
+			if (distanceField.closed[nextOffset]) continue;
+			auto& passable = distanceField.passable[nextOffset];
+			if (passable < 0) passable = mapView.possiblePlace (vehicle, nextPosition) ? 1 : 0;
+			if (!passable) continue;
+
+			const int nextCosts = costs + cPathCalculator::calcNextCost (position, nextPosition, &vehicle, &mapView);
+			if (distanceField.costs[nextOffset] >= 0 && distanceField.costs[nextOffset] <= nextCosts) continue;
+
+			distanceField.costs[nextOffset] = nextCosts;
+			distanceField.previous[nextOffset] = offset;
+			open.emplace_back (nextCosts, nextOffset);
+			std::ranges::push_heap (open, greater);
 		}
 	}
+	return offset;
+}
+
+//------------------------------------------------------------------------------
+cPath cSurveyorAi::getPathFromDistanceField (int offset) const
+{
+	// the origin is not part of the path
+	cPath path;
+	for (; distanceField.previous[offset] >= 0; offset = distanceField.previous[offset])
+	{
+		path.push_back (cPosition (offset % distanceField.mapWidth, offset / distanceField.mapWidth));
+	}
+	path.reverse();
+	return path;
 }
 
 //------------------------------------------------------------------------------
@@ -306,7 +423,7 @@ void cSurveyorAi::changeOP()
 }
 
 //------------------------------------------------------------------------------
-bool cSurveyorAi::positionHasBeenSurveyedByPath (const cPosition& position, const std::forward_list<cPosition>& path) const
+bool cSurveyorAi::positionHasBeenSurveyedByPath (const cPosition& position, const cPath& path) const
 {
 	return std::ranges::any_of (path, [&] (const auto& pathPos) { return (pathPos - position).l2NormSquared() <= 2; });
 }
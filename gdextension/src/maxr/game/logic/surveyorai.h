@@ -20,13 +20,18 @@
 #ifndef game_logic_surveyoraiH
 #define game_logic_surveyoraiH
 
+#include "utility/path.h"
 #include "utility/position.h"
 #include "utility/signal/signalconnectionmanager.h"
 
-#include <forward_list>
 #include <memory>
+#include <utility>
+#include <vector>
 
 class cMap;
+class cMapView;
+class cPlayer;
+class cUnit;
 class cVehicle;
 class cClient;
 
@@ -40,17 +45,22 @@ public:
 	const cVehicle& getVehicle() { return vehicle; }
 
 private:
-	void planMove (std::forward_list<cPosition>& path, int remainingMovePoints, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap&) const;
+	void planMove (cPath& path, int remainingMovePoints, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap&) const;
 	void planLongMove (const std::vector<std::unique_ptr<cSurveyorAi>>&, cClient&);
 
-	float calcFactor (const cPosition&, const std::forward_list<cPosition>& path, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap&) const;
+	float calcFactor (const cPosition&, const cPath& path, const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cMap&) const;
 	float calcScoreDistToOtherSurveyor (const std::vector<std::unique_ptr<cSurveyorAi>>& jobs, const cPosition&, float e) const;
 
-	bool positionHasBeenSurveyedByPath (const cPosition&, const std::forward_list<cPosition>& path) const;
+	bool positionHasBeenSurveyedByPath (const cPosition&, const cPath& path) const;
 	bool hasAdjacentResources (const cPosition&, const cMap&) const;
 
 	void changeOP();
 
+	void resetDistanceField (const cMap&, const cPlayer&);
+	void invalidateDistanceField (const cUnit&, const cPosition&);
+	int settleNextField (const cMapView&);
+	cPath getPathFromDistanceField (int offset) const;
+
 private:
 	const cVehicle& vehicle; // the vehicle the auto move job belongs to
 	bool finished = false; // true when the job can be deleted
@@ -60,7 +70,28 @@ private:
 	// the surveyor tries to stay near this coordinates
 	cPosition operationPoint;
 
+	// Dijkstra search over the movement costs of the vehicle, starting at its position.
+	// It is expanded lazily by planLongMove and reused, until the vehicle moves,
+	// the player explores new resources or a unit appears on, leaves or moves over
+	// a field, which passability was already checked.
+	struct sDistanceField
+	{
+		bool valid = false;
+		cPosition origin;
+		int mapWidth = 0;
+		unsigned int resourceMapVersion = 0;
+		std::vector<int> costs; // -1 when not reached yet
+		std::vector<int> previous; // offset of the previous field on the cheapest path
+		std::vector<bool> closed;
+		std::vector<signed char> passable; // -1 when not checked yet
+		std::vector<std::pair<int, int>> open; // heap of (costs, offset)
+		std::vector<int> settled; // offsets of the closed fields, by increasing costs
+	};
+	sDistanceField distanceField;
+	const cMap* observedMap = nullptr;
+
 	cSignalConnectionManager connectionManager;
+	cSignalConnectionManager mapConnectionManager;
 };
 
 #endif // game_logic_surveyoraiH
@@ -0,0 +1,146 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "game/logic/unitchangejournal.h"
+
+#include "game/data/map/map.h"
+#include "game/data/model.h"
+#include "game/data/player/player.h"
+#include "game/data/units/building.h"
+#include "game/data/units/vehicle.h"
+
+//------------------------------------------------------------------------------
+cUnitChangeJournal::~cUnitChangeJournal()
+{
+	detach();
+}
+
+//------------------------------------------------------------------------------
+void cUnitChangeJournal::attach (const cModel& model)
+{
+	detach();
+
+	// drain() may be called concurrently from the reader thread
+	std::lock_guard<std::mutex> lock (mutex);
+	const auto& map = *model.getMap();
+	mapConnections.connect (map.addedUnit, [this] (const cUnit& unit) {
+		std::lock_guard<std::mutex> lock (mutex);
+		connectUnit (unit);
+		addEntry (unit, Added);
+	});
+	mapConnections.connect (map.removedUnit, [this] (const cUnit& unit) {
+		std::lock_guard<std::mutex> lock (mutex);
+		unitConnections.erase (unit.getId());
+		addEntry (unit, Removed);
+	});
+	mapConnections.connect (map.movedVehicle, [this] (const cVehicle& vehicle, const cPosition&) {
+		record (vehicle, Moved);
+	});
+
+	for (const auto& player : model.getPlayerList())
+	{
+		for (const auto& building : player->getBuildings())
+		{
+			connectUnit (*building);
+			addEntry (*building, Added);
+		}
+		for (const auto& vehicle : player->getVehicles())
+		{
+			if (vehicle->isUnitLoaded()) continue;
+			connectUnit (*vehicle);
+			addEntry (*vehicle, Added);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void cUnitChangeJournal::detach()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	mapConnections.disconnectAll();
+	unitConnections.clear();
+	entries.clear();
+	entryIndex.clear();
+}
+
+//------------------------------------------------------------------------------
+std::vector<cUnitChangeJournal::sEntry> cUnitChangeJournal::drain()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	std::vector<sEntry> result;
+	result.swap (entries);
+	entryIndex.clear();
+	return result;
+}
+
+//------------------------------------------------------------------------------
+void cUnitChangeJournal::connectUnit (const cUnit& unit)
+{
+	auto& connections = unitConnections[unit.getId()];
+	connections.disconnectAll();
+
+	connections.connect (unit.statusChanged, [this, &unit]() { record (unit, StateChanged); });
+	connections.connect (unit.ownerChanged, [this, &unit]() { record (unit, StateChanged); });
+	connections.connect (unit.storedUnitsChanged, [this, &unit]() { record (unit, StateChanged); });
+	connections.connect (unit.data.hitpointsMaxChanged, [this, &unit]() { record (unit, StateChanged); });
+	connections.connect (unit.data.hitpointsChanged, [this, &unit]() { record (unit, Damaged); });
+	if (unit.isAVehicle())
+	{
+		const auto& vehicle = static_cast<const cVehicle&> (unit);
+		connections.connect (vehicle.flightHeightChanged, [this, &unit]() { record (unit, StateChanged); });
+	}
+}
+
+//------------------------------------------------------------------------------
+void cUnitChangeJournal::record (const cUnit& unit, int changes)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	addEntry (unit, changes);
+}
+
+//------------------------------------------------------------------------------
+void cUnitChangeJournal::addEntry (const cUnit& unit, int changes)
+{
+	const auto it = entryIndex.find (unit.getId());
+	if (it == entryIndex.end())
+	{
+		entryIndex.emplace (unit.getId(), entries.size());
+		entries.emplace_back();
+		entries.back().unitId = unit.getId();
+	}
+	else if ((changes & Removed) && (entries[it->second].changes & Added) && !(entries[it->second].changes & Removed))
+	{
+		// added and removed again, before anybody noticed
+		const size_t index = it->second;
+		entryIndex.erase (it);
+		if (index != entries.size() - 1)
+		{
+			entries[index] = std::move (entries.back());
+			entryIndex[entries[index].unitId] = index;
+		}
+		entries.pop_back();
+		return;
+	}
+	auto& entry = entries[entryIndex[unit.getId()]];
+	entry.changes |= changes;
+	entry.playerId = unit.getOwner() ? unit.getOwner()->getId() : -1;
+	entry.position = unit.getPosition();
+	entry.hitpoints = unit.data.getHitpoints();
+	entry.isBuilding = unit.isABuilding();
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef game_logic_unitchangejournalH
+#define game_logic_unitchangejournalH
+
+#include "utility/position.h"
+#include "utility/signal/signalconnectionmanager.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class cModel;
+class cUnit;
+
+/**
+ * Records which units changed since the last drain, so that a presentation
+ * layer can update incrementally instead of polling the state of every unit.
+ *
+ * Changes of the same unit are merged into one entry. A unit that was added
+ * and removed again between two drains is dropped from the journal.
+ * Recording is thread safe: the model may run on another thread than the
+ * one draining the journal.
+ */
+class cUnitChangeJournal
+{
+public:
+	enum eChange
+	{
+		Added = 1 << 0,
+		Removed = 1 << 1,
+		Moved = 1 << 2,
+		Damaged = 1 << 3,
+		StateChanged = 1 << 4
+	};
+
+	struct sEntry
+	{
+		unsigned int unitId = 0;
+		int changes = 0; // combination of eChange
+		int playerId = -1; // -1 for neutral units
+		cPosition position;
+		int hitpoints = 0;
+		bool isBuilding = false;
+	};
+
+	cUnitChangeJournal() = default;
+	~cUnitChangeJournal();
+	cUnitChangeJournal (const cUnitChangeJournal&) = delete;
+	cUnitChangeJournal& operator= (const cUnitChangeJournal&) = delete;
+
+	/**
+	 * Starts recording the changes of the given model.
+	 * All units currently on the map are recorded as added.
+	 * attach() and detach() connect to the model's signals, so the model must
+	 * not run meanwhile. In host mode lock the server's model mutex.
+	 */
+	void attach (const cModel&);
+	void detach();
+
+	/** returns all recorded entries and clears the journal */
+	std::vector<sEntry> drain();
+
+private:
+	/** connectUnit() and addEntry() require the mutex to be locked */
+	void connectUnit (const cUnit&);
+	void record (const cUnit&, int changes);
+	void addEntry (const cUnit&, int changes);
+
+private:
+	// guards all members, because the signals are triggered on the model thread,
+	// while drain() is called by the reader thread
+	std::mutex mutex;
+	cSignalConnectionManager mapConnections;
+	std::unordered_map<unsigned int, cSignalConnectionManager> unitConnections;
+	std::vector<sEntry> entries;
+	std::unordered_map<unsigned int, size_t> entryIndex;
+};
+
+#endif // game_logic_unitchangejournalH
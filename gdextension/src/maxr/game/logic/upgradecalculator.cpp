@@ -28,7 +28,7 @@
 #include <sstream>
 
 //------------------------------------------------------------------------------
-cUpgradeCalculator& cUpgradeCalculator::instance()
+const cUpgradeCalculator& cUpgradeCalculator::instance()
 {
 	static cUpgradeCalculator _instance;
 	return _instance;
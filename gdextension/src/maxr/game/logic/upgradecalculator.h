@@ -61,7 +61,7 @@ class cStaticUnitData;
 class cUpgradeCalculator
 {
 public:
-	static cUpgradeCalculator& instance();
+	static const cUpgradeCalculator& instance();
 
 	enum class eUpgradeType
 	{
@@ -338,7 +338,7 @@ private:
 	{
 		auto unitDataNonConst = std::make_shared<cUnitsData>();
 		archive >> serialization::makeNvp ("unitsData", *unitDataNonConst);
-		unitsData = unitDataNonConst;
+		unitsData = cUnitsDataCache::share (std::move (unitDataNonConst));
 
 		auto clanDataNonConst = std::make_shared<cClanData>();
 		archive >> serialization::makeNvp ("clanData", *clanDataNonConst);
@@ -49,7 +49,9 @@ namespace serialization
 				{eNetMessageType::REQUEST_RESYNC_MODEL, "REQUEST_RESYNC_MODEL"},
 				{eNetMessageType::MULTIPLAYER_LOBBY, "MULTIPLAYER_LOBBY"},
 				{eNetMessageType::GAME_ALREADY_RUNNING, "GAME_ALREADY_RUNNING"},
-				{eNetMessageType::WANT_REJOIN_GAME, "WANT_REJOIN_GAME"}};
+				{eNetMessageType::WANT_REJOIN_GAME, "WANT_REJOIN_GAME"},
+				{eNetMessageType::DESYNC_CHECKSUMS, "DESYNC_CHECKSUMS"},
+				{eNetMessageType::DESYNC_REPORT, "DESYNC_REPORT"}};
 
 } // namespace serialization
 //------------------------------------------------------------------------------
@@ -117,6 +119,12 @@ std::unique_ptr<cNetMessage> cNetMessage::createFromBuffer (const unsigned char*
 		case eNetMessageType::WANT_REJOIN_GAME:
 			message = std::make_unique<cNetMessageWantRejoinGame> (archive);
 			break;
+		case eNetMessageType::DESYNC_CHECKSUMS:
+			message = std::make_unique<cNetMessageDesyncChecksums> (archive);
+			break;
+		case eNetMessageType::DESYNC_REPORT:
+			message = std::make_unique<cNetMessageDesyncReport> (archive);
+			break;
 		default:
 			throw std::runtime_error ("Unknown net message type " + std::to_string (static_cast<int> (type)));
 			break;
@@ -146,13 +154,15 @@ std::unique_ptr<cNetMessage> cNetMessage::clone() const
 //------------------------------------------------------------------------------
 cNetMessageTcpHello::cNetMessageTcpHello() :
 	packageVersion (PACKAGE_VERSION),
-	packageRev (PACKAGE_REV)
+	packageRev (PACKAGE_REV),
+	checkSumAlgorithm (getCheckSumAlgorithm())
 {}
 
 //------------------------------------------------------------------------------
 cNetMessageTcpWantConnect::cNetMessageTcpWantConnect() :
 	packageVersion (PACKAGE_VERSION),
-	packageRev (PACKAGE_REV)
+	packageRev (PACKAGE_REV),
+	checkSumAlgorithm (getCheckSumAlgorithm())
 {}
 
 //------------------------------------------------------------------------------
@@ -164,16 +174,19 @@ cNetMessageTcpConnected::cNetMessageTcpConnected (int playerNr) :
 }
 
 //------------------------------------------------------------------------------
-cNetMessageResyncModel::cNetMessageResyncModel (const cModel& model)
+cNetMessageResyncModel::cNetMessageResyncModel (const cModel& model, bool includeUnitsData /*= true*/)
 {
 	cBinaryArchiveOut archive (data);
-	archive << model;
+	archive << includeUnitsData;
+	model.save (archive, includeUnitsData);
 }
 
 void cNetMessageResyncModel::apply (cModel& model) const
 {
 	cBinaryArchiveIn archive (data.data(), data.size());
-	archive >> model;
+	bool includeUnitsData = true;
+	archive >> includeUnitsData;
+	model.load (archive, includeUnitsData);
 }
 
 //------------------------------------------------------------------------------
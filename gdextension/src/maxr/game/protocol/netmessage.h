@@ -23,6 +23,8 @@
 #include "game/data/freezemode.h"
 #include "game/data/gui/playerguiinfo.h"
 #include "game/data/player/playerbasicdata.h"
+#include "game/logic/desyncdiagnosis.h"
+#include "utility/crc.h"
 #include "utility/serialization/binaryarchive.h"
 #include "utility/serialization/jsonarchive.h"
 #include "utility/serialization/nvp.h"
@@ -57,6 +59,8 @@ enum class eNetMessageType
 	REQUEST_RESYNC_MODEL, /** instructs the server to send a copy of the model */
 	GAME_ALREADY_RUNNING, /** send by server, when a new connection is established, after the game has started */
 	WANT_REJOIN_GAME, /** send by a client to reconnect a disconnected player */
+	DESYNC_CHECKSUMS, /** send by a client, that is out of sync: checksums of the parts of its model */
+	DESYNC_REPORT, /** answer of the server: the diverging parts and their state on the server */
 };
 namespace serialization
 {
@@ -129,6 +133,25 @@ public:
 	virtual bool handleMessage (const cNetMessage&) = 0;
 };
 
+//------------------------------------------------------------------------------
+/**
+* The checksum algorithm is only transmitted, when it is not the legacy one.
+* So the handshake of a peer using the legacy algorithm is the same as the one of older versions.
+*/
+template <ArchiveInOrOut Archive>
+void serializeCheckSumAlgorithm (Archive& archive, eCheckSumAlgorithm& checkSumAlgorithm)
+{
+	if constexpr (Archive::isWriter)
+	{
+		if (checkSumAlgorithm != eCheckSumAlgorithm::Legacy) archive << NVP (checkSumAlgorithm);
+	}
+	else
+	{
+		checkSumAlgorithm = eCheckSumAlgorithm::Legacy;
+		if (archive.dataLeft() > 0) archive >> NVP (checkSumAlgorithm);
+	}
+}
+
 //------------------------------------------------------------------------------
 class cNetMessageTcpHello : public cNetMessageT<eNetMessageType::TCP_HELLO>
 {
@@ -152,6 +175,7 @@ public:
 
 	std::string packageVersion;
 	std::string packageRev;
+	eCheckSumAlgorithm checkSumAlgorithm = eCheckSumAlgorithm::Legacy;
 
 private:
 	template <ArchiveInOrOut Archive>
@@ -162,6 +186,7 @@ private:
 		archive & NVP (packageVersion);
 		archive & NVP (packageRev);
 		// clang-format on
+		serializeCheckSumAlgorithm (archive, checkSumAlgorithm);
 	}
 };
 
@@ -190,6 +215,7 @@ public:
 	bool ready = false;
 	std::string packageVersion;
 	std::string packageRev;
+	eCheckSumAlgorithm checkSumAlgorithm = eCheckSumAlgorithm::Legacy;
 
 	const cSocket* socket = nullptr;
 
@@ -204,6 +230,7 @@ private:
 		archive & NVP (packageVersion);
 		archive & NVP (packageRev);
 		// clang-format on
+		serializeCheckSumAlgorithm (archive, checkSumAlgorithm);
 		// socket is not serialized
 	}
 };
@@ -573,7 +600,8 @@ private:
 class cNetMessageResyncModel : public cNetMessageT<eNetMessageType::RESYNC_MODEL>
 {
 public:
-	explicit cNetMessageResyncModel (const cModel& model);
+	/** includeUnitsData = false: the receiver has to know the units data of the model already */
+	explicit cNetMessageResyncModel (const cModel& model, bool includeUnitsData = true);
 	explicit cNetMessageResyncModel (cBinaryArchiveIn& archive)
 	{
 		serializeThis (archive);
@@ -690,4 +718,88 @@ public:
 	{}
 };
 
+//------------------------------------------------------------------------------
+class cNetMessageDesyncChecksums : public cNetMessageT<eNetMessageType::DESYNC_CHECKSUMS>
+{
+public:
+	cNetMessageDesyncChecksums (unsigned int gameTime, tChecksumList checksums) :
+		gameTime (gameTime),
+		checksums (std::move (checksums))
+	{}
+	explicit cNetMessageDesyncChecksums (cBinaryArchiveIn& archive)
+	{
+		serializeThis (archive);
+	}
+
+	void serialize (cBinaryArchiveOut& archive) override
+	{
+		cNetMessage::serialize (archive);
+		serializeThis (archive);
+	}
+	void serialize (cJsonArchiveOut& archive) override
+	{
+		cNetMessage::serialize (archive);
+		serializeThis (archive);
+	}
+
+	unsigned int gameTime = 0; // the first game time, at which the client checksum differed
+	tChecksumList checksums; // see cModel::getChecksumParts()
+
+private:
+	template <ArchiveInOrOut Archive>
+	void serializeThis (Archive& archive)
+	{
+		// clang-format off
+		// See https://github.com/llvm/llvm-project/issues/44312
+		archive & NVP (gameTime);
+		archive & NVP (checksums);
+		// clang-format on
+	}
+};
+
+//------------------------------------------------------------------------------
+class cNetMessageDesyncReport : public cNetMessageT<eNetMessageType::DESYNC_REPORT>
+{
+public:
+	cNetMessageDesyncReport (unsigned int gameTime, bool diagnosed, std::vector<std::string> divergingParts, std::string serverState) :
+		gameTime (gameTime),
+		diagnosed (diagnosed),
+		divergingParts (std::move (divergingParts)),
+		serverState (std::move (serverState))
+	{}
+	explicit cNetMessageDesyncReport (cBinaryArchiveIn& archive)
+	{
+		serializeThis (archive);
+	}
+
+	void serialize (cBinaryArchiveOut& archive) override
+	{
+		cNetMessage::serialize (archive);
+		serializeThis (archive);
+	}
+	void serialize (cJsonArchiveOut& archive) override
+	{
+		cNetMessage::serialize (archive);
+		serializeThis (archive);
+	}
+
+	unsigned int gameTime = 0;
+	bool diagnosed = false; // false, when the server has no state for the game time anymore
+	std::vector<std::string> divergingParts;
+	std::string serverState; // JSON object with the state of the diverging parts on the server
+
+private:
+	template <ArchiveInOrOut Archive>
+	void serializeThis (Archive& archive)
+	{
+		// clang-format off
+		// See https://github.com/llvm/llvm-project/issues/44312
+		archive & NVP (gameTime);
+		archive & NVP (diagnosed);
+		archive & NVP (divergingParts);
+		archive & NVP (serverState);
+		// clang-format on
+	}
+};
+
 #endif
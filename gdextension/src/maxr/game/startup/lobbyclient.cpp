@@ -26,6 +26,7 @@
 #include "game/startup/lobbyutils.h"
 #include "mapdownloader/mapdownloadmessagehandler.h"
 #include "maxrversion.h"
+#include "utility/crc.h"
 #include "utility/log.h"
 
 //------------------------------------------------------------------------------
@@ -350,6 +351,12 @@ void cLobbyClient::handleNetMessage_TCP_HELLO (const cNetMessageTcpHello& messag
 		onDifferentVersion (message.packageVersion, message.packageRev);
 		if (message.packageVersion != PACKAGE_VERSION) return;
 	}
+	if (message.checkSumAlgorithm != getCheckSumAlgorithm())
+	{
+		Log.warn ("The server uses a different checksum algorithm");
+		onConnectionFailed (eDeclineConnectionReason::DifferentCheckSumAlgorithm);
+		return;
+	}
 
 	cNetMessageTcpWantConnect response;
 	response.player = {localPlayer.getName(), localPlayer.getColor()};
@@ -444,14 +451,16 @@ void cLobbyClient::handleNetMessage_MU_MSG_OPTIONS (const cMuMsgOptions& message
 	{
 		if (!lobbyPreparationData.staticMap || lobbyPreparationData.staticMap->getFilename() != message.mapFilename)
 		{
-			bool mapCheckSumsEqual = (MapDownload::calculateCheckSum (message.mapFilename) == message.mapCrc);
-			auto newStaticMap = std::make_shared<cStaticMap>();
-			if (mapCheckSumsEqual && newStaticMap->loadMap (message.mapFilename))
+			auto newStaticMap = cStaticMapCache::get (message.mapFilename);
+			const bool mapCheckSumsEqual = newStaticMap && newStaticMap->getFileCrc() == message.mapCrc;
+			if (mapCheckSumsEqual)
 			{
 				triedLoadMapFilename.clear();
 			}
 			else
 			{
+				// don't use a map, which differs from the host's one
+				newStaticMap = std::make_shared<cStaticMap>();
 				if (localPlayer.isReady())
 				{
 					onNoMapNoReady (message.mapFilename);
@@ -547,16 +556,16 @@ void cLobbyClient::handleNetMessage_MU_MSG_START_GAME (const cMuMsgStartGame&)
 //------------------------------------------------------------------------------
 void cLobbyClient::handleNetMessage_GAME_ALREADY_RUNNING (const cNetMessageGameAlreadyRunning& message)
 {
-	lobbyPreparationData.staticMap = std::make_shared<cStaticMap>();
+	lobbyPreparationData.staticMap = cStaticMapCache::get (message.mapFilename);
 	players = message.playerList;
 
-	if (!lobbyPreparationData.staticMap->loadMap (message.mapFilename))
+	if (!lobbyPreparationData.staticMap)
 	{
 		onFailToReconnectGameNoMap (message.mapFilename);
 		disconnect();
 		return;
 	}
-	else if (MapDownload::calculateCheckSum (message.mapFilename) != message.mapCrc)
+	else if (lobbyPreparationData.staticMap->getFileCrc() != message.mapCrc)
 	{
 		onFailToReconnectGameInvalidMap (message.mapFilename);
 		disconnect();
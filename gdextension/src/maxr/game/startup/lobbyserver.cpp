@@ -32,8 +32,9 @@
 #include <cassert>
 
 //------------------------------------------------------------------------------
-cLobbyServer::cLobbyServer (std::shared_ptr<cConnectionManager> connectionManager) :
-	connectionManager (connectionManager)
+cLobbyServer::cLobbyServer (std::shared_ptr<cConnectionManager> connectionManager, std::shared_ptr<const sEngineContext> context) :
+	connectionManager (connectionManager),
+	context (std::move (context))
 {
 	connectionManager->setLocalServer (this);
 
@@ -180,7 +181,10 @@ void cLobbyServer::sendSaveSlots (int playerNr)
 {
 	cMuMsgSaveSlots message;
 
-	fillSaveGames (0, 100, message.saveGames);
+	if (context)
+		cSavegame (context->savesPath).fillSaveGames (0, 100, message.saveGames);
+	else
+		fillSaveGames (0, 100, message.saveGames);
 	sendNetMessage (message, playerNr);
 }
 
@@ -193,7 +197,7 @@ void cLobbyServer::sendGameData (int playerNr /* = -1 */)
 	if (staticMap)
 	{
 		message.mapFilename = staticMap->getFilename();
-		message.mapCrc = MapDownload::calculateCheckSum (staticMap->getFilename());
+		message.mapCrc = staticMap->getFileCrc();
 	}
 	if (gameSettings)
 	{
@@ -208,14 +212,13 @@ void cLobbyServer::selectSaveGameInfo (cSaveGameInfo gameInfo)
 	saveGameInfo = gameInfo;
 	if (saveGameInfo.number >= 0)
 	{
-		staticMap = std::make_shared<cStaticMap>();
-		if (!staticMap->loadMap (saveGameInfo.mapFilename))
+		staticMap = cStaticMapCache::get (saveGameInfo.mapFilename);
+		if (!staticMap)
 		{
-			staticMap = nullptr;
 			//"Map \"" + saveGameInfo_.mapFilename + "\" not found";
 			return;
 		}
-		else if (MapDownload::calculateCheckSum (saveGameInfo.mapFilename) != saveGameInfo.mapCrc)
+		else if (staticMap->getFileCrc() != saveGameInfo.mapCrc)
 		{
 			staticMap = nullptr;
 			//"The map \"" + saveGameInfo_.mapFilename + "\" does not match the map the game was started with"
@@ -409,8 +412,7 @@ void cLobbyServer::changeOptions (const cMuMsgOptions& message)
 	}
 	else
 	{
-		if (!staticMap) { staticMap = std::make_shared<cStaticMap>(); }
-		staticMap->loadMap (message.mapFilename);
+		staticMap = cStaticMapCache::get (message.mapFilename);
 	}
 	gameSettings = message.settings ? std::make_shared<cGameSettings> (*message.settings) : nullptr;
 	selectSaveGameInfo (message.saveInfo);
@@ -487,7 +489,8 @@ void cLobbyServer::handleAskToFinishLobby (const cMuMsgAskToFinishLobby& message
 
 		sendNetMessage (cMuMsgStartGame());
 
-		server = std::make_unique<cServer> (connectionManager);
+		if (!context) context = sEngineContext::fromSettings();
+		server = std::make_unique<cServer> (connectionManager, context);
 
 		try
 		{
@@ -516,12 +519,10 @@ void cLobbyServer::handleAskToFinishLobby (const cMuMsgAskToFinishLobby& message
 
 	signalConnectionManager.connect (landingPositionManager->allPositionsValid, [this]() {
 		sendNetMessage (cMuMsgStartGame());
-		auto unitsData = std::make_shared<const cUnitsData> (UnitsDataGlobal);
-		auto clanData = std::make_shared<const cClanData> (ClanDataGlobal);
 
-		server = std::make_unique<cServer> (connectionManager);
+		server = std::make_unique<cServer> (connectionManager, context);
 
-		server->setPreparationData ({unitsData, clanData, gameSettings, staticMap});
+		server->setPreparationData ({context->unitsData, context->clanData, gameSettings, staticMap});
 		server->setPlayers (players);
 
 		connectionManager->setLocalServer (server.get());
@@ -530,9 +531,8 @@ void cLobbyServer::handleAskToFinishLobby (const cMuMsgAskToFinishLobby& message
 
 		onStartNewGame (*server);
 	});
-	auto unitsData = std::make_shared<const cUnitsData> (UnitsDataGlobal);
-	auto clanData = std::make_shared<const cClanData> (ClanDataGlobal);
-	sendNetMessage (cMuMsgStartGamePreparations (unitsData, clanData));
+	if (!context) context = sEngineContext::fromSettings();
+	sendNetMessage (cMuMsgStartGamePreparations (context->unitsData, context->clanData));
 }
 
 //------------------------------------------------------------------------------
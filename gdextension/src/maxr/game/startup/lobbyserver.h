@@ -22,6 +22,7 @@
 
 #include "game/connectionmanager.h"
 #include "game/data/map/map.h"
+#include "game/enginecontext.h"
 #include "game/logic/landingpositionmanager.h"
 #include "game/logic/server.h"
 #include "game/protocol/lobbymessage.h"
@@ -46,7 +47,11 @@ enum class eOpenServerResult
 class cLobbyServer : public INetMessageReceiver
 {
 public:
-	explicit cLobbyServer (std::shared_ptr<cConnectionManager>);
+	/**
+	 * Without a context, a context is created from the settings,
+	 * when the game preparation starts.
+	 */
+	explicit cLobbyServer (std::shared_ptr<cConnectionManager>, std::shared_ptr<const sEngineContext> = nullptr);
 
 	void addLobbyMessageHandler (std::unique_ptr<ILobbyMessageHandler>);
 
@@ -130,6 +135,7 @@ private:
 	std::shared_ptr<cLandingPositionManager> landingPositionManager;
 	std::set<int> landedPlayers;
 
+	std::shared_ptr<const sEngineContext> context;
 	std::unique_ptr<cServer> server;
 };
 
@@ -27,6 +27,7 @@
 #include "settings.h"
 #include "utility/crc.h"
 #include "utility/log.h"
+#include "utility/mappedfile.h"
 #include "utility/narrow_cast.h"
 #include "utility/string/tolower.h"
 #include "utility/string/utf-8.h"
@@ -101,39 +102,37 @@ std::filesystem::path MapDownload::getExistingMapFilePath (const std::filesystem
 	return "";
 }
 
+//------------------------------------------------------------------------------
+uint32_t MapDownload::calculateCheckSum (std::span<const unsigned char> mapFileContent)
+{
+	const std::size_t headerSize = 9;
+	if (mapFileContent.size() < headerSize) return 0;
+
+	// The header bytes are read as (signed) char, like the original
+	// ifstream based implementation did,
+	// so that checksums of already known maps and save games stay valid.
+	const auto byteAt = [&] (std::size_t i) { return static_cast<int> (static_cast<signed char> (mapFileContent[i])); };
+	const int width = byteAt (5) + byteAt (6) * 256;
+	const int height = byteAt (7) + byteAt (8) * 256;
+	// the information after this is only for graphic stuff
+	// and not necessary for comparing two maps
+	const long long relevantMapDataSize = static_cast<long long> (width) * height * 3;
+
+	if (relevantMapDataSize < 0 || relevantMapDataSize + headerSize > mapFileContent.size()) return 0;
+
+	// known by isMapOriginal() and stored in save games, so independent of the selected checksum algorithm
+	return calcLegacyCheckSum (reinterpret_cast<const char*> (mapFileContent.data()), static_cast<std::size_t> (relevantMapDataSize) + headerSize, 0);
+}
+
 //------------------------------------------------------------------------------
 uint32_t MapDownload::calculateCheckSum (const std::filesystem::path& mapFilename)
 {
-	uint32_t result = 0;
-	auto filename = cSettings::getInstance().getMapsPath() / mapFilename;
-	std::ifstream file (filename, std::ios::in | std::ios::binary | std::ios::ate);
-	if (!file.is_open() && !cSettings::getInstance().getUserMapsDir().empty())
-	{
-		// try to open the map from the user's maps dir
-		filename = cSettings::getInstance().getUserMapsDir() / mapFilename;
-		file.open (filename, std::ios::in | std::ios::binary | std::ios::ate);
-	}
-	if (file.is_open())
-	{
-		const int mapSize = (int) file.tellg();
-		std::vector<char> data (mapSize);
-		file.seekg (0, std::ios::beg);
-
-		file.read (data.data(), 9); // read only header
-		const int width = data[5] + data[6] * 256;
-		const int height = data[7] + data[8] * 256;
-		// the information after this is only for graphic stuff
-		// and not necessary for comparing two maps
-		const int relevantMapDataSize = width * height * 3;
-
-		if (relevantMapDataSize + 9 <= mapSize)
-		{
-			file.read (data.data() + 9, relevantMapDataSize);
-			if (!file.bad() && !file.eof())
-				result = calcCheckSum (data.data(), relevantMapDataSize + 9, 0);
-		}
-	}
-	return result;
+	const auto filename = getExistingMapFilePath (mapFilename);
+	if (filename.empty()) return 0;
+
+	cMappedFile file;
+	if (!file.open (filename)) return 0;
+	return calculateCheckSum (file.getData());
 }
 
 //------------------------------------------------------------------------------
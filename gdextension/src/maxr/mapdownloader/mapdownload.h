@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <filesystem>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -43,6 +44,9 @@ namespace MapDownload
 	/** @return a 32 bit checksum of the given map */
 	uint32_t calculateCheckSum (const std::filesystem::path& mapFilename);
 
+	/** @return a 32 bit checksum of the given (already read) map file content */
+	uint32_t calculateCheckSum (std::span<const unsigned char> mapFileContent);
+
 } // namespace MapDownload
 
 //--------------------------------------------------------------------
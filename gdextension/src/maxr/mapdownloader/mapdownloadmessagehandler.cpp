@@ -105,9 +105,7 @@ void cMapDownloadMessageHandler::finished (const cMuMsgFinishedMapDownload&)
 
 	mapReceiver->finished();
 
-	auto staticMap = std::make_shared<cStaticMap>();
-
-	if (!staticMap->loadMap (mapReceiver->getMapFilename())) staticMap = nullptr;
+	auto staticMap = cStaticMapCache::get (mapReceiver->getMapFilename());
 
 	onDownloaded (staticMap);
 
@@ -41,9 +41,16 @@ public:
 		langPath = dataDir / "languages";
 	}
 
+	/// Set the directory of the save game files (default: "saves" in the working directory).
+	void setSavesPath(const std::filesystem::path& dir) { savesPath = dir; }
+
+	/// Set the directory, hosted games record their replays to (default: empty, no replays).
+	void setReplaysPath(const std::filesystem::path& dir) { replaysPath = dir; }
+
 	// Paths - return sensible defaults
 	const std::filesystem::path& getMapsPath() const { return mapsPath; }
 	const std::filesystem::path& getSavesPath() const { return savesPath; }
+	const std::filesystem::path& getReplaysPath() const { return replaysPath; }
 	const std::filesystem::path& getDataDir() const { return dataDir; }
 	const std::filesystem::path& getHomeDir() const { return homeDir; }
 	const std::filesystem::path& getFontPath() const { return fontPath; }
@@ -108,6 +115,7 @@ private:
 	std::filesystem::path dataDir;
 	std::filesystem::path mapsPath;
 	std::filesystem::path savesPath;
+	std::filesystem::path replaysPath;
 	std::filesystem::path homeDir;
 	std::filesystem::path fontPath;
 	std::filesystem::path fxPath;
@@ -89,9 +89,7 @@ uint32_t cArrayCrc<T>::getChecksum (uint32_t crc) const
 {
 	if (!crcCache)
 	{
-		crcCache = 0;
-		for (const auto& e : data)
-			*crcCache = calcCheckSum (e, *crcCache);
+		crcCache = calcCheckSum (data, 0);
 	}
 
 	return calcCheckSum (*crcCache, crc);
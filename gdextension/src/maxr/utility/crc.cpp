@@ -20,10 +20,242 @@
 #include "crc.h"
 
 #include <SDL_endian.h>
+#include <atomic>
 #include <climits>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# define CRC32C_X86_MSVC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# define CRC32C_X86_GCC 1
+#elif defined(__ARM_FEATURE_CRC32)
+# include <arm_acle.h>
+# define CRC32C_ARM 1
+#endif
+
+namespace
+{
+	std::atomic<eCheckSumAlgorithm> checkSumAlgorithm = eCheckSumAlgorithm::Crc32c;
+
+	//--------------------------------------------------------------------------
+	bool isLegacy()
+	{
+		return checkSumAlgorithm.load (std::memory_order_relaxed) == eCheckSumAlgorithm::Legacy;
+	}
+
+	//--------------------------------------------------------------------------
+	// CRC-32C (Castagnoli) in reflected form, as computed by the SSE 4.2 and ARMv8 crc32c instructions.
+	// tables[n][i] is the crc of byte i followed by n zero bytes,
+	// which allows to process 8 bytes with 8 independent lookups (slicing by 8).
+	constexpr std::array<std::array<uint32_t, 256>, 8> makeCrc32cTables()
+	{
+		constexpr uint32_t polynomial = 0x82F63B78;
+		std::array<std::array<uint32_t, 256>, 8> tables{};
+		for (uint32_t i = 0; i != 256; ++i)
+		{
+			uint32_t crc = i;
+			for (int bit = 0; bit != 8; ++bit)
+				crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+			tables[0][i] = crc;
+		}
+		for (std::size_t n = 1; n != tables.size(); ++n)
+		{
+			for (uint32_t i = 0; i != 256; ++i)
+				tables[n][i] = (tables[n - 1][i] >> 8) ^ tables[0][tables[n - 1][i] & 0xFF];
+		}
+		return tables;
+	}
+	constexpr auto crc32cTables = makeCrc32cTables();
+
+	//--------------------------------------------------------------------------
+	/** processes the sizeof (T) bytes of value in little endian order */
+	template <typename T>
+	uint32_t softwareCrc32c (uint32_t crc, T value)
+	{
+		constexpr int bytes = sizeof (T);
+		if constexpr (bytes == 8)
+		{
+			const uint64_t x = value ^ crc;
+			return crc32cTables[7][x & 0xFF] ^ crc32cTables[6][(x >> 8) & 0xFF] ^ crc32cTables[5][(x >> 16) & 0xFF] ^ crc32cTables[4][(x >> 24) & 0xFF]
+			     ^ crc32cTables[3][(x >> 32) & 0xFF] ^ crc32cTables[2][(x >> 40) & 0xFF] ^ crc32cTables[1][(x >> 48) & 0xFF] ^ crc32cTables[0][x >> 56];
+		}
+		else
+		{
+			const uint32_t x = static_cast<uint32_t> (value) ^ crc;
+			uint32_t result = bytes == 4 ? 0 : crc >> (8 * bytes);
+			for (int i = 0; i != bytes; ++i)
+				result ^= crc32cTables[bytes - 1 - i][(x >> (8 * i)) & 0xFF];
+			return result;
+		}
+	}
+
+#if CRC32C_X86_GCC
+	//--------------------------------------------------------------------------
+	bool detectHardwareCrc32c()
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports ("sse4.2");
+	}
+
+	//--------------------------------------------------------------------------
+	// Inline assembler instead of the builtins, which would require to compile the callers for sse4.2.
+	// So this is inlined into the calculation of every scalar value.
+	template <typename T>
+	uint32_t hardwareCrc32c (uint32_t crc, T value)
+	{
+		if constexpr (sizeof (T) == 1) asm ("crc32b %1, %0" : "+r"(crc) : "rm"(value));
+		else if constexpr (sizeof (T) == 2) asm ("crc32w %1, %0" : "+r"(crc) : "rm"(value));
+		else if constexpr (sizeof (T) == 4) asm ("crc32l %1, %0" : "+r"(crc) : "rm"(value));
+		else
+		{
+# if defined(__x86_64__)
+			uint64_t crc64 = crc;
+			asm ("crc32q %1, %0" : "+r"(crc64) : "rm"(value));
+			crc = static_cast<uint32_t> (crc64);
+# else
+			crc = hardwareCrc32c (hardwareCrc32c (crc, static_cast<uint32_t> (value)), static_cast<uint32_t> (value >> 32));
+# endif
+		}
+		return crc;
+	}
+#elif CRC32C_X86_MSVC
+	//--------------------------------------------------------------------------
+	bool detectHardwareCrc32c()
+	{
+		int cpuInfo[4] = {};
+		__cpuid (cpuInfo, 1);
+		return (cpuInfo[2] & (1 << 20)) != 0; // SSE 4.2
+	}
+
+	//--------------------------------------------------------------------------
+	template <typename T>
+	uint32_t hardwareCrc32c (uint32_t crc, T value)
+	{
+		if constexpr (sizeof (T) == 1) return _mm_crc32_u8 (crc, value);
+		else if constexpr (sizeof (T) == 2) return _mm_crc32_u16 (crc, value);
+		else if constexpr (sizeof (T) == 4) return _mm_crc32_u32 (crc, value);
+# if defined(_M_X64)
+		else return static_cast<uint32_t> (_mm_crc32_u64 (crc, value));
+# else
+		else return _mm_crc32_u32 (_mm_crc32_u32 (crc, static_cast<uint32_t> (value)), static_cast<uint32_t> (value >> 32));
+# endif
+	}
+#elif CRC32C_ARM
+	//--------------------------------------------------------------------------
+	bool detectHardwareCrc32c()
+	{
+		return true; // the compiler was told, that the target supports the crc instructions
+	}
+
+	//--------------------------------------------------------------------------
+	template <typename T>
+	uint32_t hardwareCrc32c (uint32_t crc, T value)
+	{
+		if constexpr (sizeof (T) == 1) return __crc32cb (crc, value);
+		else if constexpr (sizeof (T) == 2) return __crc32ch (crc, value);
+		else if constexpr (sizeof (T) == 4) return __crc32cw (crc, value);
+		else return __crc32cd (crc, value);
+	}
+#else
+	//--------------------------------------------------------------------------
+	bool detectHardwareCrc32c()
+	{
+		return false;
+	}
+
+	//--------------------------------------------------------------------------
+	template <typename T>
+	uint32_t hardwareCrc32c (uint32_t crc, T value)
+	{
+		return softwareCrc32c (crc, value);
+	}
+#endif
+
+	// Hardware and software implementation give the same results,
+	// so it does not matter, when this is still false during static initialization.
+	const bool hasHardwareCrc32c = detectHardwareCrc32c();
+
+	//--------------------------------------------------------------------------
+	/** continues the crc (in the usual pre and post inverted form) with the little endian bytes of value */
+	template <typename T>
+	uint32_t crc32c (uint32_t crc, T value)
+	{
+		static_assert (std::is_unsigned_v<T>);
+		return ~(hasHardwareCrc32c ? hardwareCrc32c (~crc, value) : softwareCrc32c (~crc, value));
+	}
+
+	//--------------------------------------------------------------------------
+	uint64_t loadLittleEndian64 (const char* data)
+	{
+		uint64_t word;
+		std::memcpy (&word, data, sizeof (word));
+		return SDL_SwapLE64 (word);
+	}
+
+	//--------------------------------------------------------------------------
+	uint32_t hardwareCrc32c (const char* data, size_t dataSize, uint32_t crc)
+	{
+		crc = ~crc;
+		for (; dataSize >= sizeof (uint64_t); data += sizeof (uint64_t), dataSize -= sizeof (uint64_t))
+			crc = hardwareCrc32c (crc, loadLittleEndian64 (data));
+		for (; dataSize != 0; ++data, --dataSize)
+			crc = hardwareCrc32c (crc, static_cast<uint8_t> (*data));
+		return ~crc;
+	}
+
+	//--------------------------------------------------------------------------
+	uint32_t softwareCrc32c (const char* data, size_t dataSize, uint32_t crc)
+	{
+		crc = ~crc;
+		for (; dataSize >= sizeof (uint64_t); data += sizeof (uint64_t), dataSize -= sizeof (uint64_t))
+			crc = softwareCrc32c (crc, loadLittleEndian64 (data));
+		for (; dataSize != 0; ++data, --dataSize)
+			crc = softwareCrc32c (crc, static_cast<uint8_t> (*data));
+		return ~crc;
+	}
+
+	//--------------------------------------------------------------------------
+	/** same as calcLegacyCheckSum() of the little endian bytes of value */
+	template <typename T>
+	uint32_t legacyCheckSum (T value, uint32_t checksum)
+	{
+		for (std::size_t i = 0; i != sizeof (T); ++i)
+		{
+			checksum = checksum << 1 | checksum >> 31; // Rotate left by one.
+			checksum += static_cast<char> (value >> (8 * i));
+		}
+		return checksum;
+	}
+
+	//--------------------------------------------------------------------------
+	/** checksum of the little endian representation of value */
+	template <typename T>
+	uint32_t calcCheckSumOfUnsigned (T value, uint32_t checksum)
+	{
+		if (isLegacy())
+		{
+			return legacyCheckSum (value, checksum);
+		}
+		return crc32c (checksum, value);
+	}
+} // namespace
 
 //------------------------------------------------------------------------------
-uint32_t calcCheckSum (const char* data, size_t dataSize, uint32_t checksum)
+void setCheckSumAlgorithm (eCheckSumAlgorithm algorithm)
+{
+	checkSumAlgorithm = algorithm;
+}
+
+//------------------------------------------------------------------------------
+eCheckSumAlgorithm getCheckSumAlgorithm()
+{
+	return checkSumAlgorithm;
+}
+
+//------------------------------------------------------------------------------
+uint32_t calcLegacyCheckSum (const char* data, size_t dataSize, uint32_t checksum)
 {
 	for (const char* i = data; i != data + dataSize; ++i)
 	{
@@ -33,88 +265,86 @@ uint32_t calcCheckSum (const char* data, size_t dataSize, uint32_t checksum)
 	return checksum;
 }
 
+//------------------------------------------------------------------------------
+uint32_t calcCheckSum (const char* data, size_t dataSize, uint32_t checksum)
+{
+	if (isLegacy())
+	{
+		return calcLegacyCheckSum (data, dataSize, checksum);
+	}
+	return hasHardwareCrc32c ? hardwareCrc32c (data, dataSize, checksum) : softwareCrc32c (data, dataSize, checksum);
+}
+
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (bool data, uint32_t checksum)
 {
-	uint8_t x = static_cast<uint8_t> (data);
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint8_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (char data, uint32_t checksum)
 {
-	uint8_t x = static_cast<uint8_t> (data);
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint8_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (signed char data, uint32_t checksum)
 {
-	uint8_t x = static_cast<uint8_t> (data);
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint8_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (unsigned char data, uint32_t checksum)
 {
-	uint8_t x = static_cast<uint8_t> (data);
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint8_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (signed short data, uint32_t checksum)
 {
-	uint16_t x = SDL_SwapLE16 (static_cast<uint16_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint16_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (unsigned short data, uint32_t checksum)
 {
-	uint16_t x = SDL_SwapLE16 (static_cast<uint16_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint16_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (signed int data, uint32_t checksum)
 {
-	uint32_t x = SDL_SwapLE32 (static_cast<uint32_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint32_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (unsigned int data, uint32_t checksum)
 {
-	uint32_t x = SDL_SwapLE32 (static_cast<uint32_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint32_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (signed long data, uint32_t checksum)
 {
-	uint64_t x = SDL_SwapLE64 (static_cast<uint64_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint64_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (unsigned long data, uint32_t checksum)
 {
-	uint64_t x = SDL_SwapLE64 (static_cast<uint64_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint64_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (signed long long data, uint32_t checksum)
 {
-	uint64_t x = SDL_SwapLE64 (static_cast<uint64_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint64_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
 uint32_t calcCheckSum (unsigned long long data, uint32_t checksum)
 {
-	uint64_t x = SDL_SwapLE64 (static_cast<uint64_t> (data));
-	return calcCheckSum (reinterpret_cast<char*> (&x), sizeof (x), checksum);
+	return calcCheckSumOfUnsigned (static_cast<uint64_t> (data), checksum);
 }
 
 //------------------------------------------------------------------------------
@@ -22,8 +22,8 @@
 
 #include "utility/flatset.h"
 
-#include <SDL_endian.h>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <forward_list>
@@ -32,8 +32,33 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
+/**
+* The model checksums are compared between server and clients in every game tick,
+* so all peers of a game have to use the same algorithm.
+*/
+enum class eCheckSumAlgorithm
+{
+	Legacy, // byte wise rotate and add, as used by older versions
+	Crc32c // CRC-32C, hardware accelerated when supported by the CPU
+};
+
+/**
+* Selects the algorithm of calcCheckSum() for the whole process.
+* Must be called before the first checksum is calculated,
+* because checksums are cached (e.g. by cUnitsData and cRangeMap).
+*/
+void setCheckSumAlgorithm (eCheckSumAlgorithm);
+[[nodiscard]] eCheckSumAlgorithm getCheckSumAlgorithm();
+
+/**
+* The checksum of the legacy algorithm, independent of the selected one.
+* Used for persisted checksums, like the ones of the map files.
+*/
+[[nodiscard]] uint32_t calcLegacyCheckSum (const char* data, size_t dataSize, uint32_t checksum);
+
 [[nodiscard]] uint32_t calcCheckSum (const char* data, size_t dataSize, uint32_t checksum);
 
 [[nodiscard]] uint32_t calcCheckSum (bool data, uint32_t checksum);
@@ -59,9 +84,7 @@ struct sCrcEnum
 	template <typename T>
 	[[nodiscard]] static uint32_t getChecksum (T data, uint32_t crc)
 	{
-		int32_t value = static_cast<int32_t> (data);
-		value = SDL_SwapLE32 (value);
-		return calcCheckSum (reinterpret_cast<char*> (&value), sizeof (value), crc);
+		return calcCheckSum (static_cast<int32_t> (data), crc);
 	}
 };
 
@@ -74,6 +97,15 @@ struct sCrcClass
 	}
 };
 
+/**
+* True, when the checksum of a T is the checksum of its bytes in memory.
+* Then consecutive Ts (e.g. in a std::vector) are processed as one buffer,
+* which gives the same result, but is much faster.
+*/
+template <typename T>
+constexpr bool isCheckSumOfMemory = std::endian::native == std::endian::little && std::is_integral_v<T> && !std::is_same_v<T, bool>
+                                 && (sizeof (long) == 8 || (!std::is_same_v<T, long> && !std::is_same_v<T, unsigned long>)); // long is always processed as 64 bit value
+
 template <typename T>
 [[nodiscard]] uint32_t calcCheckSum (const T& data, uint32_t crc)
 {
@@ -106,8 +138,8 @@ template <typename T>
 	return calcCheckSum (-1, crc);
 }
 
-template <typename T>
-[[nodiscard]] uint32_t calcCheckSum (const std::unique_ptr<T>& data, uint32_t crc)
+template <typename T, typename Deleter>
+[[nodiscard]] uint32_t calcCheckSum (const std::unique_ptr<T, Deleter>& data, uint32_t crc)
 {
 	if (data)
 	{
@@ -129,6 +161,9 @@ template <typename T>
 template <typename T, std::size_t N>
 [[nodiscard]] uint32_t calcCheckSum (const std::array<T, N>& data, uint32_t checksum)
 {
+	if constexpr (isCheckSumOfMemory<T>)
+		return calcCheckSum (reinterpret_cast<const char*> (data.data()), data.size() * sizeof (T), checksum);
+
 	for (const auto& x : data)
 		checksum = calcCheckSum (x, checksum);
 
@@ -138,6 +173,9 @@ template <typename T, std::size_t N>
 template <typename T>
 [[nodiscard]] uint32_t calcCheckSum (const std::vector<T>& data, uint32_t checksum)
 {
+	if constexpr (isCheckSumOfMemory<T>)
+		return calcCheckSum (reinterpret_cast<const char*> (data.data()), data.size() * sizeof (T), checksum);
+
 	for (const auto& x : data)
 		checksum = calcCheckSum (x, checksum);
 
@@ -26,8 +26,8 @@
 #include <vector>
 
 //--------------------------------------------------------------------------
-template <typename T>
-std::vector<T*> ExtractPtrs (const std::vector<std::unique_ptr<T>>& v)
+template <typename T, typename Deleter>
+std::vector<T*> ExtractPtrs (const std::vector<std::unique_ptr<T, Deleter>>& v)
 {
 	return ranges::Transform (v, [] (const auto& ptr) { return ptr.get(); });
 }
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "utility/mappedfile.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+cMappedFile::~cMappedFile()
+{
+	close();
+}
+
+//------------------------------------------------------------------------------
+bool cMappedFile::open (const std::filesystem::path& path)
+{
+	close();
+#ifdef _WIN32
+	HANDLE file = CreateFileW (path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx (file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle (file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingW (file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle (file);
+		return false;
+	}
+	const void* view = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle (mapping);
+		CloseHandle (file);
+		return false;
+	}
+	fileHandle = file;
+	mappingHandle = mapping;
+	data = static_cast<const unsigned char*> (view);
+	size = static_cast<std::size_t> (fileSize.QuadPart);
+#else
+	const int fd = ::open (path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat fileStat;
+	if (fstat (fd, &fileStat) != 0 || fileStat.st_size <= 0)
+	{
+		::close (fd);
+		return false;
+	}
+	void* view = mmap (nullptr, static_cast<std::size_t> (fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after closing the descriptor
+	::close (fd);
+	if (view == MAP_FAILED) return false;
+
+	data = static_cast<const unsigned char*> (view);
+	size = static_cast<std::size_t> (fileStat.st_size);
+#endif
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void cMappedFile::close()
+{
+	if (data == nullptr) return;
+#ifdef _WIN32
+	UnmapViewOfFile (data);
+	CloseHandle (mappingHandle);
+	CloseHandle (fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	munmap (const_cast<unsigned char*> (data), size);
+#endif
+	data = nullptr;
+	size = 0;
+}
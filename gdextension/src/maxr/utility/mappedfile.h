@@ -0,0 +1,59 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef utility_mappedfileH
+#define utility_mappedfileH
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+/**
+* Read-only memory mapping of a whole file.
+* The mapping is released when the object is destroyed.
+*/
+class cMappedFile
+{
+public:
+	cMappedFile() = default;
+	~cMappedFile();
+
+	cMappedFile (const cMappedFile&) = delete;
+	cMappedFile& operator= (const cMappedFile&) = delete;
+
+	/**
+	* Maps the given file into memory.
+	* @return false, if the file could not be opened or mapped
+	*/
+	bool open (const std::filesystem::path&);
+	void close();
+
+	bool isOpen() const { return data != nullptr; }
+	std::span<const unsigned char> getData() const { return {data, size}; }
+
+private:
+	const unsigned char* data = nullptr;
+	std::size_t size = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // utility_mappedfileH
@@ -0,0 +1,80 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "utility/objectpool.h"
+
+#include <algorithm>
+#include <cassert>
+
+//------------------------------------------------------------------------------
+void* cObjectPool::allocate (std::size_t size, std::size_t alignment)
+{
+	if (!isPooled (size, alignment))
+	{
+		++statistics.heapAllocations;
+		return ::operator new (size, std::align_val_t (alignment));
+	}
+	const std::size_t index = size == 0 ? 0 : (size - 1) / granularity;
+	auto& sizeClass = sizeClasses[index];
+	void* block = nullptr;
+	if (sizeClass.freeBlocks)
+	{
+		block = sizeClass.freeBlocks;
+		sizeClass.freeBlocks = sizeClass.freeBlocks->next;
+	}
+	else
+	{
+		const std::size_t blockSize = (index + 1) * granularity;
+		if (sizeClass.nextUnused == sizeClass.slabEnd) addSlab (sizeClass, blockSize);
+		block = sizeClass.nextUnused;
+		sizeClass.nextUnused += blockSize;
+	}
+	++statistics.allocations;
+	++statistics.liveObjects;
+	return block;
+}
+
+//------------------------------------------------------------------------------
+void cObjectPool::deallocate (void* block, std::size_t size, std::size_t alignment) noexcept
+{
+	if (block == nullptr) return;
+	if (!isPooled (size, alignment))
+	{
+		::operator delete (block, std::align_val_t (alignment));
+		return;
+	}
+	assert (statistics.liveObjects > 0);
+	auto& sizeClass = sizeClasses[size == 0 ? 0 : (size - 1) / granularity];
+	auto* freeBlock = static_cast<sFreeBlock*> (block);
+	freeBlock->next = sizeClass.freeBlocks;
+	sizeClass.freeBlocks = freeBlock;
+	--statistics.liveObjects;
+}
+
+//------------------------------------------------------------------------------
+void cObjectPool::addSlab (sSizeClass& sizeClass, std::size_t blockSize)
+{
+	const std::size_t blockCount = std::clamp<std::size_t> (slabSize / blockSize, 8, 256);
+	const std::size_t bytes = blockCount * blockSize;
+	slabs.push_back (std::make_unique_for_overwrite<std::byte[]> (bytes));
+	sizeClass.nextUnused = slabs.back().get();
+	sizeClass.slabEnd = sizeClass.nextUnused + bytes;
+	++statistics.slabAllocations;
+	statistics.reservedBytes += bytes;
+}
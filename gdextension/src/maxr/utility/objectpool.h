@@ -0,0 +1,197 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef utility_objectpoolH
+#define utility_objectpoolH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+class cObjectPool;
+
+/**
+ * Deleter for objects created by cObjectPool::makeUnique().
+ * Without pool, the object is deleted with delete,
+ * so that objects created by a deserialization can be stored in the same pointer type.
+ */
+template <typename T>
+struct sPoolDeleter
+{
+	void operator() (T*) const noexcept;
+
+	cObjectPool* pool = nullptr;
+};
+
+template <typename T>
+using tPoolPtr = std::unique_ptr<T, sPoolDeleter<T>>;
+
+/**
+ * Allocator, that takes single objects from a cObjectPool.
+ * It keeps the pool alive, so objects allocated with std::allocate_shared
+ * may outlive the owner of the pool.
+ */
+template <typename T>
+class cPoolAllocator
+{
+	template <typename U>
+	friend class cPoolAllocator;
+
+public:
+	using value_type = T;
+
+	explicit cPoolAllocator (std::shared_ptr<cObjectPool> pool_) :
+		pool (std::move (pool_))
+	{}
+	template <typename U>
+	cPoolAllocator (const cPoolAllocator<U>& other) :
+		pool (other.pool)
+	{}
+
+	T* allocate (std::size_t n);
+	void deallocate (T*, std::size_t n) noexcept;
+
+	template <typename U>
+	bool operator== (const cPoolAllocator<U>& other) const { return pool == other.pool; }
+
+private:
+	std::shared_ptr<cObjectPool> pool;
+};
+
+/**
+ * Memory pool for objects, which are created and destroyed frequently
+ * while a model runs (units, move and attack jobs, effects).
+ *
+ * Requests are rounded up to size classes of 16 bytes. Each size class
+ * takes its blocks from slabs, which stay in place until the pool is
+ * destroyed, so the addresses of the objects are stable. Released blocks
+ * are reused by the next allocation of the same size class.
+ * Larger or over aligned requests are passed to the heap.
+ *
+ * The pool is not thread safe. Objects have to be created and released
+ * by the thread running the model.
+ */
+class cObjectPool : public std::enable_shared_from_this<cObjectPool>
+{
+public:
+	struct sStatistics
+	{
+		std::uint64_t allocations = 0; ///< served by the pool
+		std::uint64_t heapAllocations = 0; ///< too large for the pool
+		std::uint64_t slabAllocations = 0; ///< slabs requested from the heap
+		std::size_t liveObjects = 0;
+		std::size_t reservedBytes = 0;
+	};
+
+	cObjectPool() = default;
+	cObjectPool (const cObjectPool&) = delete;
+	cObjectPool& operator= (const cObjectPool&) = delete;
+
+	void* allocate (std::size_t size, std::size_t alignment);
+	void deallocate (void*, std::size_t size, std::size_t alignment) noexcept;
+
+	/** Creates the object in the pool. The pool has to be owned by a std::shared_ptr. */
+	template <typename T, typename... Args>
+	std::shared_ptr<T> makeShared (Args&&... args)
+	{
+		return std::allocate_shared<T> (cPoolAllocator<T> (shared_from_this()), std::forward<Args> (args)...);
+	}
+	/** Creates the object in the pool. The object must not outlive the pool. */
+	template <typename T, typename... Args>
+	tPoolPtr<T> makeUnique (Args&&... args)
+	{
+		void* memory = allocate (sizeof (T), alignof (T));
+		try
+		{
+			return tPoolPtr<T> (new (memory) T (std::forward<Args> (args)...), sPoolDeleter<T>{this});
+		}
+		catch (...)
+		{
+			deallocate (memory, sizeof (T), alignof (T));
+			throw;
+		}
+	}
+
+	const sStatistics& getStatistics() const { return statistics; }
+
+private:
+	static constexpr std::size_t granularity = 16;
+	static constexpr std::size_t maxBlockSize = 2048;
+	static constexpr std::size_t slabSize = 16 * 1024;
+
+	struct sFreeBlock
+	{
+		sFreeBlock* next;
+	};
+	struct sSizeClass
+	{
+		sFreeBlock* freeBlocks = nullptr;
+		std::byte* nextUnused = nullptr; // blocks of the latest slab, that were never handed out
+		std::byte* slabEnd = nullptr;
+	};
+
+	static bool isPooled (std::size_t size, std::size_t alignment)
+	{
+		return size <= maxBlockSize && alignment <= granularity && alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+	}
+	void addSlab (sSizeClass&, std::size_t blockSize);
+
+	std::array<sSizeClass, maxBlockSize / granularity> sizeClasses;
+	std::vector<std::unique_ptr<std::byte[]>> slabs;
+	sStatistics statistics;
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+void sPoolDeleter<T>::operator() (T* object) const noexcept
+{
+	if (pool == nullptr)
+	{
+		delete object;
+		return;
+	}
+	object->~T();
+	pool->deallocate (object, sizeof (T), alignof (T));
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+T* cPoolAllocator<T>::allocate (std::size_t n)
+{
+	if (n != 1) return std::allocator<T>().allocate (n);
+	return static_cast<T*> (pool->allocate (sizeof (T), alignof (T)));
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void cPoolAllocator<T>::deallocate (T* p, std::size_t n) noexcept
+{
+	if (n != 1)
+	{
+		std::allocator<T>().deallocate (p, n);
+		return;
+	}
+	pool->deallocate (p, sizeof (T), alignof (T));
+}
+
+#endif // utility_objectpoolH
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "utility/path.h"
+
+#include "utility/crc.h"
+
+#include <algorithm>
+#include <utility>
+
+//------------------------------------------------------------------------------
+cPath::cPath (std::initializer_list<cPosition> positions)
+{
+	reserve (positions.size());
+	for (const auto& position : positions)
+	{
+		push_back (position);
+	}
+}
+
+//------------------------------------------------------------------------------
+void cPath::reserve (std::size_t size)
+{
+	if (size <= localCapacity || size <= heap.capacity()) return;
+
+	if (isLocal())
+	{
+		heap.reserve (size);
+		heap.assign (local.begin(), local.begin() + count);
+	}
+	else
+	{
+		heap.reserve (size);
+	}
+}
+
+//------------------------------------------------------------------------------
+void cPath::push_back (const cPosition& position)
+{
+	if (isLocal())
+	{
+		if (count < localCapacity)
+		{
+			local[count++] = position;
+			return;
+		}
+		heap.reserve (2 * localCapacity);
+		heap.assign (local.begin(), local.end());
+	}
+	heap.push_back (position);
+	++count;
+}
+
+//------------------------------------------------------------------------------
+void cPath::pop_front()
+{
+	assert (!empty());
+	++first;
+}
+
+//------------------------------------------------------------------------------
+void cPath::clear()
+{
+	heap.clear(); // keeps the capacity for reuse
+	first = 0;
+	count = 0;
+}
+
+//------------------------------------------------------------------------------
+void cPath::reverse()
+{
+	std::reverse (data() + first, data() + count);
+}
+
+//------------------------------------------------------------------------------
+void cPath::swap (cPath& other) noexcept
+{
+	std::swap (local, other.local);
+	std::swap (heap, other.heap);
+	std::swap (first, other.first);
+	std::swap (count, other.count);
+}
+
+//------------------------------------------------------------------------------
+bool cPath::operator== (const cPath& other) const
+{
+	return std::equal (begin(), end(), other.begin(), other.end());
+}
+
+//------------------------------------------------------------------------------
+uint32_t cPath::getChecksum (uint32_t crc) const
+{
+	for (const auto& position : *this)
+	{
+		crc = calcCheckSum (position, crc);
+	}
+	return crc;
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef utility_pathH
+#define utility_pathH
+
+#include "utility/position.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+/**
+* The way points of a path, in the order they are visited.
+*
+* The positions are stored contiguously.
+* Paths up to localCapacity way points need no heap allocation.
+* Visited way points are skipped by a cursor instead of being erased,
+* so advancing on the path does not move any data.
+*/
+class cPath
+{
+public:
+	using value_type = cPosition;
+	using const_iterator = const cPosition*;
+
+	static constexpr std::size_t localCapacity = 16;
+
+	cPath() = default;
+	cPath (std::initializer_list<cPosition>);
+
+	bool empty() const { return first == count; }
+	std::size_t size() const { return count - first; }
+
+	/** the next way point */
+	const cPosition& front() const
+	{
+		assert (!empty());
+		return data()[first];
+	}
+	/** the destination */
+	const cPosition& back() const
+	{
+		assert (!empty());
+		return data()[count - 1];
+	}
+
+	const_iterator begin() const { return data() + first; }
+	const_iterator end() const { return data() + count; }
+
+	void reserve (std::size_t);
+	void push_back (const cPosition&);
+	/** skips the next way point */
+	void pop_front();
+	void clear();
+	void reverse();
+	void swap (cPath&) noexcept;
+
+	bool operator== (const cPath&) const;
+
+	uint32_t getChecksum (uint32_t crc) const;
+
+private:
+	bool isLocal() const { return heap.empty(); }
+	cPosition* data() { return isLocal() ? local.data() : heap.data(); }
+	const cPosition* data() const { return isLocal() ? local.data() : heap.data(); }
+
+private:
+	std::array<cPosition, localCapacity> local;
+	std::vector<cPosition> heap; // holds all way points, when there are more than localCapacity
+	std::uint32_t first = 0;
+	std::uint32_t count = 0;
+};
+
+#endif // utility_pathH
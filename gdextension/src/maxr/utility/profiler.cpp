@@ -0,0 +1,217 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "utility/profiler.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	// limits the memory of a forgotten trace to about 24 MB
+	constexpr std::size_t maxTraceEvents = 1 << 20;
+
+	//--------------------------------------------------------------------------
+	std::vector<cProfiler::sPhase> withoutUnused (const std::vector<cProfiler::sPhase>& phases)
+	{
+		std::vector<cProfiler::sPhase> result;
+		std::ranges::copy_if (phases, std::back_inserter (result), [] (const auto& phase) { return phase.count > 0; });
+		return result;
+	}
+} // namespace
+
+//------------------------------------------------------------------------------
+cProfiler::cScope::cScope (cProfiler& profiler_, const char* name_) :
+	profiler (profiler_.enabled ? &profiler_ : nullptr),
+	name (name_)
+{
+	if (profiler) start = clock::now();
+}
+
+//------------------------------------------------------------------------------
+cProfiler::cScope::~cScope()
+{
+	if (profiler) profiler->add (name, start, clock::now());
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::setEnabled (bool value)
+{
+	enabled = value;
+	if (value) return;
+
+	std::unique_lock<std::mutex> lock (mutex);
+	lastTick.clear();
+	currentTurn.clear();
+	currentTurnTickCount = 0;
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::add (const char* name, clock::time_point start, clock::time_point end)
+{
+	const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds> (end - start).count();
+
+	auto& phase = getTickPhase (name);
+	phase.microseconds += microseconds;
+	phase.count++;
+
+	if (tracing)
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		if (traceEvents.size() < maxTraceEvents)
+		{
+			const auto offset = std::chrono::duration_cast<std::chrono::microseconds> (start - traceStart).count();
+			traceEvents.push_back ({name, offset, microseconds});
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::addCount (const char* name, std::uint64_t count)
+{
+	if (!enabled || count == 0) return;
+
+	getTickPhase (name).count += static_cast<int> (count);
+}
+
+//------------------------------------------------------------------------------
+cProfiler::sPhase& cProfiler::getTickPhase (const char* name)
+{
+	auto it = std::ranges::find (tick, std::string_view (name), &sPhase::name);
+	if (it == tick.end())
+	{
+		tick.push_back (sPhase{name});
+		it = std::prev (tick.end());
+	}
+	return *it;
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::addTo (std::vector<sPhase>& phases, const sPhase& phase)
+{
+	auto it = std::ranges::find (phases, phase.name, &sPhase::name);
+	if (it == phases.end())
+	{
+		phases.push_back (phase);
+		return;
+	}
+	it->microseconds += phase.microseconds;
+	it->count += phase.count;
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::endTick()
+{
+	if (!enabled) return;
+
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		lastTick = withoutUnused (tick);
+		for (const auto& phase : lastTick)
+		{
+			addTo (currentTurn, phase);
+		}
+		currentTurnTickCount++;
+	}
+	// keep the entries, so that the names are not allocated again in every tick
+	for (auto& phase : tick)
+	{
+		phase.microseconds = 0;
+		phase.count = 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::endTurn()
+{
+	if (!enabled) return;
+
+	std::unique_lock<std::mutex> lock (mutex);
+	lastTurn = std::move (currentTurn);
+	lastTurnTickCount = currentTurnTickCount;
+	currentTurn.clear();
+	currentTurnTickCount = 0;
+}
+
+//------------------------------------------------------------------------------
+std::vector<cProfiler::sPhase> cProfiler::getLastTick() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	return lastTick;
+}
+
+//------------------------------------------------------------------------------
+std::vector<cProfiler::sPhase> cProfiler::getCurrentTurn() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	return currentTurn;
+}
+
+//------------------------------------------------------------------------------
+std::vector<cProfiler::sPhase> cProfiler::getLastTurn() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	return lastTurn;
+}
+
+//------------------------------------------------------------------------------
+unsigned int cProfiler::getLastTurnTickCount() const
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	return lastTurnTickCount;
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::startTrace()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	traceEvents.clear();
+	traceStart = clock::now();
+	tracing = true;
+}
+
+//------------------------------------------------------------------------------
+void cProfiler::stopTrace()
+{
+	tracing = false;
+}
+
+//------------------------------------------------------------------------------
+bool cProfiler::writeTrace (const std::filesystem::path& path) const
+{
+	std::vector<sTraceEvent> events;
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		events = traceEvents;
+	}
+
+	std::ofstream file (path);
+	if (!file) return false;
+
+	// the names are identifiers from the code, so they need no escaping
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (std::size_t i = 0; i != events.size(); ++i)
+	{
+		const auto& event = events[i];
+		file << (i == 0 ? "\n" : ",\n");
+		file << "{\"name\":\"" << event.name << "\",\"cat\":\"model\",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":1}";
+	}
+	file << "\n]}\n";
+	return static_cast<bool> (file);
+}
@@ -0,0 +1,128 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef utility_profilerH
+#define utility_profilerH
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Collects the time spent in named phases of the game model.
+ * The phases are measured with cProfiler::cScope and summed up
+ * per tick and per turn. Optionally every measured scope
+ * is recorded as trace event, which can be written as
+ * Chrome trace event json file (chrome://tracing, Perfetto).
+ *
+ * The scopes have to be opened by one thread (the thread running the model).
+ * The results can be read from any thread.
+ */
+class cProfiler
+{
+	using clock = std::chrono::steady_clock;
+
+public:
+	struct sPhase
+	{
+		std::string name;
+		std::int64_t microseconds = 0;
+		int count = 0;
+	};
+
+	class cScope
+	{
+	public:
+		/** @param name must be a string literal, it is stored as pointer */
+		cScope (cProfiler&, const char* name);
+		~cScope();
+
+		cScope (const cScope&) = delete;
+		cScope& operator= (const cScope&) = delete;
+
+	private:
+		cProfiler* profiler = nullptr;
+		const char* name = nullptr;
+		clock::time_point start;
+	};
+
+	void setEnabled (bool);
+	bool isEnabled() const { return enabled; }
+
+	/**
+	 * Adds count events without time to the named phase of the current tick.
+	 * Used for counters like allocations.
+	 * @param name must be a string literal, it is stored as pointer
+	 */
+	void addCount (const char* name, std::uint64_t count);
+
+	/** Closes the current tick. */
+	void endTick();
+	/** Closes the current turn. The ticks closed before belong to the finished turn. */
+	void endTurn();
+
+	std::vector<sPhase> getLastTick() const;
+	std::vector<sPhase> getCurrentTurn() const;
+	std::vector<sPhase> getLastTurn() const;
+	unsigned int getLastTurnTickCount() const;
+
+	/** Starts recording trace events. Previously recorded events are discarded. */
+	void startTrace();
+	/** Stops recording trace events. */
+	void stopTrace();
+	bool isTracing() const { return tracing; }
+	/**
+	 * Writes the recorded trace events as Chrome trace event json file.
+	 * @return false, if the file could not be written
+	 */
+	bool writeTrace (const std::filesystem::path&) const;
+
+private:
+	struct sTraceEvent
+	{
+		const char* name;
+		std::int64_t start;
+		std::int64_t duration;
+	};
+
+	void add (const char* name, clock::time_point start, clock::time_point end);
+	sPhase& getTickPhase (const char* name);
+	static void addTo (std::vector<sPhase>&, const sPhase&);
+
+	std::atomic<bool> enabled = false;
+	std::atomic<bool> tracing = false;
+
+	std::vector<sPhase> tick;
+
+	mutable std::mutex mutex;
+	std::vector<sPhase> lastTick;
+	std::vector<sPhase> currentTurn;
+	std::vector<sPhase> lastTurn;
+	unsigned int currentTurnTickCount = 0;
+	unsigned int lastTurnTickCount = 0;
+
+	clock::time_point traceStart;
+	std::vector<sTraceEvent> traceEvents;
+};
+
+#endif
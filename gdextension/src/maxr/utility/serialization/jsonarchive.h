@@ -181,6 +181,17 @@ private:
 		json = std::move (arr);
 	}
 
+	//--------------------------------------------------------------------------
+	void pushValue (const cPath& path)
+	{
+		auto arr = nlohmann::json::array();
+		for (const auto& e : path)
+		{
+			cJsonArchiveOut (arr.emplace_back()) << e;
+		}
+		json = std::move (arr);
+	}
+
 	//--------------------------------------------------------------------------
 	template <typename T>
 	void pushValue (const std::optional<T>& o)
@@ -362,6 +373,7 @@ private:
 	template <typename K, typename V>
 	void popValue (std::map<K, V>& m)
 	{
+		m.clear();
 		for (const auto& e : json)
 		{
 			std::pair<K, V> p;
@@ -374,6 +386,7 @@ private:
 	template <typename T, typename Cmp>
 	void popValue (cFlatSet<T, Cmp>& v)
 	{
+		v.clear();
 		for (const auto& e : json)
 		{
 			T item;
@@ -382,6 +395,19 @@ private:
 		}
 	}
 
+	//--------------------------------------------------------------------------
+	void popValue (cPath& path)
+	{
+		path.clear();
+		path.reserve (json.size());
+		for (const auto& e : json)
+		{
+			cPosition item;
+			cJsonArchiveIn (e, strict) >> item;
+			path.push_back (item);
+		}
+	}
+
 	//--------------------------------------------------------------------------
 	template <typename T>
 	void popValue (std::optional<T>& value)
@@ -24,6 +24,7 @@
 #include "utility/color.h"
 #include "utility/flatset.h"
 #include "utility/log.h"
+#include "utility/path.h"
 #include "utility/position.h"
 #include "utility/string/utf-8.h"
 
@@ -218,8 +219,8 @@ namespace serialization
 	}
 
 	//-------------------------------------------------------------------------
-	template <ArchiveOut Archive, typename T>
-	void save (Archive& archive, const std::unique_ptr<T>& value)
+	template <ArchiveOut Archive, typename T, typename Deleter>
+	void save (Archive& archive, const std::unique_ptr<T, Deleter>& value)
 	{
 		if (value)
 		{
@@ -230,13 +231,14 @@ namespace serialization
 			throw std::runtime_error ("Unexpected null unique_ptr");
 		}
 	}
-	template <ArchiveIn Archive, typename T>
-	void load (Archive& archive, std::unique_ptr<T>& value)
+	template <ArchiveIn Archive, typename T, typename Deleter>
+	void load (Archive& archive, std::unique_ptr<T, Deleter>& value)
 	{
-		value = T::createFrom (archive);
+		// loaded objects are allocated by createFrom(), not by a custom allocator of the deleter
+		value = std::unique_ptr<T, Deleter> (T::createFrom (archive).release());
 	}
-	template <ArchiveInOrOut Archive, typename T>
-	void serialize (Archive& archive, std::unique_ptr<T>& value)
+	template <ArchiveInOrOut Archive, typename T, typename Deleter>
+	void serialize (Archive& archive, std::unique_ptr<T, Deleter>& value)
 	{
 		serialization::detail::splitFree (archive, value);
 	}
@@ -411,6 +413,7 @@ namespace serialization
 	{
 		uint32_t length;
 		archive >> NVP (length);
+		value.clear();
 		for (size_t i = 0; i < length; i++)
 		{
 			T item;
@@ -423,6 +426,37 @@ namespace serialization
 	{
 		serialization::detail::splitFree (archive, value);
 	}
+
+	//------------------------------------------------------------------------------
+	template <ArchiveOut Archive>
+	void save (Archive& archive, const cPath& value)
+	{
+		uint32_t length = static_cast<uint32_t> (value.size());
+		archive << NVP (length);
+		for (const auto& item : value)
+		{
+			archive << NVP (item);
+		}
+	}
+	template <ArchiveIn Archive>
+	void load (Archive& archive, cPath& value)
+	{
+		uint32_t length;
+		archive >> NVP (length);
+		value.clear();
+		value.reserve (length);
+		for (size_t i = 0; i < length; i++)
+		{
+			cPosition item;
+			archive >> NVP (item);
+			value.push_back (item);
+		}
+	}
+	template <ArchiveInOrOut Archive>
+	void serialize (Archive& archive, cPath& value)
+	{
+		serialization::detail::splitFree (archive, value);
+	}
 	//------------------------------------------------------------------------------
 	template <ArchiveOut Archive, typename K, typename T>
 	void save (Archive& archive, const std::map<K, T>& value)
@@ -439,6 +473,7 @@ namespace serialization
 	{
 		uint32_t length;
 		archive >> NVP (length);
+		value.clear();
 		for (size_t i = 0; i < length; i++)
 		{
 			std::pair<K, T> c;
@@ -30,9 +30,9 @@
 #include <cassert>
 #include <functional>
 #include <limits>
-#include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 /**
  * Basic signal class. This class should never be instantiated directly.
@@ -98,17 +98,45 @@ private:
  * and hence the user of the signal has to make sure that all connected
  * functions are outliving the signal object.
  *
+ * Many signals (e.g. the ones of every map field and unit) are never connected.
+ * Therefore a signal does not allocate anything until the first connection is made,
+ * and invoking a signal without connections only tests a pointer.
+ *
  * @tparam ...Args The arguments of the signal function.
  */
 template <typename... Args, typename MutexType>
 class cSignal<void (Args...), MutexType> : public cSignalBase
 {
 	using SlotType = cSlot<void (Args...)>;
-	using SlotsContainerType = std::list<SlotType>;
+	using SlotsContainerType = std::vector<SlotType>;
+
+	/**
+	 * The connection state of a signal.
+	 * Allocated on the first connect and shared with the connection objects
+	 * via the contained signal reference.
+	 */
+	struct sConnections
+	{
+		explicit sConnections (cSignalBase& signal) :
+			reference (signal)
+		{}
+
+		cSignalReference reference;
+		SlotsContainerType slots;
+		// slots connected while the signal is invoked.
+		// They are moved to slots, when the outermost invocation has finished.
+		SlotsContainerType pendingSlots;
+
+		// NOTE: may could be implemented as kind of "identifier pool" but it seems kind of
+		//       overkill here for me since I don't think we will ever create as many
+		//       connections as an integer can represent numbers.
+		unsigned long long nextIdentifer = 0;
+
+		bool isInvoking = false;
+	};
 
 public:
-	cSignal() :
-		thisReference (std::make_shared<cSignalReference> (*this)) {}
+	cSignal() = default;
 	cSignal (const cSignal&) = delete;
 	cSignal& operator= (const cSignal&) = delete;
 
@@ -165,16 +193,7 @@ private:
 	void cleanUpConnections();
 
 private:
-	SlotsContainerType slots;
-
-	// NOTE: may could be implemented as kind of "identifier pool" but it seems kind of
-	//       overkill here for me since I don't think we will ever create as many
-	//       connections as an integer can represent numbers.
-	unsigned long long nextIdentifer = 0;
-
-	bool isInvoking = false;
-
-	std::shared_ptr<cSignalReference> thisReference;
+	std::shared_ptr<sConnections> connections;
 
 	// NOTE: is important that this one is a recursive mutex (as e.g the SDL_Mutex or std::recursive_mutex).
 	MutexType mutex;
@@ -188,14 +207,19 @@ cSignalConnection cSignal<void (Args...), MutexType>::connect (F&& f)
 {
 	std::unique_lock<MutexType> lock (mutex);
 
-	std::weak_ptr<cSignalReference> weakSignalRef (thisReference);
-	cSignalConnection connection (nextIdentifer++, weakSignalRef);
-	assert (nextIdentifer < std::numeric_limits<unsigned int>::max());
-
-	assert (!isInvoking); // FIXME: can lead to endless loop! fix this and remove the assert
+	if (!connections)
+	{
+		connections = std::make_shared<sConnections> (*this);
+	}
+	std::weak_ptr<cSignalReference> weakSignalRef (std::shared_ptr<cSignalReference> (connections, &connections->reference));
+	cSignalConnection connection (connections->nextIdentifer++, weakSignalRef);
+	assert (connections->nextIdentifer < std::numeric_limits<unsigned int>::max());
 
 	auto slotFunction = typename SlotType::function_type (std::forward<F> (f));
-	slots.emplace_back (connection, std::move (slotFunction));
+	// do not invalidate the slots, which are currently iterated.
+	// The new slot will be called by the next invocation.
+	auto& targetSlots = connections->isInvoking ? connections->pendingSlots : connections->slots;
+	targetSlots.emplace_back (connection.identifier, std::move (slotFunction));
 
 	return connection;
 }
@@ -214,22 +238,27 @@ void cSignal<void (Args...), MutexType>::disconnect (const F& f)
 
 	std::unique_lock<MutexType> lock (mutex);
 
-	for (auto& slot : slots)
+	if (!connections) return;
+
+	for (auto* slots : {&connections->slots, &connections->pendingSlots})
 	{
-		// NOTE: This may depend on the concrete implementation of std::function
-		//       and therefor is not platform independent.
-		//       This has to be rechecked with the C++ standard. If it is not
-		//       platform independent we may choose to discard the disconnection
-		//       by the original function object and just allow disconnection by
-		//       the connection objects.
-		test_type* target = slot.function.template target<test_type>();
-		if (target != nullptr)
+		for (auto& slot : *slots)
 		{
-			auto& t1 = conditionalDeref (target, should_deref());
-			auto& t2 = conditionalDeref (&f, should_deref());
-			if (*t1 == *t2)
+			// NOTE: This may depend on the concrete implementation of std::function
+			//       and therefor is not platform independent.
+			//       This has to be rechecked with the C++ standard. If it is not
+			//       platform independent we may choose to discard the disconnection
+			//       by the original function object and just allow disconnection by
+			//       the connection objects.
+			test_type* target = slot.function.template target<test_type>();
+			if (target != nullptr)
 			{
-				slot.disconnected = true;
+				auto& t1 = conditionalDeref (target, should_deref());
+				auto& t2 = conditionalDeref (&f, should_deref());
+				if (*t1 == *t2)
+				{
+					slot.disconnected = true;
+				}
 			}
 		}
 	}
@@ -241,11 +270,16 @@ void cSignal<void (Args...), MutexType>::disconnect (const cSignalConnection& co
 {
 	std::unique_lock<MutexType> lock (mutex);
 
-	for (auto& slot : slots)
+	if (!connections || connection.signalReference.lock().get() != &connections->reference) return;
+
+	for (auto* slots : {&connections->slots, &connections->pendingSlots})
 	{
-		if (slot.connection == connection)
+		for (auto& slot : *slots)
 		{
-			slot.disconnected = true;
+			if (slot.identifier == connection.identifier)
+			{
+				slot.disconnected = true;
+			}
 		}
 	}
 
@@ -260,11 +294,13 @@ void cSignal<void (Args...), MutexType>::operator() (Args2&&... args)
 {
 	std::unique_lock<MutexType> lock (mutex);
 
-	auto wasInvoking = isInvoking;
-	isInvoking = true;
-	auto resetter = makeScopedOperation ([&]() { isInvoking = wasInvoking; this->cleanUpConnections(); });
+	if (!connections || connections->slots.empty()) return;
+
+	auto wasInvoking = connections->isInvoking;
+	connections->isInvoking = true;
+	auto resetter = makeScopedOperation ([&]() { connections->isInvoking = wasInvoking; this->cleanUpConnections(); });
 
-	for (auto& slot : slots)
+	for (auto& slot : connections->slots)
 	{
 		if (slot.disconnected) continue;
 		slot.function (args...);
@@ -275,8 +311,15 @@ void cSignal<void (Args...), MutexType>::operator() (Args2&&... args)
 template <typename... Args, typename MutexType>
 void cSignal<void (Args...), MutexType>::cleanUpConnections()
 {
-	if (isInvoking) return; // it is not safe to clean up yet
+	if (!connections || connections->isInvoking) return; // it is not safe to clean up yet
 
+	auto& slots = connections->slots;
+	auto& pendingSlots = connections->pendingSlots;
+	if (!pendingSlots.empty())
+	{
+		slots.insert (slots.end(), std::make_move_iterator (pendingSlots.begin()), std::make_move_iterator (pendingSlots.end()));
+		pendingSlots.clear();
+	}
 	std::erase_if (slots, [] (const auto& slot) { return slot.disconnected; });
 }
 
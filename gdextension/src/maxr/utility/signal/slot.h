@@ -20,8 +20,6 @@
 #ifndef utility_signal_slotH
 #define utility_signal_slotH
 
-#include "utility/signal/signalconnection.h"
-
 #include <functional>
 
 template <typename Signature>
@@ -30,12 +28,12 @@ class cSlot
 public:
 	using function_type = std::function<Signature>;
 
-	cSlot (cSignalConnection connection, function_type function) :
-		connection (std::move (connection)),
+	cSlot (unsigned long long identifier, function_type function) :
+		identifier (identifier),
 		function (std::move (function))
 	{}
 
-	cSignalConnection connection;
+	unsigned long long identifier;
 	function_type function;
 	bool disconnected = false;
 };
@@ -0,0 +1,205 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "parallelfor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	thread_local bool serialOnThisThread = false;
+
+	//--------------------------------------------------------------------------
+	/**
+	 * Threads, that run the workers 1..n-1 of runParallelWorkers().
+	 * Started on first use and kept until the end of the program.
+	 */
+	class cWorkerPool
+	{
+	public:
+		static cWorkerPool& getInstance()
+		{
+			static cWorkerPool pool (std::clamp<std::size_t> (std::thread::hardware_concurrency(), 1, 16) - 1);
+			return pool;
+		}
+
+		explicit cWorkerPool (std::size_t threadCount);
+		~cWorkerPool();
+
+		std::size_t getThreadCount() const { return threads.size(); }
+
+		void run (std::size_t workerCount, const std::function<void (std::size_t)>& work);
+
+	private:
+		struct sJob
+		{
+			const std::function<void (std::size_t)>* work = nullptr;
+			std::size_t workerCount = 0;
+			std::size_t nextWorker = 1; // worker 0 is the calling thread
+			std::size_t running = 0;
+			std::exception_ptr exception;
+		};
+
+		void work();
+		/** runs the next worker of the front job. The lock is released while the worker runs */
+		void runNextWorker (std::unique_lock<std::mutex>&, sJob&);
+
+	private:
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::deque<sJob*> jobs; // jobs with workers, that were not started yet
+		bool exit = false;
+		std::vector<std::thread> threads;
+	};
+
+	//--------------------------------------------------------------------------
+	cWorkerPool::cWorkerPool (std::size_t threadCount)
+	{
+		for (std::size_t i = 0; i != threadCount; ++i)
+		{
+			threads.emplace_back ([this]() { work(); });
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	cWorkerPool::~cWorkerPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock (mutex);
+			exit = true;
+		}
+		changed.notify_all();
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	void cWorkerPool::run (std::size_t workerCount, const std::function<void (std::size_t)>& work)
+	{
+		sJob job;
+		job.work = &work;
+		job.workerCount = workerCount;
+		{
+			std::unique_lock<std::mutex> lock (mutex);
+			jobs.push_back (&job);
+		}
+		changed.notify_all();
+
+		try
+		{
+			work (0);
+		}
+		catch (...)
+		{
+			std::unique_lock<std::mutex> lock (mutex);
+			if (!job.exception) job.exception = std::current_exception();
+		}
+
+		std::unique_lock<std::mutex> lock (mutex);
+		// do not wait for busy pool threads to start the remaining workers
+		while (job.nextWorker != job.workerCount)
+		{
+			runNextWorker (lock, job);
+		}
+		changed.wait (lock, [&]() { return job.running == 0; });
+
+		if (job.exception) std::rethrow_exception (job.exception);
+	}
+
+	//--------------------------------------------------------------------------
+	void cWorkerPool::runNextWorker (std::unique_lock<std::mutex>& lock, sJob& job)
+	{
+		const std::size_t workerIndex = job.nextWorker++;
+		if (job.nextWorker == job.workerCount) std::erase (jobs, &job);
+		++job.running;
+
+		lock.unlock();
+		std::exception_ptr exception;
+		try
+		{
+			(*job.work) (workerIndex);
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		lock.lock();
+
+		if (exception && !job.exception) job.exception = exception;
+		if (--job.running == 0) changed.notify_all();
+	}
+
+	//--------------------------------------------------------------------------
+	void cWorkerPool::work()
+	{
+		// nested parallelFor() calls run on the pool thread only
+		serialOnThisThread = true;
+
+		std::unique_lock<std::mutex> lock (mutex);
+		while (true)
+		{
+			changed.wait (lock, [this]() { return exit || !jobs.empty(); });
+			if (exit) return;
+
+			runNextWorker (lock, *jobs.front());
+		}
+	}
+} // namespace
+
+//------------------------------------------------------------------------------
+std::size_t getParallelWorkerCount()
+{
+	if (serialOnThisThread) return 1;
+	return cWorkerPool::getInstance().getThreadCount() + 1;
+}
+
+//------------------------------------------------------------------------------
+cSerialParallelForScope::cSerialParallelForScope() :
+	wasSerial (serialOnThisThread)
+{
+	serialOnThisThread = true;
+}
+
+//------------------------------------------------------------------------------
+cSerialParallelForScope::~cSerialParallelForScope()
+{
+	serialOnThisThread = wasSerial;
+}
+
+//------------------------------------------------------------------------------
+void runParallelWorkers (std::size_t workerCount, const std::function<void (std::size_t)>& work)
+{
+	if (workerCount <= 1 || serialOnThisThread)
+	{
+		// same order of the calls as a single worker would make
+		for (std::size_t workerIndex = 0; workerIndex != workerCount; ++workerIndex)
+		{
+			work (workerIndex);
+		}
+		return;
+	}
+	cWorkerPool::getInstance().run (workerCount, work);
+}
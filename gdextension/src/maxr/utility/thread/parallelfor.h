@@ -0,0 +1,100 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef utility_thread_parallelforH
+#define utility_thread_parallelforH
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+/**
+ * Returns the number of workers, that should be used by parallelFor().
+ * Returns 1, when parallelFor() runs serially on the current thread.
+ */
+std::size_t getParallelWorkerCount();
+
+/**
+ * While an instance exists, parallelFor() runs serially on the current thread.
+ * Used by threads, that already share the cores with others (like the workers
+ * of a cServerPool), so that they do not oversubscribe the CPU.
+ */
+class cSerialParallelForScope
+{
+public:
+	cSerialParallelForScope();
+	~cSerialParallelForScope();
+
+	cSerialParallelForScope (const cSerialParallelForScope&) = delete;
+	cSerialParallelForScope& operator= (const cSerialParallelForScope&) = delete;
+
+private:
+	bool wasSerial;
+};
+
+/**
+ * Calls work (workerIndex) for every workerIndex in [0, workerCount).
+ * Worker 0 runs on the calling thread, the others on the threads of a
+ * persistent pool. Returns after all calls have been finished.
+ * When a call throws, the first exception is rethrown to the caller.
+ */
+void runParallelWorkers (std::size_t workerCount, const std::function<void (std::size_t)>& work);
+
+/**
+ * Calls function (workerIndex, index) for every index in [0, count).
+ * The indices are distributed over workerCount workers,
+ * the calling thread is used as worker 0.
+ * Returns after all calls have been finished.
+ * The calls of one worker are made sequentially,
+ * so per worker data can be indexed by workerIndex.
+ * When a call throws, no further indices are started
+ * and the exception is rethrown to the caller.
+ */
+template <typename F>
+void parallelFor (std::size_t count, std::size_t workerCount, F&& function)
+{
+	workerCount = std::min (workerCount, count);
+	if (workerCount <= 1)
+	{
+		for (std::size_t i = 0; i != count; ++i)
+		{
+			function (std::size_t (0), i);
+		}
+		return;
+	}
+
+	std::atomic<std::size_t> next = 0;
+	runParallelWorkers (workerCount, [&] (std::size_t workerIndex) {
+		try
+		{
+			for (std::size_t i = next++; i < count; i = next++)
+			{
+				function (workerIndex, i);
+			}
+		}
+		catch (...)
+		{
+			next = count;
+			throw;
+		}
+	});
+}
+
+#endif
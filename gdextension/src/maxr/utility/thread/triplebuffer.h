@@ -0,0 +1,83 @@
+/***************************************************************************
+ *      Mechanized Assault and Exploration Reloaded Projectfile            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef utility_thread_triplebufferH
+#define utility_thread_triplebufferH
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Hands over values from one writer thread to one reader thread without
+ * locking: the writer fills the back buffer and publishes it, the reader
+ * picks up the latest published buffer. Neither side ever waits for the
+ * other. A buffer is only written again after the reader released it by
+ * picking up a newer one, so the reader may keep references into the
+ * current read buffer until its next call of acquire().
+ * The buffers are reused, so containers keep their capacity.
+ */
+template <typename T>
+class cTripleBuffer
+{
+public:
+	/** writer side: the buffer to fill before the next publish() */
+	T& getWriteBuffer() { return buffers[backIndex]; }
+
+	/** writer side: makes the write buffer the latest published value */
+	void publish()
+	{
+		const auto previous = middle.exchange (static_cast<uint8_t> (backIndex | freshBit), std::memory_order_acq_rel);
+		backIndex = previous & indexMask;
+	}
+
+	/**
+	 * reader side: switches the read buffer to the latest published value.
+	 * Returns false, when nothing was published since the last call.
+	 */
+	bool acquire()
+	{
+		if ((middle.load (std::memory_order_relaxed) & freshBit) == 0) return false;
+
+		const auto previous = middle.exchange (frontIndex, std::memory_order_acq_rel);
+		frontIndex = previous & indexMask;
+		return true;
+	}
+
+	/**
+	 * Drops a published value, that was not picked up yet,
+	 * so that the next acquire() returns false.
+	 * Must not be called, while the writer may publish.
+	 */
+	void discard() { middle.fetch_and (indexMask, std::memory_order_acq_rel); }
+
+	/** reader side: the value picked up by the last successful acquire() */
+	const T& getReadBuffer() const { return buffers[frontIndex]; }
+
+private:
+	static constexpr uint8_t freshBit = 4;
+	static constexpr uint8_t indexMask = 3;
+
+	std::array<T, 3> buffers;
+	uint8_t backIndex = 0; // owned by the writer
+	uint8_t frontIndex = 1; // owned by the reader
+	std::atomic<uint8_t> middle = 2; // index of the buffer in between, plus freshBit when published and not yet picked up
+};
+
+#endif
@@ -14,36 +14,75 @@ const COLOR_EXPLORED := Color(0.03, 0.04, 0.08, 0.52)
 var _map_w := 0
 var _map_h := 0
 var _current_player := 0
-var _scan_data: PackedInt32Array = PackedInt32Array()
-var _explored_tiles: Dictionary = {}  # "x,y" -> true
+## Visible tiles as a bit mask from GameEngine.get_visibility_bitmask():
+## tile (x, y) is bit (x & 7) of byte y * _row_bytes + (x >> 3).
+var _visible_bits: PackedByteArray = PackedByteArray()
+var _row_bytes := 0
+## One byte per tile (row-major), 1 = tile has been visible at some point.
+var _explored: PackedByteArray = PackedByteArray()
+var _explored_by_player: Dictionary = {}  # player index -> PackedByteArray
 var fog_enabled := true
 
 
 func setup(map_w: int, map_h: int, player: int) -> void:
 	_map_w = map_w
 	_map_h = map_h
+	_row_bytes = (map_w + 7) / 8
+	_explored_by_player.clear()
+	_visible_bits = PackedByteArray()
+	set_player(player)
+
+
+func set_player(player: int) -> void:
+	## Switch the player whose view is rendered (hot seat). Each player keeps
+	## their own explored tiles.
 	_current_player = player
-	_explored_tiles.clear()
+	if not _explored_by_player.has(player):
+		var grid := PackedByteArray()
+		grid.resize(_map_w * _map_h)
+		_explored_by_player[player] = grid
+	_explored = _explored_by_player[player]
+	_visible_bits = PackedByteArray()
 	queue_redraw()
 
 
 func refresh(engine) -> void:
-	## Refresh fog data from the engine's scan map.
+	## Refresh fog data from the engine's scan map. Only the tiles inside the
+	## engine's dirty rect are re-examined for the explored state.
 	if engine == null or _map_w == 0:
 		return
 
-	var player = engine.get_player(_current_player)
-	if player == null:
+	var full := _visible_bits.is_empty()
+	var dirty: Rect2i = engine.take_fog_dirty_rect(_current_player)
+	if not full and not dirty.has_area():
 		return
 
-	_scan_data = player.get_scan_map_data()
+	# In multiplayer taken from the engine's snapshot, not from the live model
+	_visible_bits = engine.get_visibility_bitmask(_current_player)
+	if _visible_bits.size() != _row_bytes * _map_h:
+		_visible_bits = PackedByteArray()
+		return
 
-	# Mark currently visible tiles as explored
-	for y in range(_map_h):
-		for x in range(_map_w):
-			var idx := y * _map_w + x
-			if idx < _scan_data.size() and _scan_data[idx] > 0:
-				_explored_tiles["%d,%d" % [x, y]] = true
+	if full:
+		dirty = Rect2i(0, 0, _map_w, _map_h)
+	else:
+		dirty = dirty.intersection(Rect2i(0, 0, _map_w, _map_h))
+
+	# Mark currently visible tiles as explored, skipping empty bytes.
+	var first_byte := dirty.position.x >> 3
+	var last_byte := (dirty.end.x - 1) >> 3
+	for y in range(dirty.position.y, dirty.end.y):
+		var row := y * _row_bytes
+		for b in range(first_byte, last_byte + 1):
+			var byte := _visible_bits[row + b]
+			if byte == 0:
+				continue
+			for bit in range(8):
+				if byte & (1 << bit):
+					var x := (b << 3) + bit
+					if x < _map_w:
+						_explored[y * _map_w + x] = 1
+	_explored_by_player[_current_player] = _explored
 
 	queue_redraw()
 
@@ -52,17 +91,19 @@ func is_tile_visible(tile: Vector2i) -> bool:
 	## Check if a tile is currently visible (in scan range).
 	if not fog_enabled:
 		return true
-	var idx := tile.y * _map_w + tile.x
-	if idx < 0 or idx >= _scan_data.size():
+	if tile.x < 0 or tile.x >= _map_w or tile.y < 0 or tile.y >= _map_h:
+		return false
+	var idx := tile.y * _row_bytes + (tile.x >> 3)
+	if idx >= _visible_bits.size():
 		return false
-	return _scan_data[idx] > 0
+	return (_visible_bits[idx] >> (tile.x & 7)) & 1 == 1
 
 
 func is_tile_explored(tile: Vector2i) -> bool:
 	## Check if a tile has ever been visible.
 	if not fog_enabled:
 		return true
-	return _explored_tiles.has("%d,%d" % [tile.x, tile.y])
+	return _is_explored_at(tile.x, tile.y)
 
 
 func _draw() -> void:
@@ -119,4 +160,4 @@ func _draw_fog_edge_softening(tx: int, ty: int, rect: Rect2) -> void:
 func _is_explored_at(x: int, y: int) -> bool:
 	if x < 0 or x >= _map_w or y < 0 or y >= _map_h:
 		return false
-	return _explored_tiles.has("%d,%d" % [x, y])
+	return _explored[y * _map_w + x] == 1
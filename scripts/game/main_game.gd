@@ -4,6 +4,9 @@ extends Node2D
 
 const TILE_SIZE := 64
 const TICKS_PER_FRAME := 1  # How many engine ticks to process per visual frame
+const FAST_FORWARD_BUDGET_MSEC := 8.0  # Wall-clock time per frame for fast forwarded ticks
+const FAST_FORWARD_MAX_TICKS := 100000
+const RESOURCE_TYPE_NAMES := ["none", "metal", "oil", "gold"]  # Index: GameMap.get_resource_type_grid()
 
 var engine = null         # GameEngine (GDExtension)
 var actions = null        # GameActions (GDExtension)
@@ -22,6 +25,7 @@ var current_player := 0  # Which player we're controlling (local player)
 var game_running := false
 var _last_hover_tile := Vector2i(-1, -1)
 var _awaiting_attack := false  # True while an attack animation is playing
+var _fast_forwarding := false  # True while end-of-turn movements run without animation
 
 # Command target selection modes
 var _cmd_mode := ""  # "load", "repair", "reload", "steal", "disable", "activate", "transfer_target"
@@ -307,8 +311,14 @@ func _process(delta: float) -> void:
 		return
 
 	# Process engine ticks
-	for i in range(TICKS_PER_FRAME):
-		engine.advance_tick()
+	if _fast_forwarding:
+		var ff: Dictionary = engine.fast_forward(FAST_FORWARD_MAX_TICKS, FAST_FORWARD_BUDGET_MSEC, true, current_player)
+		if ff.get("stop_reason", "") != "budget":
+			# Turn is active again, or an attack / a newly seen unit should be watched
+			_fast_forwarding = false
+	else:
+		for i in range(TICKS_PER_FRAME):
+			engine.advance_tick()
 
 	# Update hover tile
 	var mouse_world = get_global_mouse_position()
@@ -335,10 +345,9 @@ func _process(delta: float) -> void:
 		elif selected_unit_id != -1:
 			_update_hover_preview(hover_tile)
 
-	# Periodically refresh unit positions (in case of movement)
-	if Engine.get_process_frames() % 10 == 0:
-		unit_renderer.refresh_units()
-		unit_renderer.selected_unit_id = selected_unit_id
+	# Apply unit changes (movement, damage, state) reported by the engine
+	unit_renderer.refresh_changed_units()
+	unit_renderer.selected_unit_id = selected_unit_id
 
 
 func _update_hover_preview(hover_tile: Vector2i) -> void:
@@ -1160,8 +1169,8 @@ func _on_end_turn_pressed() -> void:
 		var next_player := current_player + 1
 		if next_player >= _hotseat_player_count:
 			# All players have finished -- end turn for real, advance game turn
-			# Process the turn
-			engine.advance_ticks(10)
+			# Process the turn; nobody watches behind the transition screen
+			engine.fast_forward(FAST_FORWARD_MAX_TICKS, 250.0, false)
 			# Next turn starts with player 0
 			next_player = 0
 		# Show transition screen
@@ -1172,6 +1181,7 @@ func _on_end_turn_pressed() -> void:
 			for i in range(engine.get_player_count()):
 				if i != current_player:
 					engine.end_player_turn(i)
+			_fast_forwarding = true
 		_update_hud()
 
 
@@ -1486,7 +1496,7 @@ func _on_hotseat_ready_pressed() -> void:
 
 	# Refresh everything for the new player
 	if fog:
-		fog.current_player = current_player
+		fog.set_player(current_player)
 		fog.refresh(engine)
 	_refresh_fog()
 	unit_renderer.current_player = current_player
@@ -2096,19 +2106,21 @@ func _refresh_resource_overlay() -> void:
 	if not player or not game_map:
 		return
 	var map_size: Vector2i = game_map.get_size()
+	var res_types: PackedByteArray = game_map.get_resource_type_grid()
+	var res_values: PackedByteArray = game_map.get_resource_value_grid()
 	var resource_tiles: Array = []
 	for y in range(map_size.y):
 		for x in range(map_size.x):
+			var idx := y * map_size.x + x
+			if res_types[idx] == 0 or res_values[idx] == 0:
+				continue
 			var pos := Vector2i(x, y)
 			if player.has_resource_explored(pos):
-				var res: Dictionary = game_map.get_resource_at(pos)
-				var res_type: String = res.get("type", "none")
-				if res_type != "none" and res.get("value", 0) > 0:
-					resource_tiles.append({
-						"pos": pos,
-						"type": res_type,
-						"value": res.get("value", 0)
-					})
+				resource_tiles.append({
+					"pos": pos,
+					"type": RESOURCE_TYPE_NAMES[res_types[idx]],
+					"value": res_values[idx]
+				})
 	overlay.set_resource_overlay(resource_tiles)
 
 
@@ -3065,6 +3077,8 @@ func _check_resource_discoveries() -> void:
 	if not player or not game_map:
 		return
 	var map_size: Vector2i = game_map.get_size()
+	var res_types: PackedByteArray = game_map.get_resource_type_grid()
+	var res_values: PackedByteArray = game_map.get_resource_value_grid()
 	var count := 0
 	var latest_resource: Dictionary = {}
 	for y in range(map_size.y):
@@ -3072,9 +3086,9 @@ func _check_resource_discoveries() -> void:
 			var pos := Vector2i(x, y)
 			if player.has_resource_explored(pos):
 				count += 1
-				var res: Dictionary = game_map.get_resource_at(pos)
-				if res.get("type", "none") != "none" and res.get("value", 0) > 0:
-					latest_resource = {"type": res.get("type"), "value": res.get("value"), "pos": pos}
+				var idx := y * map_size.x + x
+				if res_types[idx] != 0 and res_values[idx] > 0:
+					latest_resource = {"type": RESOURCE_TYPE_NAMES[res_types[idx]], "value": res_values[idx], "pos": pos}
 
 	if count > _surveyed_tile_count and _surveyed_tile_count > 0 and not latest_resource.is_empty():
 		hud.show_resource_discovery(
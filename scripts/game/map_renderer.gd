@@ -65,41 +65,11 @@ func setup(game_map) -> void:
 
 func _build_terrain_cache() -> void:
 	## Pre-compute terrain types and neighbor data for all tiles.
-	_terrain_cache.resize(_map_w * _map_h)
-	_neighbor_cache.resize(_map_w * _map_h)
-
-	for y in range(_map_h):
-		for x in range(_map_w):
-			var pos := Vector2i(x, y)
-			var idx := y * _map_w + x
-			# Terrain type: 0=ground, 1=water, 2=coast, 3=blocked
-			if _map.is_water(pos):
-				_terrain_cache[idx] = 1
-			elif _map.is_coast(pos):
-				_terrain_cache[idx] = 2
-			elif _map.is_blocked(pos):
-				_terrain_cache[idx] = 3
-			else:
-				_terrain_cache[idx] = 0
-
-			# Neighbor flags: bits for adjacent water tiles (for coastal transitions)
-			# Bit layout: N=1, NE=2, E=4, SE=8, S=16, SW=32, W=64, NW=128
-			var flags := 0
-			if _is_water_at(x, y - 1): flags |= 1
-			if _is_water_at(x + 1, y - 1): flags |= 2
-			if _is_water_at(x + 1, y): flags |= 4
-			if _is_water_at(x + 1, y + 1): flags |= 8
-			if _is_water_at(x, y + 1): flags |= 16
-			if _is_water_at(x - 1, y + 1): flags |= 32
-			if _is_water_at(x - 1, y): flags |= 64
-			if _is_water_at(x - 1, y - 1): flags |= 128
-			_neighbor_cache[idx] = flags
-
-
-func _is_water_at(x: int, y: int) -> bool:
-	if x < 0 or x >= _map_w or y < 0 or y >= _map_h:
-		return false
-	return _map.is_water(Vector2i(x, y))
+	# Terrain type: 0=ground, 1=water, 2=coast, 3=blocked
+	_terrain_cache = _map.get_terrain_grid()
+	# Neighbor flags: bits for adjacent water tiles (for coastal transitions)
+	# Bit layout: N=1, NE=2, E=4, SE=8, S=16, SW=32, W=64, NW=128
+	_neighbor_cache = _map.get_coast_neighbor_grid()
 
 
 func set_hover_tile(tile: Vector2i) -> void:
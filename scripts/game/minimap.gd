@@ -17,6 +17,9 @@ const BG_COLOR := Color(0.06, 0.08, 0.12, 0.9)
 const VIEWPORT_COLOR := Color(1.0, 1.0, 1.0, 0.6)
 const UNIT_DOT_SIZE := 2.5
 const BUILDING_DOT_SIZE := 3.0
+# unit_flags of GameEngine.get_visible_units()
+const UNIT_BUILDING := 1
+const UNIT_ARMED := 4096
 const UNIT_COLORS := [
 	Color(0.3, 0.6, 1.0),   # Blue
 	Color(1.0, 0.3, 0.25),  # Red
@@ -170,45 +173,34 @@ func _draw_fog(offset: Vector2) -> void:
 
 func _draw_units(offset: Vector2) -> void:
 	## Draw unit dots on the minimap.
-	var player_count: int = _engine.get_player_count()
+	# Enemy units hidden by fog are left out by the engine
+	var viewer: int = -1
+	if _fog_renderer and _fog_renderer.fog_enabled:
+		viewer = _current_player
+	var units: Dictionary = _engine.get_visible_units(viewer)
+	var ids: PackedInt32Array = units.get("unit_ids", PackedInt32Array())
+	if ids.is_empty():
+		return
+	var players: PackedInt32Array = units["unit_players"]
+	var flags: PackedInt32Array = units["unit_flags"]
+	var positions: PackedInt32Array = units["unit_positions"]
+
+	for i in range(ids.size()):
+		var pi: int = players[i]
+		if pi < 0:
+			continue  # Neutral units (rubble) are not shown
+		# Phase 25: Attack filter
+		if _attack_units_only and (flags[i] & UNIT_ARMED) == 0:
+			continue
 
-	for pi in range(player_count):
 		var color: Color = UNIT_COLORS[pi % UNIT_COLORS.size()]
-
-		# Vehicles
-		var vehicles = _engine.get_player_vehicles(pi)
-		for v in vehicles:
-			# Phase 25: Attack filter
-			if _attack_units_only and not v.has_weapon():
-				continue
-
-			var pos: Vector2i = v.get_position()
-			# Skip if hidden by fog (enemy units)
-			if pi != _current_player and _fog_renderer:
-				if _fog_renderer.fog_enabled and not _fog_renderer.is_tile_visible(pos):
-					continue
-
-			var dot := UNIT_DOT_SIZE * _zoom_level
-			var minimap_pos := offset + Vector2(pos.x * _scale_x, pos.y * _scale_y)
-			draw_rect(Rect2(minimap_pos - Vector2(dot / 2.0, dot / 2.0),
-				Vector2(dot, dot)), color)
-
-		# Buildings
-		var buildings = _engine.get_player_buildings(pi)
-		for b in buildings:
-			# Phase 25: Attack filter — only show buildings with weapons
-			if _attack_units_only and not b.has_weapon():
-				continue
-
-			var pos: Vector2i = b.get_position()
-			if pi != _current_player and _fog_renderer:
-				if _fog_renderer.fog_enabled and not _fog_renderer.is_tile_visible(pos):
-					continue
-
-			var dot := BUILDING_DOT_SIZE * _zoom_level
-			var minimap_pos := offset + Vector2(pos.x * _scale_x, pos.y * _scale_y)
-			draw_rect(Rect2(minimap_pos - Vector2(dot / 2.0, dot / 2.0),
-				Vector2(dot, dot)), color.lightened(0.2))
+		var dot := UNIT_DOT_SIZE * _zoom_level
+		if flags[i] & UNIT_BUILDING:
+			dot = BUILDING_DOT_SIZE * _zoom_level
+			color = color.lightened(0.2)
+		var minimap_pos := offset + Vector2(positions[2 * i] * _scale_x, positions[2 * i + 1] * _scale_y)
+		draw_rect(Rect2(minimap_pos - Vector2(dot / 2.0, dot / 2.0),
+			Vector2(dot, dot)), color)
 
 
 func _draw_camera_viewport(offset: Vector2) -> void:
@@ -21,6 +21,25 @@ const SELECTION_PULSE_SPEED := 3.0
 const ANIM_FPS := 8.0  # Animation frames per second for infantry/commando
 const DAMAGE_THRESHOLD := 0.4  # Show damage effect below this HP ratio
 
+# Change flags of GameEngine.drain_unit_changes()
+const UNIT_ADDED := 1
+const UNIT_REMOVED := 2
+
+# unit_flags of GameEngine.get_presentation_snapshot() and get_visible_units()
+const SNAP_BUILDING := 1
+const SNAP_BIG := 2
+const SNAP_WORKING := 4
+const SNAP_BUILDING_A_BUILDING := 8
+const SNAP_SENTRY := 16
+const SNAP_MANUAL_FIRE := 32
+const SNAP_DISABLED := 64
+const SNAP_RUBBLE := 128
+const SNAP_PLANE := 256
+const SNAP_STEALTH := 512
+const SNAP_CONNECTS_TO_BASE := 1024
+const SNAP_MINE := 2048
+const SNAP_ARMED := 4096
+
 # Player colors (indexed by player number)
 const PLAYER_COLORS := [
 	Color(0.20, 0.45, 1.00),  # Blue
@@ -42,6 +61,8 @@ var selected_unit_id := -1
 
 # Cached unit data for rendering
 var _unit_data: Array = []       # Array of dictionaries with render info
+var _units_by_id: Dictionary = {}  # unit_id -> entry of _unit_data
+var _snapshot_pending: Dictionary = {}  # unit_id -> snapshot version when the change was drained (multiplayer)
 var _unit_positions: Dictionary = {}  # tile_key -> unit_id (for click detection)
 var _unit_directions: Dictionary = {} # unit_id -> last known direction (0-7)
 var _anim_time := 0.0            # For animated units and selection pulse
@@ -61,121 +82,249 @@ func setup(eng) -> void:
 
 
 func refresh_units() -> void:
+	## Rebuild the render cache from scratch by polling every player's units.
 	if engine == null:
 		return
 
 	_unit_data.clear()
 	_unit_positions.clear()
+	_units_by_id.clear()
+	_snapshot_pending.clear()
+
+	if engine.is_multiplayer():
+		# The model runs on the server thread; read the state it published
+		var snap: Dictionary = engine.get_presentation_snapshot()
+		var snap_ids: PackedInt32Array = snap.get("unit_ids", PackedInt32Array())
+		for i in range(snap_ids.size()):
+			if snap["unit_players"][i] >= 0:
+				_add_unit_entry(_make_snapshot_entry(snap, i))
+		_unit_data = _units_by_id.values()
+		queue_redraw()
+		return
+
+	# One native call returns the packed state of all units
+	var units: Dictionary = engine.get_visible_units(-1)
+	var unit_ids: PackedInt32Array = units.get("unit_ids", PackedInt32Array())
+	for i in range(unit_ids.size()):
+		if units["unit_players"][i] >= 0:
+			_add_unit_entry(_make_snapshot_entry(units, i))
+
+	_unit_data = _units_by_id.values()
+	queue_redraw()
+
+
+func refresh_changed_units() -> void:
+	## Update only the units reported by the engine's change journal since the
+	## last call. Much cheaper than refresh_units() when little has changed.
+	if engine == null:
+		return
+
+	var changes: Dictionary = engine.drain_unit_changes()
+	var ids: PackedInt32Array = changes.get("ids", PackedInt32Array())
+	if engine.is_multiplayer():
+		_refresh_changed_units_from_snapshot(ids)
+		return
+	if ids.is_empty():
+		return
+	var flags: PackedInt32Array = changes["changes"]
+	var players: PackedInt32Array = changes["players"]
+
+	for i in range(ids.size()):
+		var uid: int = ids[i]
+		var old = _units_by_id.get(uid)
+		if old != null:
+			_remove_unit_entry(old)
+		if (flags[i] & UNIT_REMOVED) and not (flags[i] & UNIT_ADDED):
+			continue
+		var pi: int = players[i]
+		if pi < 0:
+			continue  # Neutral units are not rendered here
+		var u = engine.get_unit_by_id(pi, uid)
+		if u.is_vehicle():
+			_add_unit_entry(_make_vehicle_entry(u, pi))
+		elif u.is_building():
+			_add_unit_entry(_make_building_entry(u, pi))
+
+	_unit_data = _units_by_id.values()
+	queue_redraw()
 
-	var player_count: int = engine.get_player_count()
-
-	for pi in range(player_count):
-		var player_color: Color = PLAYER_COLORS[pi % PLAYER_COLORS.size()]
-
-		# Vehicles
-		var vehicles = engine.get_player_vehicles(pi)
-		for v in vehicles:
-			var uid: int = v.get_id()
-			var pos: Vector2i = v.get_position()
-			var type_name: String = v.get_type_name()
-			var hp: int = v.get_hitpoints()
-			var hp_max: int = v.get_hitpoints_max()
-
-			# Check animation info (cached per type)
-			if not _anim_unit_types.has(type_name) and sprite_cache:
-				var has_anim: bool = sprite_cache.has_animation_frames(type_name)
-				var frame_count: int = sprite_cache.get_animation_frame_count(type_name) if has_anim else 0
-				_anim_unit_types[type_name] = {"has_anim": has_anim, "frame_count": frame_count}
-
-			var v_is_big: bool = v.is_big()
-
-			_unit_data.append({
-				"id": uid,
-				"pos": pos,
-				"type_name": type_name,
-				"player": pi,
-				"color": player_color,
-				"hp": hp,
-				"hp_max": hp_max,
-				"is_building": false,
-				"is_big": v_is_big,
-				"is_working": false,
-				"is_constructing": v.is_building_a_building(),
-				"build_progress": 0.0,
-				# Phase 19: State indicators
-				"is_sentry": v.is_sentry_active(),
-				"is_manual_fire": v.is_manual_fire(),
-				"is_disabled": v.is_disabled(),
-				"stored_units": v.get_stored_units_count(),
-				# Phase 31: Advanced unit features
-				"is_plane": v.is_plane() if v.has_method("is_plane") else false,
-				"flight_height": v.get_flight_height() if v.has_method("get_flight_height") else 0,
-				"is_stealth": v.is_stealth() if v.has_method("is_stealth") else false,
-			})
-
-			var key := "%d,%d" % [pos.x, pos.y]
-			_unit_positions[key] = uid
-			# Phase 20: Big vehicles occupy 2x2 tiles
-			if v_is_big:
-				_unit_positions["%d,%d" % [pos.x + 1, pos.y]] = uid
-				_unit_positions["%d,%d" % [pos.x, pos.y + 1]] = uid
-				_unit_positions["%d,%d" % [pos.x + 1, pos.y + 1]] = uid
-
-		# Buildings
-		var buildings = engine.get_player_buildings(pi)
-		for b in buildings:
-			var uid: int = b.get_id()
-			var pos: Vector2i = b.get_position()
-			var type_name: String = b.get_type_name()
-			var hp: int = b.get_hitpoints()
-			var hp_max: int = b.get_hitpoints_max()
-			var is_big: bool = b.get_is_big() if b.has_method("get_is_big") else false
-			var is_working: bool = b.is_working()
-
-			# Build progress
-			var build_progress := 1.0
-			if b.has_method("get_build_costs_remaining") and b.has_method("get_build_cost"):
-				var remaining: int = b.get_build_costs_remaining()
-				var total: int = b.get_build_cost()
-				if total > 0:
-					build_progress = 1.0 - (float(remaining) / float(total))
-
-			_unit_data.append({
-				"id": uid,
-				"pos": pos,
-				"type_name": type_name,
-				"player": pi,
-				"color": player_color,
-				"hp": hp,
-				"hp_max": hp_max,
-				"is_building": true,
-				"is_big": is_big,
-				"is_working": is_working,
-				"is_constructing": false,
-				"build_progress": build_progress,
-				# Phase 19: State indicators
-				"is_sentry": b.is_sentry_active(),
-				"is_manual_fire": b.is_manual_fire(),
-				"is_disabled": b.is_disabled(),
-				"stored_units": b.get_stored_units_count(),
-				# Phase 26: Connector flags
-				"connects_to_base": b.connects_to_base() if b.has_method("connects_to_base") else false,
-				# Phase 31: Advanced unit features
-				"is_rubble": b.is_rubble() if b.has_method("is_rubble") else false,
-				"is_mine": b.is_mine_building() if b.has_method("is_mine_building") else false,
-			})
-
-			# Register tile occupancy (big buildings span 2x2)
-			var tile_key := "%d,%d" % [pos.x, pos.y]
-			_unit_positions[tile_key] = uid
-			if is_big:
-				_unit_positions["%d,%d" % [pos.x + 1, pos.y]] = uid
-				_unit_positions["%d,%d" % [pos.x, pos.y + 1]] = uid
-				_unit_positions["%d,%d" % [pos.x + 1, pos.y + 1]] = uid
 
+func _refresh_changed_units_from_snapshot(ids: PackedInt32Array) -> void:
+	## Multiplayer variant: the model runs on the server thread, so the unit
+	## state is taken from the snapshot it publishes after each tick. A change
+	## may be journaled during a tick whose snapshot is not published yet, so
+	## changed units are re-read until a newer snapshot arrived.
+	if ids.is_empty() and _snapshot_pending.is_empty():
+		return
+	var snap: Dictionary = engine.get_presentation_snapshot()
+	if snap.is_empty():
+		for uid in ids:
+			_snapshot_pending[uid] = -1
+		return
+	var version: int = snap["version"]
+	for uid in ids:
+		_snapshot_pending[uid] = version
+
+	var snap_index := {}
+	var snap_ids: PackedInt32Array = snap["unit_ids"]
+	for i in range(snap_ids.size()):
+		snap_index[snap_ids[i]] = i
+
+	for uid in _snapshot_pending.keys():
+		var old = _units_by_id.get(uid)
+		if old != null:
+			_remove_unit_entry(old)
+		var i: int = snap_index.get(uid, -1)
+		if i >= 0 and snap["unit_players"][i] >= 0:
+			_add_unit_entry(_make_snapshot_entry(snap, i))
+		if _snapshot_pending[uid] < version:
+			_snapshot_pending.erase(uid)
+
+	_unit_data = _units_by_id.values()
 	queue_redraw()
 
 
+func _make_snapshot_entry(snap: Dictionary, i: int) -> Dictionary:
+	## Entry from the arrays of GameEngine.get_presentation_snapshot() or
+	## GameEngine.get_visible_units(). The latter names each type only once.
+	var flags: int = snap["unit_flags"][i]
+	var pi: int = snap["unit_players"][i]
+	var type_name: String
+	if snap.has("unit_types"):
+		type_name = snap["type_names"][snap["unit_types"][i]]
+	else:
+		type_name = snap["unit_type_names"][i]
+	var is_building := (flags & SNAP_BUILDING) != 0
+	if not is_building and not _anim_unit_types.has(type_name) and sprite_cache:
+		var has_anim: bool = sprite_cache.has_animation_frames(type_name)
+		var frame_count: int = sprite_cache.get_animation_frame_count(type_name) if has_anim else 0
+		_anim_unit_types[type_name] = {"has_anim": has_anim, "frame_count": frame_count}
+
+	var positions: PackedInt32Array = snap["unit_positions"]
+	var build_progress := 1.0 if is_building else 0.0
+	if snap.has("build_progress"):
+		build_progress = snap["build_progress"][i] / 100.0
+	return {
+		"id": snap["unit_ids"][i],
+		"pos": Vector2i(positions[2 * i], positions[2 * i + 1]),
+		"type_name": type_name,
+		"player": pi,
+		"color": PLAYER_COLORS[pi % PLAYER_COLORS.size()],
+		"hp": snap["hitpoints"][i],
+		"hp_max": snap["hitpoints_max"][i],
+		"is_building": is_building,
+		"is_big": (flags & SNAP_BIG) != 0,
+		"is_working": is_building and (flags & SNAP_WORKING) != 0,
+		"is_constructing": (flags & SNAP_BUILDING_A_BUILDING) != 0,
+		"build_progress": build_progress,
+		"is_sentry": (flags & SNAP_SENTRY) != 0,
+		"is_manual_fire": (flags & SNAP_MANUAL_FIRE) != 0,
+		"is_disabled": (flags & SNAP_DISABLED) != 0,
+		"stored_units": snap["stored_units"][i],
+		"is_plane": (flags & SNAP_PLANE) != 0,
+		"flight_height": snap["flight_heights"][i],
+		"is_stealth": (flags & SNAP_STEALTH) != 0,
+		"connects_to_base": (flags & SNAP_CONNECTS_TO_BASE) != 0,
+		"is_rubble": (flags & SNAP_RUBBLE) != 0,
+		"is_mine": (flags & SNAP_MINE) != 0,
+	}
+
+
+func _make_vehicle_entry(v, pi: int) -> Dictionary:
+	var type_name: String = v.get_type_name()
+
+	# Check animation info (cached per type)
+	if not _anim_unit_types.has(type_name) and sprite_cache:
+		var has_anim: bool = sprite_cache.has_animation_frames(type_name)
+		var frame_count: int = sprite_cache.get_animation_frame_count(type_name) if has_anim else 0
+		_anim_unit_types[type_name] = {"has_anim": has_anim, "frame_count": frame_count}
+
+	return {
+		"id": v.get_id(),
+		"pos": v.get_position(),
+		"type_name": type_name,
+		"player": pi,
+		"color": PLAYER_COLORS[pi % PLAYER_COLORS.size()],
+		"hp": v.get_hitpoints(),
+		"hp_max": v.get_hitpoints_max(),
+		"is_building": false,
+		"is_big": v.is_big(),
+		"is_working": false,
+		"is_constructing": v.is_building_a_building(),
+		"build_progress": 0.0,
+		# Phase 19: State indicators
+		"is_sentry": v.is_sentry_active(),
+		"is_manual_fire": v.is_manual_fire(),
+		"is_disabled": v.is_disabled(),
+		"stored_units": v.get_stored_units_count(),
+		# Phase 31: Advanced unit features
+		"is_plane": v.is_plane() if v.has_method("is_plane") else false,
+		"flight_height": v.get_flight_height() if v.has_method("get_flight_height") else 0,
+		"is_stealth": v.is_stealth() if v.has_method("is_stealth") else false,
+	}
+
+
+func _make_building_entry(b, pi: int) -> Dictionary:
+	# Build progress
+	var build_progress := 1.0
+	if b.has_method("get_build_costs_remaining") and b.has_method("get_build_cost"):
+		var remaining: int = b.get_build_costs_remaining()
+		var total: int = b.get_build_cost()
+		if total > 0:
+			build_progress = 1.0 - (float(remaining) / float(total))
+
+	return {
+		"id": b.get_id(),
+		"pos": b.get_position(),
+		"type_name": b.get_type_name(),
+		"player": pi,
+		"color": PLAYER_COLORS[pi % PLAYER_COLORS.size()],
+		"hp": b.get_hitpoints(),
+		"hp_max": b.get_hitpoints_max(),
+		"is_building": true,
+		"is_big": b.get_is_big() if b.has_method("get_is_big") else false,
+		"is_working": b.is_working(),
+		"is_constructing": false,
+		"build_progress": build_progress,
+		# Phase 19: State indicators
+		"is_sentry": b.is_sentry_active(),
+		"is_manual_fire": b.is_manual_fire(),
+		"is_disabled": b.is_disabled(),
+		"stored_units": b.get_stored_units_count(),
+		# Phase 26: Connector flags
+		"connects_to_base": b.connects_to_base() if b.has_method("connects_to_base") else false,
+		# Phase 31: Advanced unit features
+		"is_rubble": b.is_rubble() if b.has_method("is_rubble") else false,
+		"is_mine": b.is_mine_building() if b.has_method("is_mine_building") else false,
+	}
+
+
+func _unit_tile_keys(unit: Dictionary) -> Array:
+	# Big units occupy 2x2 tiles
+	var pos: Vector2i = unit["pos"]
+	if not unit["is_big"]:
+		return ["%d,%d" % [pos.x, pos.y]]
+	return [
+		"%d,%d" % [pos.x, pos.y],
+		"%d,%d" % [pos.x + 1, pos.y],
+		"%d,%d" % [pos.x, pos.y + 1],
+		"%d,%d" % [pos.x + 1, pos.y + 1],
+	]
+
+
+func _add_unit_entry(unit: Dictionary) -> void:
+	_units_by_id[unit["id"]] = unit
+	for key in _unit_tile_keys(unit):
+		_unit_positions[key] = unit["id"]
+
+
+func _remove_unit_entry(unit: Dictionary) -> void:
+	_units_by_id.erase(unit["id"])
+	for key in _unit_tile_keys(unit):
+		if _unit_positions.get(key, -1) == unit["id"]:
+			_unit_positions.erase(key)
+
+
 func get_unit_at_tile(tile: Vector2i) -> int:
 	var key := "%d,%d" % [tile.x, tile.y]
 	return _unit_positions.get(key, -1)
@@ -101,23 +101,21 @@ func _generate_map_preview() -> void:
 
 	var img := Image.create(_map_width, _map_height, false, Image.FORMAT_RGB8)
 
-	# Draw terrain based on the map tile types (returns String: "water", "coast", "ground", "blocked")
+	# Draw terrain based on the map tile types (0=ground, 1=water, 2=coast, 3=blocked)
+	var terrain: PackedByteArray = game_map.get_terrain_grid()
+	if terrain.size() != _map_width * _map_height:
+		return
 	for y in range(_map_height):
 		for x in range(_map_width):
-			var tile_type: String = game_map.get_terrain_type(Vector2i(x, y))
 			var color := Color(0.2, 0.5, 0.2)  # Default: green (land)
 
-			match tile_type:
-				"water":
+			match terrain[y * _map_width + x]:
+				1:
 					color = Color(0.1, 0.2, 0.5)
-				"coast":
+				2:
 					color = Color(0.6, 0.6, 0.3)
-				"ground":
-					color = Color(0.2, 0.5, 0.2)
-				"blocked":
+				3:
 					color = Color(0.4, 0.35, 0.25)
-				_:
-					color = Color(0.3, 0.5, 0.3)
 
 			img.set_pixel(x, y, color)
 